@@ -0,0 +1,110 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <bit>
+#include <limits>
+#include <type_traits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+
+namespace num {
+	/* convert the vector [v] to another floating point type */
+	template <std::floating_point To, std::floating_point From>
+	constexpr num::Vec<To> Convert(const num::Vec<From>& v) {
+		return num::Vec<To>{ To(v.x), To(v.y), To(v.z) };
+	}
+
+	/* convert the line [l] to another floating point type */
+	template <std::floating_point To, std::floating_point From>
+	constexpr num::Line<To> Convert(const num::Line<From>& l) {
+		return num::Line<To>{ num::Convert<To>(l.o), num::Convert<To>(l.d) };
+	}
+
+	/* convert the plane [p] to another floating point type */
+	template <std::floating_point To, std::floating_point From>
+	constexpr num::Plane<To> Convert(const num::Plane<From>& p) {
+		return num::Plane<To>{ num::Convert<To>(p.o), num::Convert<To>(p.a), num::Convert<To>(p.b) };
+	}
+
+	/* compute the distance between [a] and [b] in units of least precision (nan yields the maximum distance) */
+	template <std::floating_point Type>
+	constexpr uint64_t Ulps(Type a, Type b) {
+		static_assert(sizeof(Type) == sizeof(uint32_t) || sizeof(Type) == sizeof(uint64_t), "only float and double are supported");
+		using Bits = std::conditional_t<sizeof(Type) == sizeof(uint32_t), uint32_t, uint64_t>;
+		constexpr Bits Sign = Bits(1) << (sizeof(Bits) * 8 - 1);
+		if (a != a || b != b)
+			return std::numeric_limits<uint64_t>::max();
+
+		/* map the representations onto a monotonic unsigned scale (negative values are mirrored below the sign bit) */
+		Bits _a = std::bit_cast<Bits>(a), _b = std::bit_cast<Bits>(b);
+		_a = ((_a & Sign) ? Sign - (_a & ~Sign) : Sign + _a);
+		_b = ((_b & Sign) ? Sign - (_b & ~Sign) : Sign + _b);
+		return uint64_t(_a > _b ? _a - _b : _b - _a);
+	}
+
+	/*
+	*	Accumulator of the deviation of computed values from their reference values
+	*	- the reference is expected to be computed with higher precision (e.g. double or long double for float)
+	*	- the relative error falls back to the absolute error for references of a magnitude below one, and the units of least
+	*		precision are accordingly counted at the magnitude one for these references (as the units shrink towards zero)
+	*/
+	template <std::floating_point Type>
+	struct Drift {
+	public:
+		uint64_t maxUlps = 0;
+		Type maxError = 0;
+		size_t samples = 0;
+
+	public:
+		constexpr Drift() = default;
+
+	public:
+		/* record the deviation of [value] from [reference] */
+		template <std::floating_point Ref>
+		constexpr void add(Type value, Ref reference) {
+			++samples;
+			const Ref offset = (num::Abs(reference) < 1 ? Ref(1) - reference : Ref(0));
+			maxUlps = std::max(maxUlps, num::Ulps(Type(Ref(value) + offset), Type(reference + offset)));
+			const Ref error = num::Abs(Ref(value) - reference) / std::max<Ref>(num::Abs(reference), 1);
+			maxError = (error != error ? std::numeric_limits<Type>::infinity() : std::max(maxError, Type(error)));
+		}
+
+		/* record the deviation of all components of [value] from [reference] */
+		template <std::floating_point Ref>
+		constexpr void add(const num::Vec<Type>& value, const num::Vec<Ref>& reference) {
+			for (size_t i = 0; i < 3; ++i)
+				add(value[i], reference[i]);
+		}
+
+		/* record the deviation of all components of [value] from [reference] */
+		template <std::floating_point Ref>
+		constexpr void add(const num::Line<Type>& value, const num::Line<Ref>& reference) {
+			add(value.o, reference.o);
+			add(value.d, reference.d);
+		}
+
+		/* record the deviation of all components of [value] from [reference] */
+		template <std::floating_point Ref>
+		constexpr void add(const num::Plane<Type>& value, const num::Plane<Ref>& reference) {
+			add(value.o, reference.o);
+			add(value.a, reference.a);
+			add(value.b, reference.b);
+		}
+
+		/* combine the deviations recorded by [d] into [this] */
+		constexpr void merge(const num::Drift<Type>& d) {
+			maxUlps = std::max(maxUlps, d.maxUlps);
+			maxError = std::max(maxError, d.maxError);
+			samples += d.samples;
+		}
+
+		/* check if the deviation exceeds the [baseline] by more than the factor [tolerance] */
+		constexpr bool regressed(const num::Drift<Type>& baseline, Type tolerance = 1) const {
+			return (maxError > baseline.maxError * tolerance) || (Type(maxUlps) > Type(baseline.maxUlps) * tolerance);
+		}
+	};
+}
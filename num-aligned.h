@@ -0,0 +1,304 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+
+/*
+*	Padded and aligned alternative layout of num::Vec, num::Line, and num::Plane
+*	- num::AlignedVec stores the components in four lanes [x, y, z, w] aligned to their total size, such that every
+*		vector occupies exactly one SIMD register (16 bytes for float, 32 bytes for double) and never straddles cache lines
+*	- the element-wise operations are written over all four lanes, which allows the compiler to map them to a single
+*		load, operation and store (and the cross product to shuffles), instead of partial loads of three components
+*	- the padding lane [w] carries no meaning: it is zero when constructed from three components, but is computed
+*		alongside the other lanes and ignored by all scalar results and comparisons
+*	- all results are bit-identical to the corresponding num::Vec, num::Line, and num::Plane operations, as long as the
+*		translation unit does not contract them to fused multiply-adds (e.g. -march=haswell without -ffp-contract=off)
+*	- num::AlignedPlane covers normal, point, closest, intersect, inTriangle, touch, and linear, all other operations
+*		are reached through the packed layout by num::AlignedPlane::plane
+*	- the padding increases the memory traffic by a third, thereby the aligned layout is not faster for every bulk
+*		workload (measured by tests/aligned.cpp)
+*/
+namespace num {
+	template <std::floating_point Type>
+	struct alignas(4 * sizeof(Type)) AlignedVec {
+	public:
+		union {
+			struct {
+				Type x;
+				Type y;
+				Type z;
+				Type w;
+			};
+			Type c[4];
+		};
+
+	public:
+		constexpr AlignedVec() : x{ 0 }, y{ 0 }, z{ 0 }, w{ 0 } {}
+		constexpr AlignedVec(Type f) : x{ f }, y{ f }, z{ f }, w{ 0 } {}
+		constexpr AlignedVec(Type x, Type y, Type z) : x{ x }, y{ y }, z{ z }, w{ 0 } {}
+		constexpr AlignedVec(const num::Vec<Type>& v) : x{ v.x }, y{ v.y }, z{ v.z }, w{ 0 } {}
+
+	private:
+		constexpr AlignedVec(Type x, Type y, Type z, Type w) : x{ x }, y{ y }, z{ z }, w{ w } {}
+
+	public:
+		/* access the component [i] (unlike the union member [c], this can be evaluated at compile time) */
+		constexpr Type& operator[](size_t i) {
+			if (std::is_constant_evaluated())
+				return (i == 0 ? x : (i == 1 ? y : (i == 2 ? z : w)));
+			return c[i];
+		}
+		constexpr const Type& operator[](size_t i) const {
+			if (std::is_constant_evaluated())
+				return (i == 0 ? x : (i == 1 ? y : (i == 2 ? z : w)));
+			return c[i];
+		}
+
+	public:
+		constexpr num::AlignedVec<Type> operator+(const num::AlignedVec<Type>& v) const {
+			return num::AlignedVec<Type>{ x + v.x, y + v.y, z + v.z, w + v.w };
+		}
+		constexpr num::AlignedVec<Type> operator-(const num::AlignedVec<Type>& v) const {
+			return num::AlignedVec<Type>{ x - v.x, y - v.y, z - v.z, w - v.w };
+		}
+		constexpr num::AlignedVec<Type> operator-() const {
+			return num::AlignedVec<Type>{ -x, -y, -z, -w };
+		}
+		constexpr num::AlignedVec<Type> operator*(Type s) const {
+			return num::AlignedVec<Type>{ x * s, y * s, z * s, w * s };
+		}
+		constexpr num::AlignedVec<Type> operator/(Type s) const {
+			return num::AlignedVec<Type>{ x / s, y / s, z / s, w / s };
+		}
+		constexpr num::AlignedVec<Type>& operator+=(const num::AlignedVec<Type>& v) {
+			return (*this = *this + v);
+		}
+		constexpr num::AlignedVec<Type>& operator-=(const num::AlignedVec<Type>& v) {
+			return (*this = *this - v);
+		}
+		constexpr num::AlignedVec<Type>& operator*=(Type s) {
+			return (*this = *this * s);
+		}
+		constexpr num::AlignedVec<Type>& operator/=(Type s) {
+			return (*this = *this / s);
+		}
+		constexpr bool operator==(const num::AlignedVec<Type>& v) const {
+			return identical(v);
+		}
+		constexpr bool operator!=(const num::AlignedVec<Type>& v) const {
+			return !(*this == v);
+		}
+
+	public:
+		/* convert the vector to the packed layout */
+		constexpr num::Vec<Type> vec() const {
+			return num::Vec<Type>{ x, y, z };
+		}
+
+		/* compute the dot product [this] * [v] */
+		constexpr Type dot(const num::AlignedVec<Type>& v) const {
+			return v.x * x + v.y * y + v.z * z;
+		}
+
+		/* compute the squared length of the vector */
+		constexpr Type lenSquared() const {
+			return dot(*this);
+		}
+
+		/* compute the length of the vector */
+		constexpr Type len() const {
+			return num::Sqrt(lenSquared());
+		}
+
+		/* compute the the cross product [this] x [v] (lane-wise products of the rotated lanes) */
+		constexpr num::AlignedVec<Type> cross(const num::AlignedVec<Type>& v) const {
+			return num::AlignedVec<Type>{ y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x, w * v.w - w * v.w };
+		}
+
+		/* compute the index of the largest or smallest component of the vector (identical to num::Vec::comp) */
+		constexpr size_t comp(bool largest) const {
+			size_t index = 0;
+			for (size_t i = 1; i < 3; i++) {
+				if (largest ? num::Abs((*this)[index]) < num::Abs((*this)[i]) : num::Abs((*this)[index]) > num::Abs((*this)[i]))
+					index = i;
+			}
+			return index;
+		}
+
+		/* compute the vector [this] normalized with the length 1 */
+		constexpr num::AlignedVec<Type> norm() const {
+			return *this / len();
+		}
+
+		/* construct a vector interpolated between [this] and the vector [v] at [t] */
+		constexpr num::AlignedVec<Type> interpolate(const num::AlignedVec<Type>& p, Type t) const {
+			return num::AlignedVec<Type>{ x + (p.x - x) * t, y + (p.y - y) * t, z + (p.z - z) * t, w + (p.w - w) * t };
+		}
+
+		/* check if [this] and [v] are identical (all components are weighted the same) */
+		constexpr bool identical(const num::AlignedVec<Type>& v, Type precision = num::Const<Type>::Precision) const {
+			return num::Cmp(x, v.x, precision) && num::Cmp(y, v.y, precision) && num::Cmp(z, v.z, precision);
+		}
+
+		/* check if [this] and [v] describe the same vector (identical to num::Vec::match) */
+		constexpr bool match(const num::AlignedVec<Type>& v, Type precision = num::Const<Type>::Precision) const {
+			return num::Cmp(dot(v), lenSquared(), precision);
+		}
+
+	public:
+		/* convert the packed vectors [in] to the aligned layout [out] (must be at least as large as [in]) */
+		static void Pack(std::span<const num::Vec<Type>> in, std::span<num::AlignedVec<Type>> out, size_t threads = 0) {
+			num::Parallel(in.size(), threads, 16384, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i)
+					out[i] = num::AlignedVec<Type>{ in[i] };
+			});
+		}
+
+		/* convert the aligned vectors [in] to the packed layout [out] (must be at least as large as [in]) */
+		static void Unpack(std::span<const num::AlignedVec<Type>> in, std::span<num::Vec<Type>> out, size_t threads = 0) {
+			num::Parallel(in.size(), threads, 16384, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i)
+					out[i] = in[i].vec();
+			});
+		}
+	};
+
+	template <std::floating_point Type>
+	constexpr num::AlignedVec<Type> operator*(Type s, const num::AlignedVec<Type>& v) {
+		return v * s;
+	}
+
+	/* num::Line in the aligned layout */
+	template <std::floating_point Type>
+	struct AlignedLine {
+		num::AlignedVec<Type> o;
+		num::AlignedVec<Type> d;
+
+	public:
+		constexpr AlignedLine() = default;
+		constexpr AlignedLine(const num::AlignedVec<Type>& o, const num::AlignedVec<Type>& d) : o{ o }, d{ d } {}
+		constexpr AlignedLine(const num::Line<Type>& l) : o{ l.o }, d{ l.d } {}
+
+	public:
+		/* convert the line to the packed layout */
+		constexpr num::Line<Type> line() const {
+			return num::Line<Type>{ o.vec(), d.vec() };
+		}
+
+		/* compute a point on line [this] */
+		constexpr num::AlignedVec<Type> point(Type t) const {
+			return o + d * t;
+		}
+
+		/* compute the factor for which line [this] reaches the point closest to p (automatically perpendicular) */
+		constexpr Type closestf(const num::AlignedVec<Type>& p) const {
+			return (p - o).dot(d) / d.dot(d);
+		}
+
+		/* compute the shortest vector which connects [p] to a point on the line */
+		constexpr num::AlignedVec<Type> closest(const num::AlignedVec<Type>& p) const {
+			return point(closestf(p)) - p;
+		}
+	};
+
+	/* num::Plane in the aligned layout */
+	template <std::floating_point Type>
+	struct AlignedPlane {
+		num::AlignedVec<Type> o;
+		num::AlignedVec<Type> a;
+		num::AlignedVec<Type> b;
+
+	public:
+		constexpr AlignedPlane() = default;
+		constexpr AlignedPlane(const num::AlignedVec<Type>& o, const num::AlignedVec<Type>& a, const num::AlignedVec<Type>& b) : o{ o }, a{ a }, b{ b } {}
+		constexpr AlignedPlane(const num::Plane<Type>& p) : o{ p.o }, a{ p.a }, b{ p.b } {}
+
+	private:
+		/* compute the linear combination of a and b to [p] while ignoring the component [index] (identical to num::Plane) */
+		constexpr num::Linear<Type> fLinComb(const num::AlignedVec<Type>& p, size_t index) const {
+			const size_t _0 = (index + 1) % 3;
+			const size_t _1 = (index + 2) % 3;
+
+			const Type divisor = a[_0] * b[_1] - a[_1] * b[_0];
+			const Type _v0 = p[_0] - o[_0];
+			const Type _v1 = p[_1] - o[_1];
+			const Type _s = (_v0 * b[_1] - _v1 * b[_0]) / divisor;
+			const Type _t = (a[_0] * _v1 - a[_1] * _v0) / divisor;
+			return num::Linear<Type>{ _s, _t };
+		}
+
+	public:
+		/* convert the plane to the packed layout */
+		constexpr num::Plane<Type> plane() const {
+			return num::Plane<Type>{ o.vec(), a.vec(), b.vec() };
+		}
+
+		constexpr num::AlignedVec<Type> normal() const {
+			return a.cross(b);
+		}
+
+		/* compute a point on plane [this] */
+		constexpr num::AlignedVec<Type> point(Type s, Type t) const {
+			return o + a * s + b * t;
+		}
+
+		/* compute a point on plane [this] */
+		constexpr num::AlignedVec<Type> point(const num::Linear<Type>& lin) const {
+			return o + a * lin.s + b * lin.t;
+		}
+
+		/* check if [p] lies within the triangle of a and b (identical to num::Plane::inTriangle) */
+		constexpr bool inTriangle(const num::AlignedVec<Type>& p, bool* touching = 0, Type precision = num::Const<Type>::Precision) const {
+			const size_t index = a.cross(b).comp(false);
+			const num::Linear<Type> r = fLinComb(p, index);
+			if (touching != 0)
+				*touching = num::Cmp(p[index] - o[index], r.s * a[index] + r.t * b[index], precision);
+			return r.s >= -precision && r.t >= -precision && (r.s + r.t) <= (1 + precision);
+		}
+
+		/* check if [p] lies on the plane (identical to num::Plane::touch) */
+		constexpr bool touch(const num::AlignedVec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			const num::Linear<Type> r = fLinComb(p, a.cross(b).comp(false));
+			return p.match(point(r), precision);
+		}
+
+		/* compute the linear combination to reach the point [p] when the point lies on the plane (identical to num::Plane::linear) */
+		constexpr num::Linear<Type> linear(const num::AlignedVec<Type>& p, bool* touching = 0, Type precision = num::Const<Type>::Precision) const {
+			const size_t index = a.cross(b).comp(false);
+			const num::Linear<Type> r = fLinComb(p, index);
+			if (touching != 0)
+				*touching = num::Cmp(p[index] - o[index], r.s * a[index] + r.t * b[index], precision);
+			return r;
+		}
+
+		/* compute the shortest vector which connects [p] to a point on the plane (automatically perpendicular) */
+		constexpr num::AlignedVec<Type> closest(const num::AlignedVec<Type>& p) const {
+			const num::AlignedVec<Type> crs = a.cross(b);
+			const Type f = (o - p).dot(crs) / crs.dot(crs);
+			return crs * f;
+		}
+
+		/* compute the intersection point of the plane [this] and the line [l] (invalid if parallel: returns null vector) */
+		constexpr num::AlignedVec<Type> intersect(const num::AlignedLine<Type>& l, bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			const num::AlignedVec<Type> crs = a.cross(b);
+
+			/* check if the line and the plane are parallel */
+			if (num::Abs(crs.dot(l.d)) <= precision) {
+				if (invalid)
+					*invalid = true;
+				return num::AlignedVec<Type>{};
+			}
+			else if (invalid)
+				*invalid = false;
+			const Type f = (o - l.o).dot(crs) / l.d.dot(crs);
+			return l.o + l.d * f;
+		}
+	};
+}
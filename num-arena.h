@@ -0,0 +1,210 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <memory_resource>
+#include <cstddef>
+
+#include "num-common.h"
+
+namespace num {
+	/*
+	*	Monotonic arena, which hands out memory linearly from a chain of blocks and ignores deallocations
+	*	- [reset] rewinds the arena for the next frame while keeping its memory, and coalesces the blocks into
+	*		one block large enough for the previous frame, such that repeated frames reach zero heap allocations
+	*	- objects allocated from the arena must not be used after it has been reset or released
+	*	- not thread-safe, use one arena per thread (see [num::Pool::Local])
+	*/
+	struct Arena : public std::pmr::memory_resource {
+	private:
+		struct Block {
+			Block* next = 0;
+			size_t size = 0;
+		};
+		static constexpr size_t Header = (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+	private:
+		std::pmr::memory_resource* pUpstream = 0;
+		Block* pFirst = 0;
+		Block* pCurrent = 0;
+		size_t pOffset = 0;
+		size_t pInitial = 0;
+		size_t pUsed = 0;
+		size_t pPeak = 0;
+
+	public:
+		explicit Arena(size_t initial = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : pUpstream{ upstream }, pInitial{ std::max<size_t>(initial, 256) } {}
+		Arena(const num::Arena&) = delete;
+		num::Arena& operator=(const num::Arena&) = delete;
+		~Arena() {
+			release();
+		}
+
+	private:
+		/* allocate a new block of at least [size] usable bytes from the upstream resource and append it to the chain */
+		Block* fGrow(size_t size) {
+			void* data = pUpstream->allocate(Header + size, alignof(std::max_align_t));
+			Block* block = new (data) Block{ 0, size };
+			if (pCurrent == 0)
+				pFirst = block;
+			else {
+				block->next = pCurrent->next;
+				pCurrent->next = block;
+			}
+			return block;
+		}
+
+		/* release all blocks of the chain starting at [block] to the upstream resource */
+		void fFree(Block* block) {
+			while (block != 0) {
+				Block* next = block->next;
+				pUpstream->deallocate(block, Header + block->size, alignof(std::max_align_t));
+				block = next;
+			}
+		}
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			/* check if the current block can hold the allocation, otherwise advance to the next
+			*	block of the chain, which is large enough, or allocate a new block */
+			while (true) {
+				if (pCurrent != 0) {
+					const uintptr_t base = reinterpret_cast<uintptr_t>(pCurrent) + Header;
+					const uintptr_t start = (base + pOffset + alignment - 1) & ~uintptr_t(alignment - 1);
+					if (start + bytes <= base + pCurrent->size) {
+						pUsed += (start + bytes) - (base + pOffset);
+						pPeak = std::max(pPeak, pUsed);
+						pOffset = (start + bytes) - base;
+						return reinterpret_cast<void*>(start);
+					}
+					pUsed += pCurrent->size - pOffset;
+				}
+
+				/* check if a next block exists, which can be reused */
+				if (pCurrent != 0 && pCurrent->next != 0 && pCurrent->next->size >= bytes + alignment)
+					pCurrent = pCurrent->next;
+				else {
+					const size_t last = (pCurrent == 0 ? pInitial : pCurrent->size * 2);
+					pCurrent = fGrow(std::max(last, bytes + alignment));
+				}
+				pOffset = 0;
+			}
+		}
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return (this == &other);
+		}
+
+	public:
+		/* rewind the arena for the next frame (invalidates all previous allocations, but keeps the memory) */
+		void reset() {
+			/* check if the previous frame required more than one block, in which case the blocks are
+			*	replaced by one block large enough to hold the entire previous frame */
+			if (pFirst != 0 && pFirst->next != 0) {
+				size_t total = 0;
+				for (Block* block = pFirst; block != 0; block = block->next)
+					total += block->size;
+				fFree(pFirst);
+				pCurrent = 0;
+				pFirst = fGrow(total);
+			}
+			pCurrent = pFirst;
+			pOffset = 0;
+			pUsed = 0;
+		}
+
+		/* release all memory back to the upstream resource (invalidates all previous allocations) */
+		void release() {
+			fFree(pFirst);
+			pFirst = 0;
+			pCurrent = 0;
+			pOffset = 0;
+			pUsed = 0;
+		}
+
+		/* number of bytes handed out since the last reset (including alignment padding) */
+		size_t used() const {
+			return pUsed;
+		}
+
+		/* largest number of bytes handed out within any frame */
+		size_t peak() const {
+			return pPeak;
+		}
+
+		/* number of bytes currently held by the arena */
+		size_t capacity() const {
+			size_t total = 0;
+			for (Block* block = pFirst; block != 0; block = block->next)
+				total += block->size;
+			return total;
+		}
+	};
+
+	/*
+	*	Pool, which recycles deallocated memory by size classes and draws its chunks from an arena
+	*	- [reset] releases all memory at once and rewinds the underlying arena for the next frame
+	*	- not thread-safe, [num::Pool::Local] provides one pool per thread
+	*/
+	struct Pool : public std::pmr::memory_resource {
+	private:
+		num::Arena pArena;
+		std::pmr::unsynchronized_pool_resource pPool;
+
+	public:
+		explicit Pool(size_t initial = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : pArena{ initial, upstream }, pPool{ &pArena } {}
+		Pool(const num::Pool&) = delete;
+		num::Pool& operator=(const num::Pool&) = delete;
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			return pPool.allocate(bytes, alignment);
+		}
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+			pPool.deallocate(p, bytes, alignment);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return (this == &other);
+		}
+
+	public:
+		/* pool of the calling thread */
+		static num::Pool& Local() {
+			thread_local num::Pool pool;
+			return pool;
+		}
+
+	public:
+		/* release all allocations for the next frame (invalidates all previous allocations, but keeps the memory) */
+		void reset() {
+			pPool.release();
+			pArena.reset();
+		}
+
+		/* underlying arena of the pool */
+		const num::Arena& arena() const {
+			return pArena;
+		}
+	};
+
+	/* scope guard, which resets the arena or pool [Type] at the end of the frame */
+	template <class Type>
+	struct Frame {
+	private:
+		Type& pResource;
+
+	public:
+		explicit Frame(Type& resource) : pResource{ resource } {}
+		Frame(const num::Frame<Type>&) = delete;
+		num::Frame<Type>& operator=(const num::Frame<Type>&) = delete;
+		~Frame() {
+			pResource.reset();
+		}
+
+	public:
+		/* resource to allocate the temporary objects of the frame from */
+		std::pmr::memory_resource* resource() const {
+			return &pResource;
+		}
+	};
+}
@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <limits>
+
+#include "num-common.h"
+#include "num-vec.h"
+
+namespace num {
+	/* axis aligned box between [min] and [max] (empty if any component of [min] is larger than the one of [max]) */
+	template <std::floating_point Type>
+	struct Box {
+	public:
+		num::Vec<Type> min;
+		num::Vec<Type> max;
+
+	public:
+		constexpr Box() : min{ std::numeric_limits<Type>::infinity() }, max{ -std::numeric_limits<Type>::infinity() } {}
+		constexpr Box(const num::Vec<Type>& p) : min{ p }, max{ p } {}
+		constexpr Box(const num::Vec<Type>& min, const num::Vec<Type>& max) : min{ min }, max{ max } {}
+
+	public:
+		constexpr bool operator==(const num::Box<Type>& b) const {
+			return min == b.min && max == b.max;
+		}
+		constexpr bool operator!=(const num::Box<Type>& b) const {
+			return !(*this == b);
+		}
+
+	public:
+		/* check if the box does not contain any point */
+		constexpr bool empty() const {
+			return !(min.x <= max.x && min.y <= max.y && min.z <= max.z);
+		}
+
+		/* compute the center of the box */
+		constexpr num::Vec<Type> center() const {
+			return (min + max) / 2;
+		}
+
+		/* compute the extent of the box along all axes */
+		constexpr num::Vec<Type> size() const {
+			return max - min;
+		}
+
+		/* compute the smallest box, which contains [this] and the point [p] */
+		constexpr num::Box<Type> extend(const num::Vec<Type>& p) const {
+			return num::Box<Type>{
+				num::Vec<Type>{ std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z) },
+					num::Vec<Type>{ std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z) }
+			};
+		}
+
+		/* compute the smallest box, which contains [this] and the box [b] */
+		constexpr num::Box<Type> merge(const num::Box<Type>& b) const {
+			return num::Box<Type>{
+				num::Vec<Type>{ std::min(min.x, b.min.x), std::min(min.y, b.min.y), std::min(min.z, b.min.z) },
+					num::Vec<Type>{ std::max(max.x, b.max.x), std::max(max.y, b.max.y), std::max(max.z, b.max.z) }
+			};
+		}
+
+		/* check if the point [p] lies within the box */
+		constexpr bool contains(const num::Vec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			return p.x >= min.x - precision && p.y >= min.y - precision && p.z >= min.z - precision
+				&& p.x <= max.x + precision && p.y <= max.y + precision && p.z <= max.z + precision;
+		}
+
+		/* check if the box [b] overlaps [this] */
+		constexpr bool overlaps(const num::Box<Type>& b) const {
+			return min.x <= b.max.x && min.y <= b.max.y && min.z <= b.max.z
+				&& b.min.x <= max.x && b.min.y <= max.y && b.min.z <= max.z;
+		}
+
+		/* compute the shortest vector which connects [p] to a point within the box (zero if it lies within the box) */
+		constexpr num::Vec<Type> closest(const num::Vec<Type>& p) const {
+			return num::Vec<Type>{ std::clamp(p.x, min.x, max.x), std::clamp(p.y, min.y, max.y), std::clamp(p.z, min.z, max.z) } - p;
+		}
+
+		/* compute the corner of the box, which lies furthest along the direction [d] */
+		constexpr num::Vec<Type> support(const num::Vec<Type>& d) const {
+			return num::Vec<Type>{ d.x >= 0 ? max.x : min.x, d.y >= 0 ? max.y : min.y, d.z >= 0 ? max.z : min.z };
+		}
+
+		/* clip the factors [t0; t1] of [o + t * d] to the range within the box (false if the range becomes empty) */
+		constexpr bool clip(const num::Vec<Type>& o, const num::Vec<Type>& d, Type& t0, Type& t1) const {
+			for (size_t i = 0; i < 3; ++i) {
+				if (d[i] == 0) {
+					if (o[i] < min[i] || o[i] > max[i])
+						return false;
+					continue;
+				}
+				const Type inv = 1 / d[i];
+				const Type a = (min[i] - o[i]) * inv, b = (max[i] - o[i]) * inv;
+				t0 = std::max(t0, std::min(a, b));
+				t1 = std::min(t1, std::max(a, b));
+			}
+			return t0 <= t1;
+		}
+	};
+}
@@ -0,0 +1,198 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+
+namespace num {
+	namespace detail {
+		/* storage of the derived properties (empty if caching is disabled) */
+		template <std::floating_point Type, bool Cache>
+		struct PlaneCache {};
+		template <std::floating_point Type>
+		struct PlaneCache<Type, true> {
+			num::Plane<Type> norm;
+			num::Vec<Type> normal;
+			Type area = 0;
+			uint8_t valid = 0;
+		};
+		template <std::floating_point Type, bool Cache>
+		struct LineCache {};
+		template <std::floating_point Type>
+		struct LineCache<Type, true> {
+			num::Line<Type> norm;
+			bool valid = false;
+		};
+	}
+
+	/*
+	*	Wrapper of num::Plane, which computes the derived properties lazily on first use and keeps them until the plane is modified
+	*	- the components can only be modified through the setters, which invalidate the affected properties
+	*	- with [Cache] disabled, the wrapper has the layout of num::Plane and recomputes the properties on every call (for bulk arrays)
+	*	- reading the properties of the same object from multiple threads concurrently requires external synchronization
+	*/
+	template <std::floating_point Type, bool Cache = true>
+	struct CachedPlane {
+	private:
+		static constexpr uint8_t ValidNormal = 0x01;
+		static constexpr uint8_t ValidArea = 0x02;
+		static constexpr uint8_t ValidNorm = 0x04;
+
+	private:
+		num::Plane<Type> pPlane;
+		[[no_unique_address]] mutable detail::PlaneCache<Type, Cache> pCache;
+
+	public:
+		constexpr CachedPlane() = default;
+		constexpr CachedPlane(const num::Plane<Type>& p) : pPlane{ p } {}
+		constexpr CachedPlane(const num::Vec<Type>& o, const num::Vec<Type>& a, const num::Vec<Type>& b) : pPlane{ o, a, b } {}
+
+	public:
+		constexpr operator const num::Plane<Type>& () const {
+			return pPlane;
+		}
+
+	public:
+		/* access the wrapped plane */
+		constexpr const num::Plane<Type>& plane() const {
+			return pPlane;
+		}
+		constexpr const num::Vec<Type>& o() const {
+			return pPlane.o;
+		}
+		constexpr const num::Vec<Type>& a() const {
+			return pPlane.a;
+		}
+		constexpr const num::Vec<Type>& b() const {
+			return pPlane.b;
+		}
+
+		/* modify the wrapped plane and invalidate the affected properties */
+		constexpr void set(const num::Plane<Type>& p) {
+			pPlane = p;
+			if constexpr (Cache)
+				pCache.valid = 0;
+		}
+		constexpr void setO(const num::Vec<Type>& o) {
+			pPlane.o = o;
+			if constexpr (Cache)
+				pCache.valid &= ~ValidNorm;
+		}
+		constexpr void setA(const num::Vec<Type>& a) {
+			pPlane.a = a;
+			if constexpr (Cache)
+				pCache.valid = 0;
+		}
+		constexpr void setB(const num::Vec<Type>& b) {
+			pPlane.b = b;
+			if constexpr (Cache)
+				pCache.valid = 0;
+		}
+
+	public:
+		/* equivalent to num::Plane::normal */
+		constexpr const num::Vec<Type>& normal() const requires Cache {
+			if (!(pCache.valid & ValidNormal)) {
+				pCache.normal = pPlane.normal();
+				pCache.valid |= ValidNormal;
+			}
+			return pCache.normal;
+		}
+		constexpr num::Vec<Type> normal() const requires (!Cache) {
+			return pPlane.normal();
+		}
+
+		/* equivalent to num::Plane::area */
+		constexpr Type area() const {
+			if constexpr (Cache) {
+				if (!(pCache.valid & ValidArea)) {
+					pCache.area = normal().len() / 2;
+					pCache.valid |= ValidArea;
+				}
+				return pCache.area;
+			}
+			else
+				return pPlane.area();
+		}
+
+		/* equivalent to num::Plane::norm */
+		constexpr const num::Plane<Type>& norm() const requires Cache {
+			if (!(pCache.valid & ValidNorm)) {
+				pCache.norm = pPlane.norm();
+				pCache.valid |= ValidNorm;
+			}
+			return pCache.norm;
+		}
+		constexpr num::Plane<Type> norm() const requires (!Cache) {
+			return pPlane.norm();
+		}
+	};
+
+	/*
+	*	Wrapper of num::Line, which computes the derived properties lazily on first use and keeps them until the line is modified
+	*	- the components can only be modified through the setters, which invalidate the properties
+	*	- with [Cache] disabled, the wrapper has the layout of num::Line and recomputes the properties on every call (for bulk arrays)
+	*	- reading the properties of the same object from multiple threads concurrently requires external synchronization
+	*/
+	template <std::floating_point Type, bool Cache = true>
+	struct CachedLine {
+	private:
+		num::Line<Type> pLine;
+		[[no_unique_address]] mutable detail::LineCache<Type, Cache> pCache;
+
+	public:
+		constexpr CachedLine() = default;
+		constexpr CachedLine(const num::Line<Type>& l) : pLine{ l } {}
+		constexpr CachedLine(const num::Vec<Type>& o, const num::Vec<Type>& d) : pLine{ o, d } {}
+
+	public:
+		constexpr operator const num::Line<Type>& () const {
+			return pLine;
+		}
+
+	public:
+		/* access the wrapped line */
+		constexpr const num::Line<Type>& line() const {
+			return pLine;
+		}
+		constexpr const num::Vec<Type>& o() const {
+			return pLine.o;
+		}
+		constexpr const num::Vec<Type>& d() const {
+			return pLine.d;
+		}
+
+		/* modify the wrapped line and invalidate the properties */
+		constexpr void set(const num::Line<Type>& l) {
+			pLine = l;
+			if constexpr (Cache)
+				pCache.valid = false;
+		}
+		constexpr void setO(const num::Vec<Type>& o) {
+			pLine.o = o;
+			if constexpr (Cache)
+				pCache.valid = false;
+		}
+		constexpr void setD(const num::Vec<Type>& d) {
+			pLine.d = d;
+			if constexpr (Cache)
+				pCache.valid = false;
+		}
+
+	public:
+		/* equivalent to num::Line::norm */
+		constexpr const num::Line<Type>& norm() const requires Cache {
+			if (!pCache.valid) {
+				pCache.norm = pLine.norm();
+				pCache.valid = true;
+			}
+			return pCache.norm;
+		}
+		constexpr num::Line<Type> norm() const requires (!Cache) {
+			return pLine.norm();
+		}
+	};
+}
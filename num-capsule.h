@@ -0,0 +1,239 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <limits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-segment.h"
+#include "num-sphere.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+namespace num {
+	/*
+	*	Capsule of all points within the radius [r] of the segment [s] (cylinder with two hemispherical caps)
+	*	- the overlap tests include touching primitives
+	*	- intersections with bounded lines (num::Ray, num::Segment) report the first factor within their range,
+	*		which is zero if the origin lies within the capsule
+	*	- the tests select the closest features and the entries without branches, such that the batch versions, which
+	*		run in parallel with kernels compiled for the active instruction set, transpose blocks of capsules into
+	*		num::detail::VecLanes and vectorize (the square roots of the intersections only vectorize without errno,
+	*		i.e. with -fno-math-errno, and are therefore taken in a separate loop)
+	*/
+	template <std::floating_point Type>
+	struct Capsule {
+	public:
+		num::Segment<Type> s;
+		Type r = 0;
+
+	public:
+		constexpr Capsule() = default;
+		constexpr Capsule(const num::Segment<Type>& s, Type r) : s{ s }, r{ r } {}
+		constexpr Capsule(const num::Vec<Type>& o, const num::Vec<Type>& d, Type r) : s{ o, d }, r{ r } {}
+
+	private:
+		/* compute the terms of the quadratic of the entry of [o + t * d] into the body of the capsule (returns its discriminant) */
+		NUM_KERNEL constexpr Type fBody(const num::Vec<Type>& o, const num::Vec<Type>& d, Type& a, Type& b, Type& baoa, Type& bard, Type& baba) const {
+			/* body: |oa + t * d|^2 - (ba * (oa + t * d))^2 / baba = r^2 */
+			const num::Vec<Type> ba = s.d, oa = o - s.o;
+			baba = ba.dot(ba);
+			bard = ba.dot(d);
+			baoa = ba.dot(oa);
+			a = baba * d.dot(d) - bard * bard;
+			b = baba * d.dot(oa) - baoa * bard;
+			const Type c = baba * oa.dot(oa) - baoa * baoa - r * r * baba;
+			return b * b - a * c;
+		}
+
+		/* compute the discriminants of the entries of [o + t * d] into the body and the caps (x: body, y: cap at [s.o], z: cap at [s.o + s.d]) */
+		NUM_KERNEL constexpr num::Vec<Type> fDiscriminants(const num::Vec<Type>& o, const num::Vec<Type>& d) const {
+			Type a = 0, b = 0, baoa = 0, bard = 0, baba = 0, dd = 0, sb = 0;
+			const Type body = fBody(o, d, a, b, baoa, bard, baba);
+			const Type first = detail::SphereTerms(s.o, r, o, d, dd, sb);
+			return num::Vec<Type>{ body, first, detail::SphereTerms(s.o + s.d, r, o, d, dd, sb) };
+		}
+
+		/* compute the square roots of the discriminants [h] */
+		static NUM_KERNEL constexpr num::Vec<Type> fRoots(const num::Vec<Type>& h) {
+			return num::Vec<Type>{ detail::SphereRoot(h.x), detail::SphereRoot(h.y), detail::SphereRoot(h.z) };
+		}
+
+		/* compute the factor for which [o + t * d] enters the capsule from the square roots [roots] of the discriminants
+		*	(infinity if never, [lo] limits the factors of the caps and the body) */
+		NUM_KERNEL constexpr Type fEnter(const num::Vec<Type>& o, const num::Vec<Type>& d, Type lo, const num::Vec<Type>& roots) const {
+			/*
+			*	the capsule is the union of the body and the two caps, thereby the first entry is the
+			*	smallest entry into any of them, which lies at or after [lo] (iquilez, capsule intersection)
+			*	all entries are evaluated and the first one is selected without branches
+			*/
+			constexpr Type inf = std::numeric_limits<Type>::infinity();
+			Type a = 0, b = 0, baoa = 0, bard = 0, baba = 0;
+			const Type h = fBody(o, d, a, b, baoa, bard, baba);
+			const bool body = (a > 0) & (h >= 0);
+			const Type t = (-b - roots.x) / detail::Divisor(a, !body);
+			const Type y = baoa + t * bard;
+			Type best = (body & (y >= 0) & (y <= baba) & (t >= lo) ? t : inf);
+
+			Type dd = 0, sb = 0, t0 = 0, t1 = 0;
+			const Type h0 = detail::SphereTerms(s.o, r, o, d, dd, sb);
+			const bool first = detail::SphereSolve(h0, dd, sb, roots.y, t0, t1);
+			best = (first & (t0 >= lo) & (t0 < best) ? t0 : best);
+			const Type h1 = detail::SphereTerms(s.o + s.d, r, o, d, dd, sb);
+			const bool second = detail::SphereSolve(h1, dd, sb, roots.z, t0, t1);
+			best = (second & (t0 >= lo) & (t0 < best) ? t0 : best);
+			return best;
+		}
+
+		/* compute the factor to scale the line [l] with to enter [this] from the square roots [roots] of the discriminants (sets [miss] and returns 0 if missed) */
+		NUM_KERNEL constexpr Type fIntersectf(const num::Line<Type>& l, const num::Vec<Type>& roots, bool& miss) const {
+			const Type t = fEnter(l.o, l.d, -std::numeric_limits<Type>::infinity(), roots);
+			miss = !(t < std::numeric_limits<Type>::infinity());
+			return miss ? 0 : t;
+		}
+
+		/* compute the factor to scale the bounded line [l] with to reach [this] first within its range from the square roots [roots] of the discriminants (sets [miss] and returns 0 if missed) */
+		template <num::Extent Ext>
+		NUM_KERNEL constexpr Type fIntersectf(const num::Bounded<Type, Ext>& l, const num::Vec<Type>& roots, bool& miss) const {
+			/* the origin within the capsule is a hit with the factor zero */
+			const bool inside = contains(l.o, 0);
+			const Type enter = fEnter(l.o, l.d, 0, roots);
+			miss = !(inside | ((enter < std::numeric_limits<Type>::infinity()) & (enter <= num::Bounded<Type, Ext>::Upper)));
+			return (miss | inside ? Type(0) : enter);
+		}
+
+	public:
+		/* check if [p] lies within the capsule */
+		constexpr bool contains(const num::Vec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			return s.closest(p).lenSquared() <= (r + precision) * (r + precision);
+		}
+
+		/* check if the sphere [o] overlaps [this] */
+		constexpr bool overlaps(const num::Sphere<Type>& o) const {
+			return s.closest(o.c).lenSquared() <= (r + o.r) * (r + o.r);
+		}
+
+		/* check if the capsule [o] overlaps [this] */
+		constexpr bool overlaps(const num::Capsule<Type>& o) const {
+			return s.closest(o.s).d.lenSquared() <= (r + o.r) * (r + o.r);
+		}
+
+		/* check if the (infinite) plane [p] cuts [this] */
+		constexpr bool overlaps(const num::Plane<Type>& p) const {
+			/* the segment either crosses the plane or one of its ends is within the radius (compared without the square root) */
+			const num::Vec<Type> n = p.normal();
+			const Type d0 = (s.o - p.o).dot(n), d1 = d0 + s.d.dot(n);
+			const Type dist = std::min(num::Abs(d0), num::Abs(d1));
+			return (d0 * d1 <= 0) | (dist * dist <= r * r * n.dot(n));
+		}
+
+		/* check if the triangle of plane [p] overlaps [this] */
+		constexpr bool overlapsTriangle(const num::Plane<Type>& p) const {
+			/* without intersection, the closest distance is taken on from the ends of the segment or the edges of the triangle */
+			bool invalid = false;
+			s.intersectTrianglef(p, &invalid, 0);
+			if (!invalid)
+				return true;
+			const Type rr = r * r;
+			if (p.closestTriangle(s.o).lenSquared() <= rr || p.closestTriangle(s.o + s.d).lenSquared() <= rr)
+				return true;
+			const num::Segment<Type> e0{ p.o, p.a }, e1{ p.o, p.b }, e2{ p.o + p.a, p.b - p.a };
+			return s.closest(e0).d.lenSquared() <= rr || s.closest(e1).d.lenSquared() <= rr || s.closest(e2).d.lenSquared() <= rr;
+		}
+
+		/* compute the factor to scale the line [l] with to enter [this] (invalid if the line misses the capsule: returns 0) */
+		constexpr Type intersectf(const num::Line<Type>& l, bool* invalid = 0) const {
+			bool miss = false;
+			const Type t = fIntersectf(l, fRoots(fDiscriminants(l.o, l.d)), miss);
+			if (invalid)
+				*invalid = miss;
+			return t;
+		}
+
+		/* compute the factor to scale the bounded line [l] with to reach [this] first within its range (invalid if missed: returns 0) */
+		template <num::Extent Ext>
+		constexpr Type intersectf(const num::Bounded<Type, Ext>& l, bool* invalid = 0) const {
+			bool miss = false;
+			const Type t = fIntersectf(l, fRoots(fDiscriminants(l.o, l.d)), miss);
+			if (invalid)
+				*invalid = miss;
+			return t;
+		}
+
+		/* compute the point at which the (bounded) line [l] enters [this] (invalid if missed: returns the line origin) */
+		template <class LineType>
+		constexpr num::Vec<Type> intersect(const LineType& l, bool* invalid = 0) const {
+			return l.point(intersectf(l, invalid));
+		}
+
+	public:
+		/* test all [items] for overlapping the primitive [o] (sphere, capsule or infinite plane) and write the hit flags to [hits] (returns the number of hits) */
+		template <class ObjType>
+		static size_t Overlaps(std::span<const num::Capsule<Type>> items, const ObjType& o, std::span<uint8_t> hits, size_t threads = 0) {
+			return detail::CountHits(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				/* copy the captured values, as the byte stores could otherwise alias them and prevent vectorization */
+				const num::Capsule<Type>* data = items.data();
+				const ObjType obj = o;
+				uint8_t* flags = hits.data();
+				size_t count = 0;
+
+				for (size_t block = begin; block < end; block += detail::BatchBlock) {
+					const size_t size = std::min(detail::BatchBlock, end - block);
+					detail::VecLanes<Type> so, sd;
+					Type radius[detail::BatchBlock];
+					for (size_t i = 0; i < size; ++i) {
+						so.set(i, data[block + i].s.o);
+						sd.set(i, data[block + i].s.d);
+						radius[i] = data[block + i].r;
+					}
+
+					for (size_t i = 0; i < size; ++i) {
+						const bool hit = num::Capsule<Type>{ so[i], sd[i], radius[i] }.overlaps(obj);
+						flags[block + i] = uint8_t(hit);
+						count += size_t(hit);
+					}
+				}
+				return count;
+			});
+		}
+
+		/* compute the factors to scale the (bounded) line [l] with to reach all [items] into [factors] (infinity if missed, returns the number of hits) */
+		template <class LineType>
+		static size_t Intersectf(std::span<const num::Capsule<Type>> items, const LineType& l, std::span<Type> factors, size_t threads = 0) {
+			return detail::CountHits(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				const num::Capsule<Type>* data = items.data();
+				const LineType line = l;
+				Type* out = factors.data();
+				size_t count = 0;
+
+				for (size_t block = begin; block < end; block += detail::BatchBlock) {
+					const size_t size = std::min(detail::BatchBlock, end - block);
+					detail::VecLanes<Type> so, sd, roots;
+					Type radius[detail::BatchBlock];
+					for (size_t i = 0; i < size; ++i) {
+						so.set(i, data[block + i].s.o);
+						sd.set(i, data[block + i].s.d);
+						radius[i] = data[block + i].r;
+					}
+
+					/* the discriminants and the entries vectorize, the square roots only without errno */
+					for (size_t i = 0; i < size; ++i)
+						roots.set(i, num::Capsule<Type>{ so[i], sd[i], radius[i] }.fDiscriminants(line.o, line.d));
+					for (size_t i = 0; i < size; ++i)
+						roots.set(i, fRoots(roots[i]));
+					for (size_t i = 0; i < size; ++i) {
+						bool miss = false;
+						const Type f = num::Capsule<Type>{ so[i], sd[i], radius[i] }.fIntersectf(line, roots[i], miss);
+						out[block + i] = (miss ? std::numeric_limits<Type>::infinity() : f);
+						count += size_t(!miss);
+					}
+				}
+				return count;
+			});
+		}
+	};
+}
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <utility>
 #include <concepts>
+#include <limits>
+#include <type_traits>
 
 namespace num {
 	/*
@@ -26,6 +28,11 @@ namespace num {
 		static constexpr double Pi = 3.141592653589793;
 		static constexpr double ZeroPrecisionFactor = 0.01;
 	};
+	template <> struct Const<long double> {
+		static constexpr long double Precision = 0.00000001L;
+		static constexpr long double Pi = 3.141592653589793238462643383279502884L;
+		static constexpr long double ZeroPrecisionFactor = 0.01L;
+	};
 
 	/* float abs-function (not using std implementation to allow for constexpr) */
 	template <std::floating_point Type>
@@ -33,6 +40,158 @@ namespace num {
 		return (v < 0 ? -v : v);
 	}
 
+	namespace detail {
+		static constexpr long double ConstPi = 3.141592653589793238462643383279502884L;
+		static constexpr long double ConstNan = std::numeric_limits<long double>::quiet_NaN();
+		static constexpr long double ConstInf = std::numeric_limits<long double>::infinity();
+
+		/* compile-time square root by newton iterations, which converge monotonically from above */
+		constexpr long double ConstSqrt(long double v) {
+			if (v != v || v < 0)
+				return detail::ConstNan;
+			if (v == 0 || v == detail::ConstInf)
+				return v;
+			long double x = (v > 1 ? v : 1);
+			while (true) {
+				const long double next = (x + v / x) / 2;
+				if (next >= x)
+					return x;
+				x = next;
+			}
+		}
+
+		/* compile-time reduction of the angle [v] in radians to the range [-pi; pi] */
+		constexpr long double ConstReduce(long double v) {
+			const long double turns = v / (2 * detail::ConstPi);
+			const long double whole = static_cast<long double>(static_cast<int64_t>(turns + (turns < 0 ? -0.5L : 0.5L)));
+			return v - whole * (2 * detail::ConstPi);
+		}
+
+		/* compile-time sine by its taylor series after reducing the angle */
+		constexpr long double ConstSin(long double v) {
+			if (v != v || v == detail::ConstInf || v == -detail::ConstInf)
+				return detail::ConstNan;
+			v = detail::ConstReduce(v);
+			long double term = v, sum = v;
+			for (int n = 1; term != 0; ++n) {
+				term *= -(v * v) / ((2 * n) * (2 * n + 1));
+				if (sum + term == sum)
+					break;
+				sum += term;
+			}
+			return sum;
+		}
+
+		/* compile-time cosine by its taylor series after reducing the angle */
+		constexpr long double ConstCos(long double v) {
+			if (v != v || v == detail::ConstInf || v == -detail::ConstInf)
+				return detail::ConstNan;
+			v = detail::ConstReduce(v);
+			long double term = 1, sum = 1;
+			for (int n = 1; term != 0; ++n) {
+				term *= -(v * v) / ((2 * n - 1) * (2 * n));
+				if (sum + term == sum)
+					break;
+				sum += term;
+			}
+			return sum;
+		}
+
+		/* compile-time arc-tangent by its taylor series after reducing the argument */
+		constexpr long double ConstAtan(long double v) {
+			if (v != v)
+				return detail::ConstNan;
+			if (v < 0)
+				return -detail::ConstAtan(-v);
+			if (v > 1)
+				return detail::ConstPi / 2 - detail::ConstAtan(1 / v);
+
+			/* halve the angle twice by atan(v) = 2 * atan(v / (1 + sqrt(1 + v^2))) to speed up the convergence */
+			for (size_t i = 0; i < 2; ++i)
+				v = v / (1 + detail::ConstSqrt(1 + v * v));
+			long double power = v, sum = v;
+			for (int n = 1; power != 0; ++n) {
+				power *= -(v * v);
+				const long double term = power / (2 * n + 1);
+				if (sum + term == sum)
+					break;
+				sum += term;
+			}
+			return sum * 4;
+		}
+
+		/* compile-time arc-tangent of [y] / [x] with the quadrant resolved [-pi; pi] */
+		constexpr long double ConstAtan2(long double y, long double x) {
+			if (y != y || x != x)
+				return detail::ConstNan;
+			if (x > 0)
+				return detail::ConstAtan(y / x);
+			if (x < 0)
+				return detail::ConstAtan(y / x) + (y < 0 ? -detail::ConstPi : detail::ConstPi);
+			return (y > 0 ? detail::ConstPi / 2 : (y < 0 ? -detail::ConstPi / 2 : 0));
+		}
+	}
+
+	/* check if the number is nan (not using std implementation to allow for constexpr) */
+	template <std::floating_point Type>
+	constexpr bool IsNan(Type v) {
+		return (v != v);
+	}
+
+	/* square root, which can be evaluated at compile time (uses the std implementation at runtime) */
+	template <std::floating_point Type>
+	constexpr Type Sqrt(Type v) {
+		if (std::is_constant_evaluated())
+			return Type(detail::ConstSqrt(v));
+		return std::sqrt(v);
+	}
+
+	/* sine of [v] in radians, which can be evaluated at compile time (uses the std implementation at runtime) */
+	template <std::floating_point Type>
+	constexpr Type Sin(Type v) {
+		if (std::is_constant_evaluated())
+			return Type(detail::ConstSin(v));
+		return std::sin(v);
+	}
+
+	/* cosine of [v] in radians, which can be evaluated at compile time (uses the std implementation at runtime) */
+	template <std::floating_point Type>
+	constexpr Type Cos(Type v) {
+		if (std::is_constant_evaluated())
+			return Type(detail::ConstCos(v));
+		return std::cos(v);
+	}
+
+	/* arc-cosine of [v] in radians, which can be evaluated at compile time (uses the std implementation at runtime) */
+	template <std::floating_point Type>
+	constexpr Type Acos(Type v) {
+		if (std::is_constant_evaluated()) {
+			if (v < -1 || v > 1)
+				return Type(detail::ConstNan);
+			return Type(detail::ConstAtan2(detail::ConstSqrt(1 - (long double)v * v), v));
+		}
+		return std::acos(v);
+	}
+
+	/* arc-tangent of [y] / [x] in radians [-pi; pi], which can be evaluated at compile time (uses the std implementation at runtime) */
+	template <std::floating_point Type>
+	constexpr Type Atan2(Type y, Type x) {
+		if (std::is_constant_evaluated())
+			return Type(detail::ConstAtan2(y, x));
+		return std::atan2(y, x);
+	}
+
+	namespace detail {
+		/* divisor [d] of a quotient, which is discarded if [discard] is set (replaced by one during constant evaluation, where dividing by zero is not
+		*	a constant expression, but used unconditionally at runtime, as selecting it would move the division into a branch and prevent vectorization) */
+		template <std::floating_point Type>
+		constexpr Type Divisor(Type d, bool discard) {
+			if (std::is_constant_evaluated())
+				return (discard ? Type(1) : d);
+			return d;
+		}
+	}
+
 	/* check if number can be considered zero */
 	template <std::floating_point Type>
 	constexpr bool Zero(Type a, Type p = num::Const<Type>::Precision) {
@@ -42,8 +201,8 @@ namespace num {
 
 	/* compare the values for equality, given the corresponding precision */
 	template <std::floating_point Type>
-	bool Cmp(Type a, Type b, Type p = num::Const<Type>::Precision) {
-		if (std::isnan(a) || std::isnan(b))
+	constexpr bool Cmp(Type a, Type b, Type p = num::Const<Type>::Precision) {
+		if (num::IsNan(a) || num::IsNan(b))
 			return false;
 		if (a == 0)
 			return num::Zero(b);
@@ -66,7 +225,7 @@ namespace num {
 
 	template <std::floating_point Type>
 	constexpr Type ToAngle(Type x, Type y) {
-		Type deg = num::ToDegree(std::atan2(x, y));
+		Type deg = num::ToDegree(num::Atan2(x, y));
 		if (deg < 0)
 			deg += 360;
 		return deg;
@@ -100,6 +259,6 @@ namespace num {
 
 	public:
 		constexpr Linear() : s{ 0 }, t{ 0 } {}
-		constexpr Linear(float s, float t) : s{ s }, t{ t } {}
+		constexpr Linear(Type s, Type t) : s{ s }, t{ t } {}
 	};
 }
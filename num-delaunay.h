@@ -0,0 +1,885 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <span>
+#include <vector>
+#include <memory_resource>
+#include <limits>
+#include <cmath>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+#include "num-morton.h"
+
+namespace num {
+	namespace detail {
+		/* exact error-free transformations of Shewchuk, with [y] receiving the rounding error of [x] */
+		inline void TwoSum(double a, double b, double& x, double& y) {
+			x = a + b;
+			const double bv = x - a, av = x - bv;
+			y = (a - av) + (b - bv);
+		}
+		inline void TwoDiff(double a, double b, double& x, double& y) {
+			x = a - b;
+			const double bv = a - x, av = x + bv;
+			y = (a - av) + (bv - b);
+		}
+		inline void TwoProduct(double a, double b, double& x, double& y) {
+			x = a * b;
+			y = std::fma(a, b, -x);
+		}
+
+		inline void FastTwoSum(double a, double b, double& x, double& y) {
+			x = a + b;
+			y = b - (x - a);
+		}
+
+		/* sum the expansions [e] and [f] into [h] with zero elimination (fast-expansion-sum) and return the number of components */
+		inline size_t ExpansionSum(const double* e, size_t en, const double* f, size_t fn, double* h) {
+			size_t ei = 0, fi = 0, n = 0;
+			double q = 0, x = 0, y = 0;
+			if (en == 0 || fn == 0) {
+				for (; ei < en; ++ei)
+					h[n++] = e[ei];
+				for (; fi < fn; ++fi)
+					h[n++] = f[fi];
+				return n;
+			}
+
+			/* merge the components by increasing magnitude and accumulate them in [q] */
+			const auto next = [&]() { return (fi == fn || (ei < en && (f[fi] > e[ei]) == (f[fi] > -e[ei]))) ? e[ei++] : f[fi++]; };
+			q = next();
+			if (ei < en && fi < fn) {
+				detail::FastTwoSum(next(), q, x, y);
+				q = x;
+				if (y != 0)
+					h[n++] = y;
+			}
+			while (ei < en || fi < fn) {
+				detail::TwoSum(q, next(), x, y);
+				q = x;
+				if (y != 0)
+					h[n++] = y;
+			}
+			if (q != 0)
+				h[n++] = q;
+			return n;
+		}
+
+		/* multiply the expansion [e] by [b] into [h] with zero elimination (scale-expansion) and return the number of components */
+		inline size_t ExpansionScale(const double* e, size_t en, double b, double* h) {
+			size_t n = 0;
+			double q = 0, x = 0, y = 0, hi = 0, lo = 0;
+			if (en == 0)
+				return 0;
+			detail::TwoProduct(e[0], b, q, y);
+			if (y != 0)
+				h[n++] = y;
+			for (size_t i = 1; i < en; ++i) {
+				detail::TwoProduct(e[i], b, hi, lo);
+				detail::TwoSum(q, lo, x, y);
+				if (y != 0)
+					h[n++] = y;
+				detail::FastTwoSum(hi, x, q, y);
+				if (y != 0)
+					h[n++] = y;
+			}
+			if (q != 0)
+				h[n++] = q;
+			return n;
+		}
+
+		/*
+		*	Nonoverlapping expansion (sum of components ordered by increasing magnitude), which represents its value exactly
+		*	- the components are stored on the stack, with the capacity of every result derived from its operands (sum of the
+		*		capacities for sums, twice their product for products), which bounds orient2d to 16 and incircle to 1152 components
+		*	- only used as the fallback of the geometric predicates
+		*/
+		template <size_t Capacity>
+		struct Expansion {
+		public:
+			static constexpr size_t Size = Capacity;
+
+		public:
+			std::array<double, Capacity> c;
+			size_t n = 0;
+
+		public:
+			Expansion() = default;
+			Expansion(double hi, double lo) requires (Capacity >= 2) {
+				if (lo != 0)
+					c[n++] = lo;
+				if (hi != 0)
+					c[n++] = hi;
+			}
+
+		public:
+			template <size_t Other>
+			detail::Expansion<Capacity + Other> operator+(const detail::Expansion<Other>& e) const {
+				detail::Expansion<Capacity + Other> out;
+				out.n = detail::ExpansionSum(c.data(), n, e.c.data(), e.n, out.c.data());
+				return out;
+			}
+			template <size_t Other>
+			detail::Expansion<Capacity + Other> operator-(const detail::Expansion<Other>& e) const {
+				detail::Expansion<Other> negated = e;
+				for (size_t i = 0; i < negated.n; ++i)
+					negated.c[i] = -negated.c[i];
+				return *this + negated;
+			}
+			template <size_t Other>
+			detail::Expansion<2 * Capacity * Other> operator*(const detail::Expansion<Other>& e) const {
+				/* accumulate the products with every component of [e] by alternating between two buffers */
+				detail::Expansion<2 * Capacity * Other> out, temp;
+				std::array<double, 2 * Capacity> scaled;
+				double* sum = out.c.data(), * other = temp.c.data();
+				size_t count = 0;
+				for (size_t i = 0; i < e.n; ++i) {
+					const size_t scaledCount = detail::ExpansionScale(c.data(), n, e.c[i], scaled.data());
+					count = detail::ExpansionSum(sum, count, scaled.data(), scaledCount, other);
+					std::swap(sum, other);
+				}
+				if (sum != out.c.data())
+					std::copy(sum, sum + count, out.c.data());
+				out.n = count;
+				return out;
+			}
+
+			/* sign of the represented value (defined by the largest component) */
+			double sign() const {
+				return (n == 0 ? 0.0 : (c[n - 1] < 0 ? -1.0 : 1.0));
+			}
+		};
+
+		/* exact square of the value [hi + lo] of a two-component expansion (with [lo] being the rounding error of [hi]) */
+		inline detail::Expansion<6> Square(double hi, double lo) {
+			double x = 0, y = 0;
+			detail::TwoProduct(hi, hi, x, y);
+			const detail::Expansion<2> hh{ x, y };
+			detail::TwoProduct(2 * hi, lo, x, y);
+			const detail::Expansion<2> hl{ x, y };
+			detail::TwoProduct(lo, lo, x, y);
+			const detail::Expansion<2> ll{ x, y };
+			return hh + hl + ll;
+		}
+
+		/* positive if [a], [b], [c] are ordered counterclockwise, negative if clockwise, zero if collinear (exact sign) */
+		inline double Orient2d(const num::Linear<double>& a, const num::Linear<double>& b, const num::Linear<double>& c) {
+			static constexpr double Bound = (3.0 + 16.0 * std::numeric_limits<double>::epsilon() / 2) * std::numeric_limits<double>::epsilon() / 2;
+			const double left = (a.s - c.s) * (b.t - c.t);
+			const double right = (a.t - c.t) * (b.s - c.s);
+			const double det = left - right;
+			if (std::abs(det) >= Bound * (std::abs(left) + std::abs(right)))
+				return det;
+
+			/* the rounding error may have flipped the sign, thereby evaluate the determinant exactly */
+			double x = 0, y = 0;
+			detail::TwoDiff(a.s, c.s, x, y);
+			const detail::Expansion<2> acs{ x, y };
+			detail::TwoDiff(b.t, c.t, x, y);
+			const detail::Expansion<2> bct{ x, y };
+			detail::TwoDiff(a.t, c.t, x, y);
+			const detail::Expansion<2> act{ x, y };
+			detail::TwoDiff(b.s, c.s, x, y);
+			const detail::Expansion<2> bcs{ x, y };
+			const auto exact = acs * bct - act * bcs;
+			static_assert(decltype(exact)::Size == 16, "orient2d is bound to 16 components");
+			return exact.sign();
+		}
+
+		/* positive if [d] lies inside of the circumcircle of the counterclockwise [a], [b], [c], negative if outside, zero if on it (exact sign) */
+		inline double InCircle(const num::Linear<double>& a, const num::Linear<double>& b, const num::Linear<double>& c, const num::Linear<double>& d) {
+			static constexpr double Bound = (10.0 + 96.0 * std::numeric_limits<double>::epsilon() / 2) * std::numeric_limits<double>::epsilon() / 2;
+			const double adx = a.s - d.s, ady = a.t - d.t;
+			const double bdx = b.s - d.s, bdy = b.t - d.t;
+			const double cdx = c.s - d.s, cdy = c.t - d.t;
+			const double bc = bdx * cdy - cdx * bdy, ca = cdx * ady - adx * cdy, ab = adx * bdy - bdx * ady;
+			const double alift = adx * adx + ady * ady, blift = bdx * bdx + bdy * bdy, clift = cdx * cdx + cdy * cdy;
+			const double det = alift * bc + blift * ca + clift * ab;
+			const double permanent = (std::abs(bdx * cdy) + std::abs(cdx * bdy)) * alift
+				+ (std::abs(cdx * ady) + std::abs(adx * cdy)) * blift
+				+ (std::abs(adx * bdy) + std::abs(bdx * ady)) * clift;
+			if (std::abs(det) > Bound * permanent)
+				return det;
+
+			/* the rounding error may have flipped the sign, thereby evaluate the determinant exactly */
+			double ax = 0, axe = 0, ay = 0, aye = 0, bx = 0, bxe = 0, by = 0, bye = 0, cx = 0, cxe = 0, cy = 0, cye = 0;
+			detail::TwoDiff(a.s, d.s, ax, axe);
+			detail::TwoDiff(a.t, d.t, ay, aye);
+			detail::TwoDiff(b.s, d.s, bx, bxe);
+			detail::TwoDiff(b.t, d.t, by, bye);
+			detail::TwoDiff(c.s, d.s, cx, cxe);
+			detail::TwoDiff(c.t, d.t, cy, cye);
+			const detail::Expansion<2> eax{ ax, axe }, eay{ ay, aye }, ebx{ bx, bxe }, eby{ by, bye }, ecx{ cx, cxe }, ecy{ cy, cye };
+			const auto ea = (detail::Square(ax, axe) + detail::Square(ay, aye)) * (ebx * ecy - ecx * eby);
+			const auto eb = (detail::Square(bx, bxe) + detail::Square(by, bye)) * (ecx * eay - eax * ecy);
+			const auto ec = (detail::Square(cx, cxe) + detail::Square(cy, cye)) * (eax * eby - ebx * eay);
+			const auto exact = ea + eb + ec;
+			static_assert(decltype(exact)::Size == 1152, "incircle is bound to 1152 components");
+			return exact.sign();
+		}
+	}
+
+	/*
+	*	Delaunay triangulation of a set of points within the 2d-frame of a plane, computed by the sweep-hull algorithm
+	*	- the points are orthogonally projected onto the frame [o:a:b] and triangulated in its [s:t] coordinates, which
+	*		triangulates height-fields or scans of roughly planar surfaces, while the faces keep the original 3d points
+	*	- faces are produced as planes [p0:(p1-p0):(p2-p0)], which are oriented counterclockwise in the frame,
+	*		i.e. [num::Plane::normal] points to the same side as the normal of the frame
+	*	- the orientation and in-circle tests are exact (floating point filter with exact expansion fallback),
+	*		thereby the triangulation is valid for any input, including grids and co-circular points (although many nearly
+	*		co-circular points around the seed degrade the sweep towards quadratic time)
+	*	- points with duplicate projections are only triangulated once (the first in sweep order is kept)
+	*	- all internal buffers are allocated on the calling thread from the given memory resource and kept across builds,
+	*		thereby repeated builds of similar size do not allocate
+	*	- the points are split at distinct [s] coordinates into one strip per thread (of at least MinStrip points), which
+	*		are swept concurrently, and the strips are then stitched from left to right by zipping their facing hulls together
+	*		and flipping the edges, which violate the Delaunay condition (divide and conquer with a single merge level)
+	*	- the triangulation only depends on the number of strips for co-circular points, but the order of the faces does
+	*		(strips of collinear points are merged into their neighbors, and inputs, whose stitching exceeds FlipBudget
+	*		flips per point of the stitched strips, fall back to a single strip)
+	*/
+	template <std::floating_point Type>
+	struct Delaunay {
+	private:
+		static constexpr size_t None = size_t(-1);
+		static constexpr size_t MinChunk = 16384;
+		static constexpr size_t MinStrip = 65536;
+		static constexpr size_t FlipBudget = 4;
+
+		/* points [begin, end) in the sweep order, which are triangulated by one sweep (the half-edges start at [6 * begin]) */
+		struct Strip {
+			num::Linear<double> center;
+			size_t begin = 0;
+			size_t end = 0;
+			size_t seed[3] = { 0, 0, 0 };
+			size_t hashBegin = 0;
+			size_t hashSize = 0;
+			size_t edges = 0;
+			size_t hullStart = 0;
+			bool valid = false;
+		};
+
+	private:
+		std::span<const num::Vec<Type>> pPoints;
+		std::pmr::vector<num::Linear<double>> pCoords;
+		std::pmr::vector<num::Linear<double>> pSweep;
+		std::pmr::vector<uint64_t> pKeys;
+		std::pmr::vector<size_t> pOrder;
+		std::pmr::vector<size_t> pPermute;
+		std::pmr::vector<Strip> pStrips;
+		std::pmr::vector<size_t> pHullNext;
+		std::pmr::vector<size_t> pHullPrev;
+		std::pmr::vector<size_t> pHullTri;
+		std::pmr::vector<size_t> pHash;
+		std::pmr::vector<size_t> pStack;
+		std::pmr::vector<size_t> pOpposite;
+		std::pmr::vector<size_t> pHull;
+		std::pmr::vector<num::Plane<Type>> pPlanes;
+		std::pmr::vector<size_t> pIndices;
+		std::pmr::memory_resource* pResource = 0;
+
+	public:
+		explicit Delaunay(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pCoords{ resource }, pSweep{ resource }, pKeys{ resource }, pOrder{ resource },
+			pPermute{ resource }, pStrips{ resource }, pHullNext{ resource }, pHullPrev{ resource }, pHullTri{ resource }, pHash{ resource }, pStack{ resource },
+			pOpposite{ resource }, pHull{ resource }, pPlanes{ resource }, pIndices{ resource }, pResource{ resource } {}
+
+	private:
+		/* bucket of the hull hash of the strip [s], which is monotonic in the angle of [p] around the center of the strip */
+		static size_t fHashKey(const Strip& s, const num::Linear<double>& p) {
+			const double dx = p.s - s.center.s, dy = p.t - s.center.t;
+			const double d = std::abs(dx) + std::abs(dy);
+			const double r = (d > 0 ? dx / d : 0.0);
+			const double angle = (dy > 0 ? 3 - r : 1 + r) / 4;
+			return s.hashBegin + size_t(angle * double(s.hashSize)) % s.hashSize;
+		}
+
+		/* link the half-edges [a] and [b] as opposites of each other */
+		void fLink(size_t a, size_t b) {
+			pOpposite[a] = b;
+			if (b != None)
+				pOpposite[b] = a;
+		}
+
+		/* add the counterclockwise triangle [i0, i1, i2] at the half-edge [edges] (advanced past it) and return its first half-edge [i0->i1] */
+		size_t fTriangle(size_t& edges, size_t i0, size_t i1, size_t i2, size_t a, size_t b, size_t c) {
+			const size_t t = edges;
+			edges += 3;
+			pIndices[t] = i0;
+			pIndices[t + 1] = i1;
+			pIndices[t + 2] = i2;
+			fLink(t, a);
+			fLink(t + 1, b);
+			fLink(t + 2, c);
+			return t;
+		}
+
+		/* check if the vertex opposite to the edge [a] lies inside of the circumcircle of the triangle of [a] */
+		bool fIllegal(size_t a) const {
+			const size_t b = pOpposite[a];
+			if (b == None)
+				return false;
+			const size_t a0 = a - a % 3, b0 = b - b % 3;
+			return (detail::InCircle(pSweep[pIndices[a]], pSweep[pIndices[a0 + (a + 1) % 3]], pSweep[pIndices[a0 + (a + 2) % 3]], pSweep[pIndices[b0 + (b + 2) % 3]]) > 0);
+		}
+
+		/*
+		*	flip the edge [a] with its opposite edge [b]
+		*	- triangle [a] is (u, v, w) with [a] being the edge u->v, and triangle [b] is (v, u, x) with [bp] being the edge x->v
+		*	- the diagonal u-v is flipped to w-x, producing the triangles (x, v, w) at [a] and (w, u, x) at [b]
+		*/
+		void fFlip(size_t a) {
+			const size_t b = pOpposite[a];
+			const size_t a0 = a - a % 3, ap = a0 + (a + 2) % 3;
+			const size_t b0 = b - b % 3, bp = b0 + (b + 2) % 3;
+			const size_t w = pIndices[ap], x = pIndices[bp];
+
+			/* move the hull references of the edges, which changed their half-edge */
+			pIndices[a] = x;
+			pIndices[b] = w;
+			const size_t hbp = pOpposite[bp], hap = pOpposite[ap];
+			if (hbp == None)
+				pHullTri[x] = a;
+			if (hap == None)
+				pHullTri[w] = b;
+			fLink(a, hbp);
+			fLink(b, hap);
+			fLink(ap, bp);
+		}
+
+		/* restore the delaunay condition after inserting a point by flipping the edge [a] and recursively the edges exposed by the flips
+		*	(only the edges opposite to the inserted point need to be checked, of which at most one per point of the strip [s] is pending) */
+		void fLegalize(const Strip& s, size_t a) {
+			size_t depth = 0;
+			while (true) {
+				if (fIllegal(a)) {
+					const size_t b = pOpposite[a];
+					fFlip(a);
+					pStack[s.begin + depth++] = b - b % 3 + (b + 1) % 3;
+					continue;
+				}
+				if (depth == 0)
+					return;
+				a = pStack[s.begin + --depth];
+			}
+		}
+
+		/* restore the delaunay condition for all edges on the stack by flipping them and checking the four outer edges of every flip
+		*	(returns false if more than [budget] flips are necessary) */
+		bool fRestore(size_t budget) {
+			while (!pStack.empty()) {
+				const size_t a = pStack.back();
+				pStack.pop_back();
+				if (!fIllegal(a))
+					continue;
+				if (budget-- == 0)
+					return false;
+				const size_t b = pOpposite[a];
+				fFlip(a);
+				pStack.push_back(a);
+				pStack.push_back(a - a % 3 + (a + 1) % 3);
+				pStack.push_back(b);
+				pStack.push_back(b - b % 3 + (b + 1) % 3);
+			}
+			return true;
+		}
+
+		/* project the points onto the frame (returns false if the frame is degenerate) */
+		bool fProject(const num::Plane<Type>& frame, size_t threads) {
+			const num::Vec<double> o{ double(frame.o.x), double(frame.o.y), double(frame.o.z) };
+			const num::Vec<double> a{ double(frame.a.x), double(frame.a.y), double(frame.a.z) };
+			const num::Vec<double> b{ double(frame.b.x), double(frame.b.y), double(frame.b.z) };
+			const double aa = a.dot(a), ab = a.dot(b), bb = b.dot(b);
+			const double det = aa * bb - ab * ab;
+			if (!(det > 0))
+				return false;
+
+			/* solve the normal equations of [o + a * s + b * t] for every point */
+			pCoords.resize(pPoints.size());
+			num::Parallel(pPoints.size(), threads, MinChunk, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i) {
+					const num::Vec<double> d = num::Vec<double>{ double(pPoints[i].x), double(pPoints[i].y), double(pPoints[i].z) } - o;
+					const double da = a.dot(d), db = b.dot(d);
+					pCoords[i] = num::Linear<double>{ (bb * da - ab * db) / det, (aa * db - ab * da) / det };
+				}
+			});
+			return true;
+		}
+
+		/* split the points at distinct [s] coordinates into up to [strips] strips of the order of their [s] coordinates */
+		void fSplit(size_t strips, size_t threads) {
+			const size_t count = pCoords.size();
+			pOrder.resize(count);
+			if (strips > 1) {
+				/* map the coordinates onto keys of the same order (negative values are mirrored below the sign bit) */
+				pKeys.resize(count);
+				num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t) {
+					for (size_t i = begin; i < end; ++i) {
+						const uint64_t bits = std::bit_cast<uint64_t>(pCoords[i].s);
+						pKeys[i] = ((bits >> 63) ? ~bits : bits | (uint64_t(1) << 63));
+					}
+				});
+				num::RadixSort(pKeys, pOrder, threads, pResource);
+			}
+			else for (size_t i = 0; i < count; ++i)
+				pOrder[i] = i;
+
+			/* move the boundaries forward until the strips are separated (the last strip absorbs a short remainder) */
+			pStrips.clear();
+			for (size_t begin = 0, k = 1; begin < count; ++k) {
+				size_t end = std::max(begin + 1, (count * k) / strips);
+				while (end < count && pCoords[pOrder[end]].s == pCoords[pOrder[end - 1]].s)
+					++end;
+				if (k >= strips || count - end < MinStrip / 2)
+					end = count;
+				Strip& s = pStrips.emplace_back();
+				s.begin = begin;
+				s.end = end;
+				begin = end;
+			}
+		}
+
+		/* select the seed triangle of the strip [s] closest to the center of its points (returns false if all points are collinear) */
+		bool fSeed(Strip& s) const {
+			double minS = std::numeric_limits<double>::infinity(), minT = minS;
+			double maxS = -minS, maxT = -minS;
+			for (size_t i = s.begin; i < s.end; ++i) {
+				const num::Linear<double>& p = pCoords[pOrder[i]];
+				minS = std::min(minS, p.s);
+				minT = std::min(minT, p.t);
+				maxS = std::max(maxS, p.s);
+				maxT = std::max(maxT, p.t);
+			}
+			const double cs = (minS + maxS) / 2, ct = (minT + maxT) / 2;
+
+			/* fetch the point closest to the center and the point closest to it */
+			size_t i0 = None, i1 = None, i2 = None;
+			double best = std::numeric_limits<double>::infinity();
+			for (size_t i = s.begin; i < s.end; ++i) {
+				const num::Linear<double>& p = pCoords[pOrder[i]];
+				const double d = (p.s - cs) * (p.s - cs) + (p.t - ct) * (p.t - ct);
+				if (d < best) {
+					best = d;
+					i0 = pOrder[i];
+				}
+			}
+			if (i0 == None)
+				return false;
+			const num::Linear<double> p0 = pCoords[i0];
+			best = std::numeric_limits<double>::infinity();
+			for (size_t i = s.begin; i < s.end; ++i) {
+				const num::Linear<double>& p = pCoords[pOrder[i]];
+				const double d = (p.s - p0.s) * (p.s - p0.s) + (p.t - p0.t) * (p.t - p0.t);
+				if (d > 0 && d < best) {
+					best = d;
+					i1 = pOrder[i];
+				}
+			}
+			if (i1 == None)
+				return false;
+
+			/* fetch the third point, which forms the smallest circumcircle */
+			const num::Linear<double> p1 = pCoords[i1];
+			best = std::numeric_limits<double>::infinity();
+			for (size_t i = s.begin; i < s.end; ++i) {
+				const num::Linear<double>& p = pCoords[pOrder[i]];
+				if (detail::Orient2d(p0, p1, p) == 0)
+					continue;
+				const num::Linear<double> c = fCircumcenter(p0, p1, p);
+				const double r = c.s * c.s + c.t * c.t;
+				if (r < best) {
+					best = r;
+					i2 = pOrder[i];
+				}
+			}
+			if (i2 == None)
+				return false;
+			if (detail::Orient2d(p0, p1, pCoords[i2]) < 0)
+				std::swap(i1, i2);
+
+			/* setup the center of the sweep of the strip */
+			const num::Linear<double> center = fCircumcenter(p0, pCoords[i1], pCoords[i2]);
+			s.center = num::Linear<double>{ p0.s + center.s, p0.t + center.t };
+			s.seed[0] = i0;
+			s.seed[1] = i1;
+			s.seed[2] = i2;
+			return true;
+		}
+
+		/* compute the offset of the circumcenter of [a], [b], [c] relative to [a] */
+		static num::Linear<double> fCircumcenter(const num::Linear<double>& a, const num::Linear<double>& b, const num::Linear<double>& c) {
+			const double dx = b.s - a.s, dy = b.t - a.t;
+			const double ex = c.s - a.s, ey = c.t - a.t;
+			const double bl = dx * dx + dy * dy, cl = ex * ex + ey * ey;
+			const double d = 0.5 / (dx * ey - dy * ex);
+			return num::Linear<double>{ (ey * bl - dy * cl) * d, (dx * cl - ex * bl) * d };
+		}
+
+		/* sort the points of every strip by their distance to its center and renumber them in that order (keeps the advancing hull local in memory) */
+		void fSort(size_t threads) {
+			const size_t count = pCoords.size();
+			pKeys.resize(count);
+			pPermute.resize(count);
+			for (const Strip& s : pStrips) {
+				num::Parallel(s.end - s.begin, threads, MinChunk, [&](size_t begin, size_t end, size_t) {
+					for (size_t i = s.begin + begin; i < s.begin + end; ++i) {
+						const double ds = pCoords[pOrder[i]].s - s.center.s, dt = pCoords[pOrder[i]].t - s.center.t;
+						pKeys[i] = std::bit_cast<uint64_t>(ds * ds + dt * dt);
+					}
+				});
+				const std::span<uint64_t> keys = std::span<uint64_t>{ pKeys }.subspan(s.begin, s.end - s.begin);
+				num::RadixSort(keys, std::span<size_t>{ pPermute }.subspan(s.begin, s.end - s.begin), threads, pResource);
+			}
+
+			/* map the sorted positions within the strips back to the original points */
+			pSweep.resize(count);
+			size_t strip = 0;
+			for (size_t i = 0; i < count; ++i) {
+				strip += (i == pStrips[strip].end ? 1 : 0);
+				pPermute[i] = pOrder[pStrips[strip].begin + pPermute[i]];
+			}
+			std::swap(pOrder, pPermute);
+			num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i)
+					pSweep[i] = pCoords[pOrder[i]];
+			});
+		}
+
+		/* insert the point [i] of the strip [s], which lies outside of the current hull, by connecting it to all visible hull edges */
+		void fInsert(Strip& s, size_t i) {
+			const num::Linear<double>& p = pSweep[i];
+
+			/* find a visible edge of the hull, starting at the hull vertex of the closest angle around the center */
+			size_t start = None;
+			const size_t key = fHashKey(s, p) - s.hashBegin;
+			for (size_t j = 0; j < s.hashSize; ++j) {
+				start = pHash[s.hashBegin + (key + j) % s.hashSize];
+				if (start != None && pHullNext[start] != start)
+					break;
+			}
+			start = pHullPrev[start];
+			size_t e = start, q = pHullNext[e];
+			while (!(detail::Orient2d(pSweep[e], pSweep[q], p) < 0)) {
+				e = q;
+				q = pHullNext[e];
+				if (e == start)
+					return;
+			}
+
+			/* add the first triangle and walk forward through the visible edges */
+			size_t t = fTriangle(s.edges, e, i, q, None, None, pHullTri[e]);
+			pHullTri[i] = t + 1;
+			pHullTri[e] = t;
+			fLegalize(s, t + 2);
+			size_t n = q;
+			while (true) {
+				q = pHullNext[n];
+				if (!(detail::Orient2d(pSweep[n], pSweep[q], p) < 0))
+					break;
+				t = fTriangle(s.edges, n, i, q, pHullTri[i], None, pHullTri[n]);
+				pHullTri[i] = t + 1;
+				fLegalize(s, t + 2);
+				pHullNext[n] = n;
+				n = q;
+			}
+
+			/* walk backward through the visible edges (only possible if the search did not skip any edges) */
+			if (e == start) {
+				while (true) {
+					q = pHullPrev[e];
+					if (!(detail::Orient2d(pSweep[q], pSweep[e], p) < 0))
+						break;
+					t = fTriangle(s.edges, q, i, e, None, pHullTri[e], pHullTri[q]);
+					pHullTri[q] = t;
+					fLegalize(s, t + 2);
+					pHullNext[e] = e;
+					e = q;
+				}
+			}
+
+			/* update the hull */
+			s.hullStart = e;
+			pHullPrev[i] = e;
+			pHullNext[e] = i;
+			pHullPrev[n] = i;
+			pHullNext[i] = n;
+			pHash[fHashKey(s, p)] = i;
+			pHash[fHashKey(s, pSweep[e])] = e;
+		}
+
+		/* triangulate the points of the strip [s] by the sweep (all indices of the sweep refer to the renumbered points) */
+		void fSweep(Strip& s) {
+			size_t r0 = 0, r1 = 0, r2 = 0;
+			for (size_t i = s.begin; i < s.end; ++i) {
+				if (pOrder[i] == s.seed[0])
+					r0 = i;
+				else if (pOrder[i] == s.seed[1])
+					r1 = i;
+				else if (pOrder[i] == s.seed[2])
+					r2 = i;
+			}
+
+			/* setup the hull of the seed triangle */
+			s.edges = 6 * s.begin;
+			fTriangle(s.edges, r0, r1, r2, None, None, None);
+			pHullNext[r0] = pHullPrev[r2] = r1;
+			pHullNext[r1] = pHullPrev[r0] = r2;
+			pHullNext[r2] = pHullPrev[r1] = r0;
+			pHullTri[r0] = 6 * s.begin;
+			pHullTri[r1] = 6 * s.begin + 1;
+			pHullTri[r2] = 6 * s.begin + 2;
+			pHash[fHashKey(s, pSweep[r0])] = r0;
+			pHash[fHashKey(s, pSweep[r1])] = r1;
+			pHash[fHashKey(s, pSweep[r2])] = r2;
+
+			/* insert the remaining points in the order of their distance to the center, which keeps them outside of the hull */
+			s.hullStart = r0;
+			num::Linear<double> last{ std::numeric_limits<double>::quiet_NaN(), 0.0 };
+			for (size_t i = s.begin; i < s.end; ++i) {
+				const num::Linear<double>& p = pSweep[i];
+				if (i == r0 || i == r1 || i == r2 || (p.s == last.s && p.t == last.t))
+					continue;
+				last = p;
+				fInsert(s, i);
+			}
+		}
+
+		/* move the half-edges of all strips together and return their number */
+		size_t fCompact() {
+			size_t edges = 0;
+			for (const Strip& s : pStrips) {
+				const size_t first = 6 * s.begin, shift = first - edges;
+				if (shift > 0) {
+					for (size_t k = first; k < s.edges; ++k) {
+						pIndices[k - shift] = pIndices[k];
+						pOpposite[k - shift] = (pOpposite[k] == None ? None : pOpposite[k] - shift);
+					}
+					size_t e = s.hullStart;
+					do {
+						pHullTri[e] -= shift;
+						e = pHullNext[e];
+					} while (e != s.hullStart);
+				}
+				edges += s.edges - first;
+			}
+			return edges;
+		}
+
+		/*
+		*	stitch the triangulation of the strip [s] to the triangulation left of it with the hull [hull]
+		*	- the facing hull chains between the lower and upper common tangents are zipped together with triangles, which
+		*		prefer the delaunay diagonal, and all new edges are then flipped until the delaunay condition holds again
+		*	- returns false if the zipper fails or more than [budget] flips are necessary, which happens if the strips differ
+		*		from the final triangulation far off the seam (e.g. points on a circle), where the flips become quadratic
+		*/
+		bool fStitch(size_t& hull, size_t& edges, const Strip& s, size_t budget) {
+			/* walk from the innermost points to the lower and upper common tangents of both hulls */
+			size_t l = hull, r = s.hullStart;
+			for (size_t e = pHullNext[hull]; e != hull; e = pHullNext[e])
+				l = (pSweep[e].s > pSweep[l].s ? e : l);
+			for (size_t e = pHullNext[r]; e != s.hullStart; e = pHullNext[e])
+				r = (pSweep[e].s < pSweep[r].s ? e : r);
+			size_t lowL = l, lowR = r, upL = l, upR = r;
+			for (bool moved = true; moved;) {
+				moved = false;
+				for (; detail::Orient2d(pSweep[lowL], pSweep[lowR], pSweep[pHullPrev[lowL]]) < 0; moved = true)
+					lowL = pHullPrev[lowL];
+				for (; detail::Orient2d(pSweep[lowL], pSweep[lowR], pSweep[pHullNext[lowR]]) < 0; moved = true)
+					lowR = pHullNext[lowR];
+			}
+			for (bool moved = true; moved;) {
+				moved = false;
+				for (; detail::Orient2d(pSweep[upL], pSweep[upR], pSweep[pHullNext[upL]]) > 0; moved = true)
+					upL = pHullNext[upL];
+				for (; detail::Orient2d(pSweep[upL], pSweep[upR], pSweep[pHullPrev[upR]]) > 0; moved = true)
+					upR = pHullPrev[upR];
+			}
+
+			/*
+			*	zip the facing chains upwards from the lower tangent, starting with the triangle on the base edge l->r
+			*	- if both tangents touch a hull in the same point, all other points of that hull lie inside of the merged hull,
+			*		thereby its entire hull faces the other strip
+			*/
+			size_t chainL = 0, chainR = 0;
+			for (size_t e = lowL; e != upL || chainL == 0; e = pHullNext[e])
+				++chainL;
+			for (size_t e = lowR; e != upR || chainR == 0; e = pHullPrev[e])
+				++chainR;
+			pIndices.resize(edges + 3 * (chainL + chainR));
+			pOpposite.resize(pIndices.size());
+			const size_t first = edges;
+			size_t below = None;
+			l = lowL;
+			r = lowR;
+			while (chainL > 0 || chainR > 0) {
+				/*
+				*	a candidate is valid, if it lies above the base edge and the triangle does not overlap the other hull,
+				*	i.e. neither the new diagonal nor the hull edge of the other side points into the other triangle or hull
+				*/
+				const size_t nl = (chainL > 0 ? pHullNext[l] : None), nr = (chainR > 0 ? pHullPrev[r] : None);
+				const num::Linear<double>& pl = pSweep[l], & pr = pSweep[r];
+				const num::Linear<double>& hl = pSweep[pHullNext[l]], & hr = pSweep[pHullPrev[r]];
+				const bool left = (nl != None && detail::Orient2d(pl, pr, hl) > 0 && !(detail::Orient2d(pr, hl, hr) > 0
+					&& (detail::Orient2d(pr, pSweep[pHullNext[r]], hl) > 0 || detail::Orient2d(pr, hr, pl) > 0)));
+				const bool right = (nr != None && detail::Orient2d(pl, pr, hr) > 0 && !(detail::Orient2d(pl, hl, hr) > 0
+					&& (detail::Orient2d(pl, hr, pSweep[pHullPrev[l]]) > 0 || detail::Orient2d(pl, pr, hl) > 0)));
+				if (!left && !right)
+					return false;
+
+				/* prefer the right candidate, if it lies inside of the circumcircle of the left triangle */
+				if (left && (!right || !(detail::InCircle(pl, pr, hl, hr) > 0))) {
+					const size_t t = fTriangle(edges, l, r, nl, below, None, pHullTri[l]);
+					below = t + 1;
+					l = nl;
+					--chainL;
+				}
+				else {
+					const size_t t = fTriangle(edges, l, r, nr, below, pHullTri[nr], None);
+					below = t + 2;
+					r = nr;
+					--chainR;
+				}
+			}
+
+			/* link the merged hull and restore the delaunay condition */
+			pHullTri[lowL] = first;
+			pHullTri[upR] = below;
+			pHullNext[lowL] = lowR;
+			pHullPrev[lowR] = lowL;
+			pHullNext[upR] = upL;
+			pHullPrev[upL] = upR;
+			hull = lowL;
+			pStack.clear();
+			for (size_t k = first; k < edges; ++k)
+				pStack.push_back(k);
+			return fRestore(budget);
+		}
+
+		/* triangulate the projected points in up to [strips] strips (returns false if all points are collinear or the strips could not be stitched) */
+		bool fTriangulate(size_t strips, size_t threads) {
+			pIndices.clear();
+			pOpposite.clear();
+			fSplit(strips, threads);
+
+			/* select the seeds of the strips and merge collinear strips into their neighbors (fails if all points are collinear) */
+			num::Parallel(pStrips.size(), threads, 1, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i)
+					pStrips[i].valid = fSeed(pStrips[i]);
+			});
+			for (size_t i = 0; i < pStrips.size();) {
+				if (pStrips[i].valid) {
+					++i;
+					continue;
+				}
+				if (pStrips.size() == 1)
+					return false;
+				i = (i + 1 < pStrips.size() ? i : i - 1);
+				pStrips[i].end = pStrips[i + 1].end;
+				pStrips.erase(pStrips.begin() + ptrdiff_t(i + 1));
+				pStrips[i].valid = fSeed(pStrips[i]);
+			}
+			fSort(threads);
+
+			/* setup the hull, hash, flip stack, and half-edge ranges of all strips on the calling thread */
+			const size_t count = pCoords.size();
+			size_t hash = 0;
+			for (Strip& s : pStrips) {
+				s.hashBegin = hash;
+				s.hashSize = std::max<size_t>(1, size_t(std::ceil(std::sqrt(double(s.end - s.begin)))));
+				hash += s.hashSize;
+			}
+			pHullNext.assign(count, None);
+			pHullPrev.assign(count, None);
+			pHullTri.assign(count, None);
+			pHash.assign(hash, None);
+			pStack.resize(count);
+			pIndices.resize(6 * count);
+			pOpposite.resize(6 * count);
+
+			/* sweep the strips concurrently and stitch them together from left to right */
+			num::Parallel(pStrips.size(), threads, 1, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i)
+					fSweep(pStrips[i]);
+			});
+			size_t edges = fCompact(), hull = pStrips[0].hullStart;
+			pIndices.resize(edges);
+			pOpposite.resize(edges);
+			for (size_t i = 1; i < pStrips.size(); ++i) {
+				if (!fStitch(hull, edges, pStrips[i], FlipBudget * (pStrips[i].end - pStrips[i - 1].begin)))
+					return false;
+			}
+			pStrips[0].hullStart = hull;
+			return true;
+		}
+
+	public:
+		/* compute the delaunay triangulation of the [points] within the [frame] (returns false and produces no triangles if the projected points are collinear) */
+		bool build(std::span<const num::Vec<Type>> points, const num::Plane<Type>& frame, size_t threads = 0) {
+			pPoints = points;
+			pIndices.clear();
+			pOpposite.clear();
+			pPlanes.clear();
+			pHull.clear();
+
+			/* project and triangulate the points (strips, which could not be stitched, fall back to a single strip) */
+			if (pPoints.size() < 3 || !fProject(frame, threads))
+				return false;
+			const size_t strips = num::ParallelChunks(pPoints.size(), threads, MinStrip);
+			if (!fTriangulate(strips, threads) && (strips == 1 || !fTriangulate(1, threads))) {
+				pIndices.clear();
+				pOpposite.clear();
+				return false;
+			}
+
+			/* collect the hull, map the indices back to the original points, and produce the resulting faces */
+			const size_t hullStart = pStrips[0].hullStart;
+			size_t e = hullStart;
+			do {
+				pHull.push_back(pOrder[e]);
+				e = pHullNext[e];
+			} while (e != hullStart);
+			pPlanes.resize(pIndices.size() / 3);
+			num::Parallel(pPlanes.size(), threads, MinChunk, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i) {
+					for (size_t k = 3 * i; k < 3 * i + 3; ++k)
+						pIndices[k] = pOrder[pIndices[k]];
+					pPlanes[i] = pPoints[pIndices[3 * i]].plane(pPoints[pIndices[3 * i + 1]], pPoints[pIndices[3 * i + 2]]);
+				}
+			});
+			return true;
+		}
+
+		/* faces of the triangulation of the last build (counterclockwise within the frame) */
+		const std::pmr::vector<num::Plane<Type>>& faces() const {
+			return pPlanes;
+		}
+
+		/* indices into the points of the last build, with three consecutive indices per face (same order as [faces]) */
+		const std::pmr::vector<size_t>& indices() const {
+			return pIndices;
+		}
+
+		/* opposite half-edge of every half-edge [3 * face + k] (from index k to k+1 of the face) or size_t(-1) if it lies on the hull */
+		const std::pmr::vector<size_t>& opposite() const {
+			return pOpposite;
+		}
+
+		/* indices into the points of the last build, which form the convex hull within the frame (counterclockwise) */
+		const std::pmr::vector<size_t>& hull() const {
+			return pHull;
+		}
+
+		/* projected [s:t] coordinates of the points of the last build within the frame */
+		std::span<const num::Linear<double>> coordinates() const {
+			return pCoords;
+		}
+	};
+}
@@ -0,0 +1,170 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <string_view>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-parallel.h"
+
+/*
+*	Runtime selection of the instruction set used by the bulk kernels
+*	- every kernel is compiled once per instruction set through target attributes, thereby the translation units
+*		themselves do not need to be compiled with -mavx2 or similar, and the best supported set is selected via cpuid
+*	- the selection can be overridden by the environment variable NUM_ISA (generic, avx2, avx512) or num::SetIsa
+*	- fused multiply-add contraction is disabled for every level, including the generic kernels of translation units
+*		compiled with fma (e.g. -march=haswell), such that all instruction sets produce bit-identical results
+*	- clang ignores the optimize attribute, thereby translation units compiled with fma by clang must pass -ffp-contract=off
+*	- kernels are lambdas marked NUM_KERNEL, which forces their bodies to be inlined and thereby compiled for the target
+*		of the dispatching function (auto-vectorization requires -O3 or -ftree-vectorize with a non-trivial cost model)
+*	- kernels over arrays of structures transpose blocks of their items into num::detail::VecLanes first, as the compilers
+*		do not vectorize loads of the interleaved components of lines and planes
+*	- partial redundancy elimination is disabled for every level, as it moves the operations of selects with constant
+*		arms into conditional blocks, which prevents the if-conversion and thereby the vectorization of branch-free kernels
+*	- helpers called by kernels are marked NUM_KERNEL as well, as their inlining otherwise depends on the translation unit
+*	- on non-x86 targets or compilers without target attributes, only the generic kernels are available
+*/
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define NUM_DISPATCH_X86 1
+#define NUM_KERNEL __attribute__((always_inline))
+#define NUM_TARGET_GENERIC __attribute__((optimize("fp-contract=off", "no-tree-pre")))
+#define NUM_TARGET_AVX2 __attribute__((target("avx2"), optimize("fp-contract=off", "no-tree-pre")))
+#define NUM_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512vl,avx512dq,avx512bw"), optimize("fp-contract=off", "no-tree-pre")))
+#else
+#define NUM_DISPATCH_X86 0
+#define NUM_KERNEL
+#endif
+
+namespace num {
+	/* instruction set levels in ascending order */
+	enum Isa : uint8_t {
+		IsaGeneric = 0,
+		IsaAvx2 = 1,
+		IsaAvx512 = 2,
+	};
+
+	/* detect the best instruction set supported by the executing cpu */
+	inline num::Isa SupportedIsa() {
+#if NUM_DISPATCH_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw"))
+			return num::IsaAvx512;
+		if (__builtin_cpu_supports("avx2"))
+			return num::IsaAvx2;
+#endif
+		return num::IsaGeneric;
+	}
+
+	namespace detail {
+		/* parse the instruction set from the environment variable NUM_ISA (unset or unknown values select the supported set) */
+		inline num::Isa EnvironmentIsa() {
+			const char* value = std::getenv("NUM_ISA");
+			const num::Isa supported = num::SupportedIsa();
+			if (value == 0)
+				return supported;
+			const std::string_view name{ value };
+			if (name == "generic")
+				return num::IsaGeneric;
+			if (name == "avx2")
+				return std::min(num::IsaAvx2, supported);
+			if (name == "avx512")
+				return std::min(num::IsaAvx512, supported);
+			return supported;
+		}
+
+		/* selected instruction set, which is resolved on first use */
+		inline std::atomic<num::Isa>& SelectedIsa() {
+			static std::atomic<num::Isa> isa{ detail::EnvironmentIsa() };
+			return isa;
+		}
+
+#if NUM_DISPATCH_X86
+		template <class Kernel>
+		NUM_TARGET_GENERIC auto RunGeneric(const Kernel& kernel, size_t begin, size_t end) {
+			return kernel(begin, end);
+		}
+		template <class Kernel>
+		NUM_TARGET_AVX2 auto RunAvx2(const Kernel& kernel, size_t begin, size_t end) {
+			return kernel(begin, end);
+		}
+		template <class Kernel>
+		NUM_TARGET_AVX512 auto RunAvx512(const Kernel& kernel, size_t begin, size_t end) {
+			return kernel(begin, end);
+		}
+#endif
+	}
+
+	/* instruction set used by the bulk kernels */
+	inline num::Isa ActiveIsa() {
+		return detail::SelectedIsa().load(std::memory_order_relaxed);
+	}
+
+	/* override the instruction set used by the bulk kernels (limited to the supported set, returns the selected set) */
+	inline num::Isa SetIsa(num::Isa isa) {
+		isa = std::min(isa, num::SupportedIsa());
+		detail::SelectedIsa().store(isa, std::memory_order_relaxed);
+		return isa;
+	}
+
+	/* execute the NUM_KERNEL [kernel(begin, end)] compiled for the active instruction set */
+	template <class Kernel>
+	auto Dispatch(const Kernel& kernel, size_t begin, size_t end) {
+#if NUM_DISPATCH_X86
+		switch (num::ActiveIsa()) {
+		case num::IsaAvx512:
+			return detail::RunAvx512(kernel, begin, end);
+		case num::IsaAvx2:
+			return detail::RunAvx2(kernel, begin, end);
+		default:
+			return detail::RunGeneric(kernel, begin, end);
+		}
+#else
+		return kernel(begin, end);
+#endif
+	}
+
+	/* distribute [count] items like num::Parallel and execute the NUM_KERNEL [kernel(begin, end)] for every chunk compiled for the active instruction set */
+	template <class Kernel>
+	void ParallelDispatch(size_t count, size_t threads, size_t minChunk, const Kernel& kernel) {
+		num::Parallel(count, threads, minChunk, [&](size_t begin, size_t end, size_t) {
+			num::Dispatch(kernel, begin, end);
+		});
+	}
+
+	namespace detail {
+		/* number of items, which the batch kernels transpose at once into separate component arrays */
+		inline constexpr size_t BatchBlock = 256;
+
+		/* components of up to [detail::BatchBlock] vectors in separate arrays (structure of arrays), which allows the arithmetic on them to be vectorized */
+		template <std::floating_point Type>
+		struct VecLanes {
+		public:
+			Type x[detail::BatchBlock];
+			Type y[detail::BatchBlock];
+			Type z[detail::BatchBlock];
+
+		public:
+			constexpr num::Vec<Type> operator[](size_t i) const {
+				return num::Vec<Type>{ x[i], y[i], z[i] };
+			}
+			constexpr void set(size_t i, const num::Vec<Type>& v) {
+				x[i] = v.x;
+				y[i] = v.y;
+				z[i] = v.z;
+			}
+		};
+
+		/* distribute [count] items like num::ParallelDispatch and return the sum of the counts returned by the NUM_KERNEL [kernel(begin, end)] for every chunk */
+		template <class Kernel>
+		size_t CountHits(size_t count, size_t threads, size_t minChunk, const Kernel& kernel) {
+			std::atomic<size_t> total = 0;
+			num::Parallel(count, threads, minChunk, [&](size_t begin, size_t end, size_t) {
+				total.fetch_add(num::Dispatch(kernel, begin, end), std::memory_order_relaxed);
+			});
+			return total.load(std::memory_order_relaxed);
+		}
+	}
+}
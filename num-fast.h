@@ -0,0 +1,151 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <bit>
+#include <span>
+#include <type_traits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+/*
+*	Approximate math for heuristics, which do not require full precision
+*	- selected by using num::fast::[...] instead of the corresponding num::[...] or num::Vec::[...] function
+*	- the reciprocal square root is computed in the width of the type (float for float, double otherwise), such that double
+*		inputs keep their full exponent range (as long as the squared lengths remain normal), while the angle polynomials are evaluated in float on ratios within [0; 1]
+*	- all approximations are branch-free to allow the bulk versions to be vectorized
+*	- error bounds (measured by dense sweeps of RSqrt over all normal positive values and of Acos over [-1; 1],
+*		and by random sampling of the remaining functions on components within [-10; 10] and at the extremes of the range):
+*		RSqrt/Sqrt/Len/Norm/Rescalef: relative error <= 6.6e-4 (~66x Const<float>::Precision)
+*		Acos:                         absolute error <= 7.0e-5 radians
+*		Atan2:                        absolute error <= 2.0e-6 radians
+*		Angle:                        absolute error <= 0.02 degrees
+*		ToAngle:                      absolute error <= 1.2e-4 degrees
+*	- as the errors exceed num::Const<Type>::Precision, the results must not be compared with the default precision
+*/
+namespace num::fast {
+	/* approximate the reciprocal square root of [v] (v must be positive and normal, zero yields a large finite value) */
+	template <std::floating_point Type>
+	constexpr Type RSqrt(Type v) {
+		/*
+		*	initial guess by halving the exponent followed by one newton step with tuned coefficients (Kadlec),
+		*	the double constant is the float constant rebased onto the double exponent bias and mantissa
+		*/
+		if constexpr (std::is_same_v<Type, float>) {
+			float y = std::bit_cast<float>(uint32_t(0x5f1ffff9u - (std::bit_cast<uint32_t>(v) >> 1)));
+			return y * 0.703952253f * (2.38924456f - v * y * y);
+		}
+		else {
+			const double d = double(v);
+			double y = std::bit_cast<double>(uint64_t(0x5fe3ffff20000000ull - (std::bit_cast<uint64_t>(d) >> 1)));
+			return Type(y * 0.703952253 * (2.38924456 - d * y * y));
+		}
+	}
+
+	/* approximate the square root of [v] (v must not be negative) */
+	template <std::floating_point Type>
+	constexpr Type Sqrt(Type v) {
+		return v * num::fast::RSqrt(v);
+	}
+
+	/* approximate the arc-cosine of [v] in radians (v must lie within [-1; 1]) */
+	template <std::floating_point Type>
+	constexpr Type Acos(Type v) {
+		/* polynomial approximation (Abramowitz and Stegun 4.4.45) mirrored for negative values */
+		const float x = num::Abs(float(v));
+		const float r = num::Sqrt(1.0f - x) * (1.5707288f + x * (-0.2121144f + x * (0.0742610f - x * 0.0187293f)));
+		return Type(v < 0 ? num::Const<float>::Pi - r : r);
+	}
+
+	/* approximate the arc-tangent of [y] / [x] in radians [-pi; pi] */
+	template <std::floating_point Type>
+	constexpr Type Atan2(Type y, Type x) {
+		/* evaluate the polynomial on the octant and mirror the result into the correct quadrant */
+		const Type ax = num::Abs(x), ay = num::Abs(y);
+		const Type mx = std::max(ax, ay), mn = std::min(ax, ay);
+		const float z = float(mx > 0 ? mn / mx : Type(0)), z2 = z * z;
+		float r = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f - z2 * 0.01172120f)))));
+		r = (ay > ax ? num::Const<float>::Pi * 0.5f - r : r);
+		r = (x < 0 ? num::Const<float>::Pi - r : r);
+		return Type(y < 0 ? -r : r);
+	}
+
+	/* approximate num::ToAngle */
+	template <std::floating_point Type>
+	constexpr Type ToAngle(Type x, Type y) {
+		const Type deg = num::ToDegree(num::fast::Atan2(x, y));
+		return (deg < 0 ? deg + 360 : deg);
+	}
+
+	/* approximate num::Vec::len */
+	template <std::floating_point Type>
+	constexpr Type Len(const num::Vec<Type>& v) {
+		return num::fast::Sqrt(v.lenSquared());
+	}
+
+	/* approximate num::Vec::norm */
+	template <std::floating_point Type>
+	constexpr num::Vec<Type> Norm(const num::Vec<Type>& v) {
+		return v * num::fast::RSqrt(v.lenSquared());
+	}
+
+	/* approximate num::Vec::rescalef */
+	template <std::floating_point Type>
+	constexpr Type Rescalef(const num::Vec<Type>& v, Type l) {
+		return num::Abs(l) * num::fast::RSqrt(v.lenSquared());
+	}
+
+	/* approximate num::Vec::rescale */
+	template <std::floating_point Type>
+	constexpr num::Vec<Type> Rescale(const num::Vec<Type>& v, Type l) {
+		return v * num::fast::Rescalef(v, l);
+	}
+
+	/* approximate num::Vec::angle [0; 180] */
+	template <std::floating_point Type>
+	constexpr Type Angle(const num::Vec<Type>& a, const num::Vec<Type>& b) {
+		/* use the arc-tangent of the sine and cosine, as the arc-cosine amplifies the error of
+		*	the approximated lengths for nearly parallel vectors (the sine needs no normalization) */
+		const Type sine = num::fast::Len(a.cross(b));
+		return num::ToDegree(num::fast::Atan2(sine, a.dot(b)));
+	}
+
+	/* approximate the lengths of all vectors of [in] into [out] */
+	template <std::floating_point Type>
+	void Lens(std::span<const num::Vec<Type>> in, std::span<Type> out, size_t threads = 0) {
+		num::ParallelDispatch(in.size(), threads, 65536, [&](size_t begin, size_t end) NUM_KERNEL {
+			for (size_t i = begin; i < end; ++i)
+				out[i] = num::fast::Len(in[i]);
+		});
+	}
+
+	/* approximate the normalized vectors of all vectors of [in] into [out] (may be identical to [in]) */
+	template <std::floating_point Type>
+	void Norms(std::span<const num::Vec<Type>> in, std::span<num::Vec<Type>> out, size_t threads = 0) {
+		num::ParallelDispatch(in.size(), threads, 65536, [&](size_t begin, size_t end) NUM_KERNEL {
+			for (size_t i = begin; i < end; ++i)
+				out[i] = num::fast::Norm(in[i]);
+		});
+	}
+
+	/* approximate the angles between the pairs of vectors of [a] and [b] into [out] */
+	template <std::floating_point Type>
+	void Angles(std::span<const num::Vec<Type>> a, std::span<const num::Vec<Type>> b, std::span<Type> out, size_t threads = 0) {
+		num::ParallelDispatch(a.size(), threads, 65536, [&](size_t begin, size_t end) NUM_KERNEL {
+			for (size_t i = begin; i < end; ++i)
+				out[i] = num::fast::Angle(a[i], b[i]);
+		});
+	}
+
+	/* approximate num::ToAngle for all pairs of [x] and [y] into [out] */
+	template <std::floating_point Type>
+	void ToAngles(std::span<const Type> x, std::span<const Type> y, std::span<Type> out, size_t threads = 0) {
+		num::ParallelDispatch(x.size(), threads, 65536, [&](size_t begin, size_t end) NUM_KERNEL {
+			for (size_t i = begin; i < end; ++i)
+				out[i] = num::fast::ToAngle(x[i], y[i]);
+		});
+	}
+}
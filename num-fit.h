@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-reduce.h"
+
+namespace num {
+	/*
+	*	Single-pass accumulator of the mean and the second central moments of a stream of points
+	*	- the moments are updated incrementally around the running mean (Welford), which avoids the cancellation of raw sums
+	*	- accumulators of separate chunks or threads can be merged exactly (Chan et al.), the merged result only depends on the merge order
+	*	- the best-fit plane and line minimize the sum of the squared orthogonal distances (total least squares)
+	*/
+	template <std::floating_point Type>
+	struct Moments {
+	private:
+		num::Vec<Type> pMean;
+		num::Symmetric<Type> pM2;
+		size_t pCount = 0;
+
+	public:
+		constexpr Moments() = default;
+		constexpr Moments(const num::Vec<Type>& p) : pMean{ p }, pCount{ 1 } {}
+
+	public:
+		/* number of accumulated points */
+		constexpr size_t count() const {
+			return pCount;
+		}
+
+		/* mean of all accumulated points (zero if empty) */
+		constexpr const num::Vec<Type>& mean() const {
+			return pMean;
+		}
+
+		/* (population) covariance matrix of all accumulated points (zero if empty) */
+		constexpr num::Symmetric<Type> covariance() const {
+			return (pCount == 0 ? num::Symmetric<Type>{} : pM2 / Type(pCount));
+		}
+
+	public:
+		/* accumulate the point [p] */
+		constexpr num::Moments<Type>& add(const num::Vec<Type>& p) {
+			/* the outer product of the deviations from the old and new mean is (n - 1) / n * delta * delta^T */
+			++pCount;
+			const num::Vec<Type> delta = p - pMean;
+			pMean += delta / Type(pCount);
+			pM2 = pM2 + num::Symmetric<Type>::Outer(delta) * (Type(pCount - 1) / Type(pCount));
+			return *this;
+		}
+
+		/* accumulate all [points] in parallel (bitwise reproducible for any number of threads) */
+		num::Moments<Type>& add(std::span<const num::Vec<Type>> points, size_t threads = 0) {
+			return merge(num::Moments<Type>::Compute(points, threads));
+		}
+
+		/* merge the accumulated points of [m] into [this] */
+		constexpr num::Moments<Type>& merge(const num::Moments<Type>& m) {
+			if (m.pCount == 0)
+				return *this;
+			if (pCount == 0)
+				return (*this = m);
+
+			const Type na = Type(pCount), nb = Type(m.pCount), n = na + nb;
+			const num::Vec<Type> delta = m.pMean - pMean;
+			pMean += delta * (nb / n);
+			pM2 = pM2 + m.pM2 + num::Symmetric<Type>::Outer(delta) * (na * nb / n);
+			pCount += m.pCount;
+			return *this;
+		}
+
+	public:
+		/* compute the variances along the principal axes in ascending order and optionally the orthonormal axes into [axes] (more precise if requested) */
+		constexpr num::Vec<Type> principal(num::Vec<Type>* axes = 0) const {
+			return covariance().eigen(axes);
+		}
+
+		/* compute the plane through the mean spanned by the two principal axes of largest variance, whose normal is the axis of
+		*	least variance (invalid if less than three points or all points are collinear within the relative [precision]: returns a plane with a zero normal) */
+		constexpr num::Plane<Type> plane(bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			num::Vec<Type> axes[3];
+			const num::Vec<Type> values = principal(axes);
+			const bool valid = (pCount >= 3 && values.z > 0 && values.y > values.z * precision);
+			if (invalid)
+				*invalid = !valid;
+			if (!valid)
+				return num::Plane<Type>{ pMean, num::Vec<Type>{}, num::Vec<Type>{} };
+			return num::Plane<Type>{ pMean, axes[1], axes[2] };
+		}
+
+		/* compute the line through the mean along the principal axis of largest variance (invalid if less than two points or all points are identical: returns a line with a zero direction) */
+		constexpr num::Line<Type> line(bool* invalid = 0) const {
+			num::Vec<Type> axes[3];
+			const num::Vec<Type> values = principal(axes);
+			const bool valid = (pCount >= 2 && values.z > 0);
+			if (invalid)
+				*invalid = !valid;
+			return num::Line<Type>{ pMean, (valid ? axes[2] : num::Vec<Type>{}) };
+		}
+
+		/* compute the mean squared orthogonal distance of the points to the best-fit plane */
+		constexpr Type planeResidual() const {
+			num::Vec<Type> axes[3];
+			return std::max<Type>(principal(axes).x, 0);
+		}
+
+		/* compute the mean squared orthogonal distance of the points to the best-fit line */
+		constexpr Type lineResidual() const {
+			num::Vec<Type> axes[3];
+			const num::Vec<Type> values = principal(axes);
+			return std::max<Type>(values.x + values.y, 0);
+		}
+
+	public:
+		/* compute the moments of all [points] in parallel (bitwise reproducible for any number of threads) */
+		static num::Moments<Type> Compute(std::span<const num::Vec<Type>> points, size_t threads = 0) {
+			return detail::Reduce(points.size(), threads, num::Moments<Type>{},
+				[&](size_t i) { return num::Moments<Type>{ points[i] }; },
+				[](const num::Moments<Type>& a, const num::Moments<Type>& b) { return num::Moments<Type>{ a }.merge(b); });
+		}
+	};
+}
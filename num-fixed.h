@@ -0,0 +1,780 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <bit>
+#include <span>
+#include <compare>
+#include <algorithm>
+#include <type_traits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+#if NUM_DISPATCH_X86
+#include <immintrin.h>
+#endif
+
+/*
+*	Fixed-point numbers and geometry for deterministic (lockstep) computations
+*	- all operations are defined purely on integers, thereby every platform, compiler and instruction set produces
+*		bit-identical results (this includes the square root and the trigonometric functions)
+*	- products are rounded to nearest (ties towards positive infinity), quotients are truncated towards zero,
+*		and overflows wrap around (division by zero produces zero)
+*	- dot and cross products, lengths, and the ratios of the line and plane tests are accumulated exactly in 128 bits and
+*		rounded once, thereby only their results must lie within the range of the type (e.g. the length of a Q16 vector of
+*		200 units, whose squared length of 40000 does not fit into Q16)
+*	- the trigonometric functions use radians like their floating point counterparts and are evaluated by CORDIC
+*		iterations with fixed integer tables, the square root is computed digit by digit and truncated
+*/
+namespace num {
+	template <class RawType, uint32_t Fraction>
+	struct Fixed;
+
+	namespace detail {
+		template <class Type>
+		struct IsFixed : std::false_type {};
+		template <class RawType, uint32_t Fraction>
+		struct IsFixed<num::Fixed<RawType, Fraction>> : std::true_type {};
+
+		/* signed 128-bit integer of exact intermediate products (two's complement split into two halves) */
+		struct Wide {
+			uint64_t hi = 0;
+			uint64_t lo = 0;
+		};
+
+		/* compute the exact product [a * b] */
+		constexpr detail::Wide WideMul(int64_t a, int64_t b) {
+#if defined(__SIZEOF_INT128__)
+			const __int128 v = __int128(a) * b;
+			return detail::Wide{ uint64_t(v >> 64), uint64_t(v) };
+#else
+			/* compose the signed product from the unsigned 32-bit partial products */
+			const uint64_t ua = uint64_t(a), ub = uint64_t(b);
+			const uint64_t a0 = ua & 0xffffffffu, a1 = ua >> 32, b0 = ub & 0xffffffffu, b1 = ub >> 32;
+			const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+			const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffu) + (p10 & 0xffffffffu);
+			uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+			if (a < 0)
+				hi -= ub;
+			if (b < 0)
+				hi -= ua;
+			return detail::Wide{ hi, (p00 & 0xffffffffu) | (mid << 32) };
+#endif
+		}
+		constexpr detail::Wide WideAdd(const detail::Wide& a, const detail::Wide& b) {
+			const uint64_t lo = a.lo + b.lo;
+			return detail::Wide{ a.hi + b.hi + (lo < a.lo ? 1 : 0), lo };
+		}
+		constexpr detail::Wide WideSub(const detail::Wide& a, const detail::Wide& b) {
+			return detail::Wide{ a.hi - b.hi - (a.lo < b.lo ? 1 : 0), a.lo - b.lo };
+		}
+
+		/* compute [v >> shift] with an arithmetic shift (shift must be within [0; 127]) */
+		constexpr detail::Wide WideShift(const detail::Wide& v, uint32_t shift) {
+			const uint64_t sign = ((v.hi >> 63) != 0 ? ~uint64_t(0) : 0);
+			if (shift == 0)
+				return v;
+			if (shift >= 64)
+				return detail::Wide{ sign, (shift == 64 ? v.hi : uint64_t(int64_t(v.hi) >> (shift - 64))) };
+			return detail::Wide{ uint64_t(int64_t(v.hi) >> shift), (v.lo >> shift) | (v.hi << (64 - shift)) };
+		}
+
+		/* compute the lower 64 bits of [(v + 2^(shift - 1)) >> shift] (shift must be within [1; 64]) */
+		constexpr int64_t WideRound(const detail::Wide& v, uint32_t shift) {
+			return int64_t(detail::WideShift(detail::WideAdd(v, detail::Wide{ 0, uint64_t(1) << (shift - 1) }), shift).lo);
+		}
+
+		/* number of bits required by the magnitude of [v] */
+		constexpr uint32_t WideWidth(const detail::Wide& v) {
+			const detail::Wide m = ((v.hi >> 63) != 0 ? detail::WideSub(detail::Wide{}, v) : v);
+			return (m.hi != 0 ? 64 + uint32_t(std::bit_width(m.hi)) : uint32_t(std::bit_width(m.lo)));
+		}
+
+		/* compute [(a * b + 2^(shift - 1)) >> shift] with the full 128-bit product (shift must be within [1; 63]) */
+		constexpr int64_t MulShift(int64_t a, int64_t b, uint32_t shift) {
+			return detail::WideRound(detail::WideMul(a, b), shift);
+		}
+
+		/* compute [(a << shift) / b] truncated towards zero with the full 128-bit dividend (zero if [b] is zero) */
+		constexpr int64_t DivShift(int64_t a, int64_t b, uint32_t shift) {
+			if (b == 0)
+				return 0;
+#if defined(__SIZEOF_INT128__)
+			return int64_t((__int128(a) * (__int128(1) << shift)) / b);
+#else
+			/* long division of the magnitudes (bit by bit, as no portable 128-by-64 division exists) */
+			const bool negative = ((a < 0) != (b < 0));
+			const uint64_t ua = (a < 0 ? 0 - uint64_t(a) : uint64_t(a)), ub = (b < 0 ? 0 - uint64_t(b) : uint64_t(b));
+			uint64_t hi = (shift == 0 ? 0 : ua >> (64 - shift)), lo = ua << shift, quotient = 0, rem = 0;
+			for (uint32_t i = 0; i < 128; ++i) {
+				const bool top = (rem >> 63) != 0;
+				rem = (rem << 1) | (hi >> 63);
+				hi = (hi << 1) | (lo >> 63);
+				lo <<= 1;
+				quotient <<= 1;
+				if (top || rem >= ub) {
+					rem -= ub;
+					quotient |= 1;
+				}
+			}
+			return int64_t(negative ? 0 - quotient : quotient);
+#endif
+		}
+
+		/* compute [(n << shift) / d] truncated towards zero, with both reduced by the same power of two to fit into 62 bits */
+		constexpr int64_t WideDiv(const detail::Wide& n, const detail::Wide& d, uint32_t shift) {
+			const uint32_t width = std::max(detail::WideWidth(n), detail::WideWidth(d));
+			const uint32_t drop = (width > 62 ? width - 62 : 0);
+			return detail::DivShift(int64_t(detail::WideShift(n, drop).lo), int64_t(detail::WideShift(d, drop).lo), shift);
+		}
+
+		/* square root of [v] truncated to an integer (zero for negative values, digit by digit like num::Sqrt) */
+		constexpr uint64_t WideSqrt(const detail::Wide& v) {
+			if ((v.hi >> 63) != 0)
+				return 0;
+			uint64_t root = 0, remHi = 0, remLo = 0, hi = v.hi, lo = v.lo;
+			for (uint32_t i = 0; i < 64; ++i) {
+				remHi = (remHi << 2) | (remLo >> 62);
+				remLo = (remLo << 2) | (hi >> 62);
+				hi = (hi << 2) | (lo >> 62);
+				lo <<= 2;
+				root <<= 1;
+
+				/* compare the remainder against [2 * root + 1] (the root fits into 64 bits, the test into 65) */
+				const uint64_t testLo = (root << 1) + 1, testHi = root >> 63;
+				if (remHi > testHi || (remHi == testHi && remLo >= testLo)) {
+					remHi -= testHi + (remLo < testLo ? 1 : 0);
+					remLo -= testLo;
+					root += 1;
+				}
+			}
+			return root;
+		}
+
+		/* round the value [v] with [shift] fractional bits to an integer (ties towards positive infinity) */
+		constexpr int64_t RoundShift(int64_t v, uint32_t shift) {
+			return (shift == 0 ? v : (v + (int64_t(1) << (shift - 1))) >> shift);
+		}
+
+		/* arc-tangents of 2^-i for i < 21 with 62 fractional bits (for all larger i, the arc-tangent rounds to 2^-i) */
+		inline constexpr int64_t CordicAtan[21] = {
+			3622009729038561421ll, 2138197195906305897ll, 1129764675555192497ll, 573486189672913778ll,
+			287855953345232185ll, 144068303048368715ll, 72051730834756822ll, 36028064038054493ll,
+			18014306884351854ll, 9007187801521084ll, 4503598195715550ll, 2251799634728303ll,
+			1125899884473003ll, 562949950625109ll, 281474976361131ll, 140737488311637ll,
+			70368744172203ll, 35184372088149ll, 17592186044331ll, 8796093022197ll,
+			4398046511103ll
+		};
+
+		/* inverse of the CORDIC gain with 62 fractional bits and pi with 61 fractional bits */
+		inline constexpr int64_t CordicGain = 2800459870029452954ll;
+		inline constexpr int64_t CordicPi = 7244019458077122842ll;
+
+		/* arc-tangent of 2^-i with [bits] fractional bits */
+		constexpr int64_t CordicAngle(uint32_t i, uint32_t bits) {
+			const int64_t v = (i < 21 ? detail::CordicAtan[i] : int64_t(1) << (62 - i));
+			return detail::RoundShift(v, 62 - bits);
+		}
+	}
+
+	/* fixed-point number type (num::Q16 or num::Q32) */
+	template <class Type>
+	concept FixedPoint = detail::IsFixed<Type>::value;
+
+	/*
+	*	Signed fixed-point number with [Fraction] fractional bits stored in the integer [raw]
+	*	- num::Q16 (Q16.16 in 32 bits) covers [-32768; 32768) with a resolution of 1.5e-5
+	*	- num::Q32 (Q32.32 in 64 bits) covers [-2^31; 2^31) with a resolution of 2.3e-10
+	*/
+	template <class RawType, uint32_t Fraction>
+	struct Fixed {
+		static_assert(std::is_same_v<RawType, int32_t> || std::is_same_v<RawType, int64_t>, "fixed-point numbers are stored in 32 or 64 bits");
+		static_assert(Fraction > 0 && Fraction < sizeof(RawType) * 8 - 1 && Fraction % 2 == 0, "the fraction must leave an integer bit and be even");
+
+	public:
+		using Raw = RawType;
+		using Unsigned = std::make_unsigned_t<RawType>;
+		static constexpr uint32_t Bits = Fraction;
+
+	public:
+		RawType raw = 0;
+
+	public:
+		constexpr Fixed() = default;
+		constexpr Fixed(int v) : raw{ RawType(Unsigned(RawType(v)) << Fraction) } {}
+		template <std::floating_point Type>
+		explicit constexpr Fixed(Type v) : raw{ RawType(v * Type(Unsigned(1) << Fraction) + (v < 0 ? Type(-0.5) : Type(0.5))) } {}
+
+	public:
+		/* create the number from its raw representation */
+		static constexpr num::Fixed<RawType, Fraction> FromRaw(RawType raw) {
+			num::Fixed<RawType, Fraction> out;
+			out.raw = raw;
+			return out;
+		}
+
+		/* convert the number to the floating point type [Type] */
+		template <std::floating_point Type>
+		constexpr Type to() const {
+			return Type(raw) / Type(Unsigned(1) << Fraction);
+		}
+
+	public:
+		constexpr num::Fixed<RawType, Fraction> operator+(const num::Fixed<RawType, Fraction>& v) const {
+			return FromRaw(RawType(Unsigned(raw) + Unsigned(v.raw)));
+		}
+		constexpr num::Fixed<RawType, Fraction> operator-(const num::Fixed<RawType, Fraction>& v) const {
+			return FromRaw(RawType(Unsigned(raw) - Unsigned(v.raw)));
+		}
+		constexpr num::Fixed<RawType, Fraction> operator-() const {
+			return FromRaw(RawType(Unsigned(0) - Unsigned(raw)));
+		}
+		constexpr num::Fixed<RawType, Fraction> operator*(const num::Fixed<RawType, Fraction>& v) const {
+			if constexpr (sizeof(RawType) == sizeof(int32_t))
+				return FromRaw(RawType((int64_t(raw) * v.raw + (int64_t(1) << (Fraction - 1))) >> Fraction));
+			else
+				return FromRaw(detail::MulShift(raw, v.raw, Fraction));
+		}
+		constexpr num::Fixed<RawType, Fraction> operator/(const num::Fixed<RawType, Fraction>& v) const {
+			if constexpr (sizeof(RawType) == sizeof(int32_t))
+				return FromRaw(v.raw == 0 ? 0 : RawType((int64_t(raw) * (int64_t(1) << Fraction)) / v.raw));
+			else
+				return FromRaw(detail::DivShift(raw, v.raw, Fraction));
+		}
+		constexpr num::Fixed<RawType, Fraction>& operator+=(const num::Fixed<RawType, Fraction>& v) {
+			return (*this = *this + v);
+		}
+		constexpr num::Fixed<RawType, Fraction>& operator-=(const num::Fixed<RawType, Fraction>& v) {
+			return (*this = *this - v);
+		}
+		constexpr num::Fixed<RawType, Fraction>& operator*=(const num::Fixed<RawType, Fraction>& v) {
+			return (*this = *this * v);
+		}
+		constexpr num::Fixed<RawType, Fraction>& operator/=(const num::Fixed<RawType, Fraction>& v) {
+			return (*this = *this / v);
+		}
+		constexpr bool operator==(const num::Fixed<RawType, Fraction>& v) const = default;
+		constexpr std::strong_ordering operator<=>(const num::Fixed<RawType, Fraction>& v) const = default;
+	};
+
+	using Q16 = num::Fixed<int32_t, 16>;
+	using Q32 = num::Fixed<int64_t, 32>;
+
+	/* constants of the fixed-point types (equivalent to num::Const of the floating point types) */
+	template <num::FixedPoint Type> struct FixedConst;
+	template <> struct FixedConst<num::Q16> {
+		static constexpr num::Q16 Precision = num::Q16::FromRaw(16);
+		static constexpr num::Q16 Pi = num::Q16::FromRaw(int32_t(detail::RoundShift(detail::CordicPi, 61 - 16)));
+	};
+	template <> struct FixedConst<num::Q32> {
+		static constexpr num::Q32 Precision = num::Q32::FromRaw(4096);
+		static constexpr num::Q32 Pi = num::Q32::FromRaw(detail::RoundShift(detail::CordicPi, 61 - 32));
+	};
+
+	/* absolute value of [v] */
+	template <num::FixedPoint Type>
+	constexpr Type Abs(Type v) {
+		return (v.raw < 0 ? -v : v);
+	}
+
+	/* square root of [v] truncated to the resolution of the type (zero for negative values) */
+	template <num::FixedPoint Type>
+	constexpr Type Sqrt(Type v) {
+		/* digit by digit computation of the root of [raw << Bits] (Turkowski, Fixed Point Square Root) */
+		using Unsigned = typename Type::Unsigned;
+		constexpr uint32_t width = sizeof(Unsigned) * 8;
+		if (v.raw <= 0)
+			return Type{};
+		Unsigned root = 0, remHi = 0, remLo = Unsigned(v.raw);
+		for (uint32_t i = 0; i <= (width / 2 - 1) + Type::Bits / 2; ++i) {
+			remHi = Unsigned(remHi << 2) | Unsigned(remLo >> (width - 2));
+			remLo = Unsigned(remLo << 2);
+			root = Unsigned(root << 1);
+			const Unsigned test = Unsigned(root << 1) + 1;
+			if (remHi >= test) {
+				remHi -= test;
+				root += 1;
+			}
+		}
+		return Type::FromRaw(typename Type::Raw(root));
+	}
+
+	namespace detail {
+		/* number of fractional bits used by the CORDIC iterations of [Type] */
+		template <num::FixedPoint Type>
+		inline constexpr uint32_t CordicBits = std::min<uint32_t>(Type::Bits + 14, 60);
+
+		/* compute the cosine [c] and sine [s] of [v] in radians with [CordicBits] fractional bits */
+		template <num::FixedPoint Type>
+		constexpr void CordicRotate(Type v, int64_t& c, int64_t& s) {
+			constexpr uint32_t bits = detail::CordicBits<Type>;
+			const int64_t pi = detail::RoundShift(detail::CordicPi, 61 - bits), half = pi / 2;
+
+			/* reduce the angle to [-pi; pi] and fold it onto [-pi/2; pi/2] (mirroring the cosine) */
+			int64_t z = int64_t(v.raw) % detail::RoundShift(detail::CordicPi, 60 - Type::Bits);
+			z *= int64_t(1) << (bits - Type::Bits);
+			if (z > pi)
+				z -= 2 * pi;
+			else if (z < -pi)
+				z += 2 * pi;
+			bool mirror = false;
+			if (z > half) {
+				z = pi - z;
+				mirror = true;
+			}
+			else if (z < -half) {
+				z = -pi - z;
+				mirror = true;
+			}
+
+			/* rotate the pre-scaled unit vector by the angle */
+			int64_t x = detail::RoundShift(detail::CordicGain, 62 - bits), y = 0;
+			for (uint32_t i = 0; i <= bits; ++i) {
+				const int64_t dx = (y >> i), dy = (x >> i), angle = detail::CordicAngle(i, bits);
+				if (z >= 0) {
+					x -= dx;
+					y += dy;
+					z -= angle;
+				}
+				else {
+					x += dx;
+					y -= dy;
+					z += angle;
+				}
+			}
+			c = (mirror ? -x : x);
+			s = y;
+		}
+	}
+
+	/* sine of [v] in radians (deterministic) */
+	template <num::FixedPoint Type>
+	constexpr Type Sin(Type v) {
+		int64_t c = 0, s = 0;
+		detail::CordicRotate(v, c, s);
+		return Type::FromRaw(typename Type::Raw(detail::RoundShift(s, detail::CordicBits<Type> - Type::Bits)));
+	}
+
+	/* cosine of [v] in radians (deterministic) */
+	template <num::FixedPoint Type>
+	constexpr Type Cos(Type v) {
+		int64_t c = 0, s = 0;
+		detail::CordicRotate(v, c, s);
+		return Type::FromRaw(typename Type::Raw(detail::RoundShift(c, detail::CordicBits<Type> - Type::Bits)));
+	}
+
+	/* arc-tangent of [y] / [x] in radians [-pi; pi] (deterministic, zero if both are zero) */
+	template <num::FixedPoint Type>
+	constexpr Type Atan2(Type y, Type x) {
+		constexpr uint32_t bits = detail::CordicBits<Type>;
+		if (x.raw == 0 && y.raw == 0)
+			return Type{};
+
+		/* normalize the magnitude to leave room for the growth of the CORDIC gain */
+		int64_t _x = x.raw, _y = y.raw;
+		const uint64_t magnitude = std::max(_x < 0 ? 0 - uint64_t(_x) : uint64_t(_x), _y < 0 ? 0 - uint64_t(_y) : uint64_t(_y));
+		const int32_t length = int32_t(std::bit_width(magnitude)), target = int32_t(bits);
+		if (length < target) {
+			_x *= int64_t(1) << (target - length);
+			_y *= int64_t(1) << (target - length);
+		}
+		else {
+			_x >>= (length - target);
+			_y >>= (length - target);
+		}
+
+		/* rotate the left half-plane onto the right half-plane and drive the y component to zero */
+		const int64_t pi = detail::RoundShift(detail::CordicPi, 61 - bits);
+		int64_t z = 0;
+		if (_x < 0) {
+			z = (_y >= 0 ? pi : -pi);
+			_x = -_x;
+			_y = -_y;
+		}
+		for (uint32_t i = 0; i <= bits; ++i) {
+			const int64_t dx = (_y >> i), dy = (_x >> i), angle = detail::CordicAngle(i, bits);
+			if (_y > 0) {
+				_x += dx;
+				_y -= dy;
+				z += angle;
+			}
+			else {
+				_x -= dx;
+				_y += dy;
+				z -= angle;
+			}
+		}
+		return Type::FromRaw(typename Type::Raw(detail::RoundShift(z, bits - Type::Bits)));
+	}
+
+	template <num::FixedPoint Type>
+	struct FixedVec;
+
+	namespace detail {
+		/* exact dot product of [a] and [b] (with twice the fractional bits of [Type]) */
+		template <num::FixedPoint Type>
+		constexpr detail::Wide WideDot(const num::FixedVec<Type>& a, const num::FixedVec<Type>& b) {
+			return detail::WideAdd(detail::WideAdd(detail::WideMul(a.x.raw, b.x.raw), detail::WideMul(a.y.raw, b.y.raw)), detail::WideMul(a.z.raw, b.z.raw));
+		}
+
+		/* exact determinant [a0 * b1 - a1 * b0] (with twice the fractional bits of [Type]) */
+		template <num::FixedPoint Type>
+		constexpr detail::Wide WideDet(Type a0, Type b1, Type a1, Type b0) {
+			return detail::WideSub(detail::WideMul(a0.raw, b1.raw), detail::WideMul(a1.raw, b0.raw));
+		}
+
+		/* exact cross product of [a] and [b] (with twice the fractional bits of [Type]) */
+		template <num::FixedPoint Type>
+		constexpr void WideCross(const num::FixedVec<Type>& a, const num::FixedVec<Type>& b, detail::Wide (&out)[3]) {
+			out[0] = detail::WideDet(a.y, b.z, a.z, b.y);
+			out[1] = detail::WideDet(a.z, b.x, a.x, b.z);
+			out[2] = detail::WideDet(a.x, b.y, a.y, b.x);
+		}
+
+		/* round the wide value [v] with twice the fractional bits of [Type] to [Type] */
+		template <num::FixedPoint Type>
+		constexpr Type WideTo(const detail::Wide& v) {
+			return Type::FromRaw(typename Type::Raw(detail::WideRound(v, Type::Bits)));
+		}
+
+		/* compute the ratio [n / d] of two wide values of the same fractional bits as [Type] (zero if [d] is zero) */
+		template <num::FixedPoint Type>
+		constexpr Type WideRatio(const detail::Wide& n, const detail::Wide& d) {
+			return Type::FromRaw(typename Type::Raw(detail::WideDiv(n, d, Type::Bits)));
+		}
+
+		/* check if the magnitude of [a] is less than the magnitude of [b] */
+		constexpr bool WideAbsLess(const detail::Wide& a, const detail::Wide& b) {
+			const detail::Wide _a = ((a.hi >> 63) != 0 ? detail::WideSub(detail::Wide{}, a) : a);
+			const detail::Wide _b = ((b.hi >> 63) != 0 ? detail::WideSub(detail::Wide{}, b) : b);
+			return (_a.hi != _b.hi ? _a.hi < _b.hi : _a.lo < _b.lo);
+		}
+	}
+
+	/* linear combination of two spanning vectors with fixed-point factors */
+	template <num::FixedPoint Type>
+	struct FixedLinear {
+	public:
+		Type s;
+		Type t;
+
+	public:
+		constexpr FixedLinear() = default;
+		constexpr FixedLinear(Type s, Type t) : s{ s }, t{ t } {}
+	};
+
+	/* fixed-point equivalent of num::Vec */
+	template <num::FixedPoint Type>
+	struct FixedVec {
+	public:
+		Type x;
+		Type y;
+		Type z;
+
+	public:
+		constexpr FixedVec() = default;
+		constexpr FixedVec(Type f) : x{ f }, y{ f }, z{ f } {}
+		constexpr FixedVec(Type x, Type y, Type z) : x{ x }, y{ y }, z{ z } {}
+		template <std::floating_point FType>
+		explicit constexpr FixedVec(const num::Vec<FType>& v) : x{ v.x }, y{ v.y }, z{ v.z } {}
+
+	public:
+		constexpr Type& operator[](size_t i) {
+			return (i == 0 ? x : (i == 1 ? y : z));
+		}
+		constexpr const Type& operator[](size_t i) const {
+			return (i == 0 ? x : (i == 1 ? y : z));
+		}
+
+	public:
+		constexpr num::FixedVec<Type> operator+(const num::FixedVec<Type>& v) const {
+			return num::FixedVec<Type>{ x + v.x, y + v.y, z + v.z };
+		}
+		constexpr num::FixedVec<Type> operator-(const num::FixedVec<Type>& v) const {
+			return num::FixedVec<Type>{ x - v.x, y - v.y, z - v.z };
+		}
+		constexpr num::FixedVec<Type> operator-() const {
+			return num::FixedVec<Type>{ -x, -y, -z };
+		}
+		constexpr num::FixedVec<Type> operator*(Type s) const {
+			return num::FixedVec<Type>{ x * s, y * s, z * s };
+		}
+		constexpr num::FixedVec<Type> operator/(Type s) const {
+			return num::FixedVec<Type>{ x / s, y / s, z / s };
+		}
+		constexpr num::FixedVec<Type>& operator+=(const num::FixedVec<Type>& v) {
+			return (*this = *this + v);
+		}
+		constexpr num::FixedVec<Type>& operator-=(const num::FixedVec<Type>& v) {
+			return (*this = *this - v);
+		}
+		constexpr bool operator==(const num::FixedVec<Type>& v) const = default;
+
+	public:
+		/* convert the vector to the floating point vector of [FType] */
+		template <std::floating_point FType>
+		constexpr num::Vec<FType> to() const {
+			return num::Vec<FType>{ x.template to<FType>(), y.template to<FType>(), z.template to<FType>() };
+		}
+
+		constexpr Type dot(const num::FixedVec<Type>& v) const {
+			return detail::WideTo<Type>(detail::WideDot(*this, v));
+		}
+		constexpr num::FixedVec<Type> cross(const num::FixedVec<Type>& v) const {
+			detail::Wide c[3];
+			detail::WideCross(*this, v, c);
+			return num::FixedVec<Type>{ detail::WideTo<Type>(c[0]), detail::WideTo<Type>(c[1]), detail::WideTo<Type>(c[2]) };
+		}
+		constexpr Type lenSquared() const {
+			return dot(*this);
+		}
+		constexpr Type len() const {
+			/* the root of the exact squared length has the fractional bits of the type */
+			return Type::FromRaw(typename Type::Raw(detail::WideSqrt(detail::WideDot(*this, *this))));
+		}
+		constexpr num::FixedVec<Type> norm() const {
+			return *this / len();
+		}
+
+		/* index of the smallest or largest component by magnitude */
+		constexpr size_t comp(bool largest) const {
+			const Type _x = num::Abs(x), _y = num::Abs(y), _z = num::Abs(z);
+			if (largest)
+				return (_x >= _y && _x >= _z ? 0 : (_y >= _z ? 1 : 2));
+			return (_x <= _y && _x <= _z ? 0 : (_y <= _z ? 1 : 2));
+		}
+
+		/* check if the vector [v] matches [this] within [precision] per component */
+		constexpr bool match(const num::FixedVec<Type>& v, Type precision = num::FixedConst<Type>::Precision) const {
+			return num::Abs(x - v.x) <= precision && num::Abs(y - v.y) <= precision && num::Abs(z - v.z) <= precision;
+		}
+
+	public:
+		/* compute the dot products of [a] and [b] into [out] (Q16 uses integer AVX2 kernels if available) */
+		static void Dots(std::span<const num::FixedVec<Type>> a, std::span<const num::FixedVec<Type>> b, std::span<Type> out, size_t threads = 0);
+	};
+
+	/* fixed-point equivalent of num::Line */
+	template <num::FixedPoint Type>
+	struct FixedLine {
+	public:
+		num::FixedVec<Type> o;
+		num::FixedVec<Type> d;
+
+	public:
+		constexpr FixedLine() = default;
+		constexpr FixedLine(const num::FixedVec<Type>& o, const num::FixedVec<Type>& d) : o{ o }, d{ d } {}
+
+	public:
+		constexpr num::FixedVec<Type> point(Type t) const {
+			return o + d * t;
+		}
+
+		/* compute the factor for which line [this] reaches the point closest to p */
+		constexpr Type closestf(const num::FixedVec<Type>& p) const {
+			return detail::WideRatio<Type>(detail::WideDot(p - o, d), detail::WideDot(d, d));
+		}
+
+		/* compute the shortest vector which connects [p] to a point on the line */
+		constexpr num::FixedVec<Type> closest(const num::FixedVec<Type>& p) const {
+			return point(closestf(p)) - p;
+		}
+
+		/* returns a position along the line where the point [p] lies (result only valid if it lies on the line) */
+		constexpr Type find(const num::FixedVec<Type>& p) const {
+			const size_t index = d.comp(true);
+			return (p[index] - o[index]) / d[index];
+		}
+
+		/* check if [p] lies on the line */
+		constexpr bool touch(const num::FixedVec<Type>& p, Type precision = num::FixedConst<Type>::Precision) const {
+			return p.match(point(find(p)), precision);
+		}
+	};
+
+	/* fixed-point equivalent of num::Plane */
+	template <num::FixedPoint Type>
+	struct FixedPlane {
+	public:
+		num::FixedVec<Type> o;
+		num::FixedVec<Type> a;
+		num::FixedVec<Type> b;
+
+	public:
+		constexpr FixedPlane() = default;
+		constexpr FixedPlane(const num::FixedVec<Type>& o, const num::FixedVec<Type>& a, const num::FixedVec<Type>& b) : o{ o }, a{ a }, b{ b } {}
+
+	private:
+		/* index of the largest component of the exact normal by magnitude (identical to normal().comp(true) within the range of the type) */
+		constexpr size_t fNormalIndex() const {
+			detail::Wide n[3];
+			detail::WideCross(a, b, n);
+			if (!detail::WideAbsLess(n[0], n[1]) && !detail::WideAbsLess(n[0], n[2]))
+				return 0;
+			return (!detail::WideAbsLess(n[1], n[2]) ? 1 : 2);
+		}
+
+		/* compute the linear combination of [p] while ignoring the component [index] (identical to num::Plane) */
+		constexpr num::FixedLinear<Type> fLinComb(const num::FixedVec<Type>& p, size_t index) const {
+			const size_t _0 = (index + 1) % 3;
+			const size_t _1 = (index + 2) % 3;
+			const detail::Wide divisor = detail::WideDet(a[_0], b[_1], a[_1], b[_0]);
+			const Type _v0 = p[_0] - o[_0];
+			const Type _v1 = p[_1] - o[_1];
+			return num::FixedLinear<Type>{ detail::WideRatio<Type>(detail::WideDet(_v0, b[_1], _v1, b[_0]), divisor),
+				detail::WideRatio<Type>(detail::WideDet(a[_0], _v1, a[_1], _v0), divisor) };
+		}
+
+	public:
+		constexpr num::FixedVec<Type> normal() const {
+			return a.cross(b);
+		}
+		constexpr num::FixedVec<Type> point(Type s, Type t) const {
+			return o + a * s + b * t;
+		}
+
+		/* compute the linear combination to reach the point [p] on the plane */
+		constexpr num::FixedLinear<Type> linear(const num::FixedVec<Type>& p) const {
+			return fLinComb(p, fNormalIndex());
+		}
+
+		/* check if [p] lies within the triangle of a and b (optionally check if it touches the plane) */
+		constexpr bool inTriangle(const num::FixedVec<Type>& p, bool* touching = 0, Type precision = num::FixedConst<Type>::Precision) const {
+			const size_t index = fNormalIndex();
+			const num::FixedLinear<Type> r = fLinComb(p, index);
+			if (touching != 0) {
+				const detail::Wide along = detail::WideAdd(detail::WideMul(r.s.raw, a[index].raw), detail::WideMul(r.t.raw, b[index].raw));
+				*touching = (num::Abs((p[index] - o[index]) - detail::WideTo<Type>(along)) <= precision);
+			}
+			return r.s >= -precision && r.t >= -precision && (r.s + r.t) <= (Type{ 1 } + precision);
+		}
+
+		/* check if [p] lies on the plane */
+		constexpr bool touch(const num::FixedVec<Type>& p, Type precision = num::FixedConst<Type>::Precision) const {
+			const num::FixedLinear<Type> r = linear(p);
+			return p.match(point(r.s, r.t), precision);
+		}
+
+		/* compute the factor to scale the line [l] with to reach the plane (invalid if parallel: returns 0) */
+		constexpr Type intersectf(const num::FixedLine<Type>& l, bool* invalid = 0, Type precision = num::FixedConst<Type>::Precision) const {
+			/* reduce the exact normal by a power of two to 62 bits, such that the triple products fit into 128 bits */
+			detail::Wide n[3];
+			detail::WideCross(a, b, n);
+			const uint32_t width = std::max({ detail::WideWidth(n[0]), detail::WideWidth(n[1]), detail::WideWidth(n[2]) });
+			const uint32_t drop = (width > 62 ? width - 62 : 0);
+			const int64_t n0 = int64_t(detail::WideShift(n[0], drop).lo), n1 = int64_t(detail::WideShift(n[1], drop).lo), n2 = int64_t(detail::WideShift(n[2], drop).lo);
+			const num::FixedVec<Type> v = o - l.o;
+			const detail::Wide divisor = detail::WideAdd(detail::WideAdd(detail::WideMul(l.d.x.raw, n0), detail::WideMul(l.d.y.raw, n1)), detail::WideMul(l.d.z.raw, n2));
+			const detail::Wide dividend = detail::WideAdd(detail::WideAdd(detail::WideMul(v.x.raw, n0), detail::WideMul(v.y.raw, n1)), detail::WideMul(v.z.raw, n2));
+
+			/* compare the divisor in the units of the type (normals beyond 2^62 units are only parallel for a zero divisor) */
+			bool parallel = (divisor.hi == 0 && divisor.lo == 0);
+			if (drop < 2 * Type::Bits) {
+				const uint32_t shift = 2 * Type::Bits - drop;
+				const int64_t rounded = detail::WideRound(divisor, shift);
+				parallel = (detail::WideWidth(divisor) <= 62 + shift && (rounded < 0 ? -rounded : rounded) <= int64_t(precision.raw));
+			}
+			if (invalid)
+				*invalid = parallel;
+			return (parallel ? Type{} : detail::WideRatio<Type>(dividend, divisor));
+		}
+
+		/* compute the intersection point of the plane and the line [l] (invalid if parallel: returns the line origin) */
+		constexpr num::FixedVec<Type> intersect(const num::FixedLine<Type>& l, bool* invalid = 0, Type precision = num::FixedConst<Type>::Precision) const {
+			return l.point(intersectf(l, invalid, precision));
+		}
+
+	public:
+		/* compute the (not normalized) signed distances [(p - o) * normal] of all [points] into [out] (Q16 uses integer AVX2 kernels if available) */
+		void sides(std::span<const num::FixedVec<Type>> points, std::span<Type> out, size_t threads = 0) const;
+	};
+
+	namespace detail {
+#if NUM_DISPATCH_X86
+		/* sum the 64-bit products of the even Q16 lanes and round them once to the fractional bits (in the lower half of the 64-bit lanes) */
+		NUM_TARGET_AVX2 inline __m256i SumQ16(__m256i ax, __m256i ay, __m256i az, __m256i bx, __m256i by, __m256i bz) {
+			const __m256i products = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epi32(ax, bx), _mm256_mul_epi32(ay, by)), _mm256_mul_epi32(az, bz));
+			return _mm256_srli_epi64(_mm256_add_epi64(products, _mm256_set1_epi64x(int64_t(1) << 15)), 16);
+		}
+
+		/* compute the dot products of the Q16 lanes with the same rounding as num::FixedVec::dot */
+		NUM_TARGET_AVX2 inline __m256i DotQ16(__m256i ax, __m256i ay, __m256i az, __m256i bx, __m256i by, __m256i bz) {
+			const __m256i even = detail::SumQ16(ax, ay, az, bx, by, bz);
+			const __m256i odd = detail::SumQ16(_mm256_srli_epi64(ax, 32), _mm256_srli_epi64(ay, 32), _mm256_srli_epi64(az, 32),
+				_mm256_srli_epi64(bx, 32), _mm256_srli_epi64(by, 32), _mm256_srli_epi64(bz, 32));
+			return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xaa);
+		}
+
+		/* load the components of 8 consecutive Q16 vectors */
+		NUM_TARGET_AVX2 inline void LoadQ16(const num::FixedVec<num::Q16>* v, __m256i& x, __m256i& y, __m256i& z) {
+			const __m256i index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+			const int* base = reinterpret_cast<const int*>(v);
+			x = _mm256_i32gather_epi32(base, index, 4);
+			y = _mm256_i32gather_epi32(base + 1, index, 4);
+			z = _mm256_i32gather_epi32(base + 2, index, 4);
+		}
+
+		NUM_TARGET_AVX2 inline size_t DotsQ16(const num::FixedVec<num::Q16>* a, const num::FixedVec<num::Q16>* b, num::Q16* out, size_t count) {
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256i ax, ay, az, bx, by, bz;
+				detail::LoadQ16(a + i, ax, ay, az);
+				detail::LoadQ16(b + i, bx, by, bz);
+				const __m256i dot = detail::DotQ16(ax, ay, az, bx, by, bz);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), dot);
+			}
+			return i;
+		}
+
+		NUM_TARGET_AVX2 inline size_t SidesQ16(const num::FixedVec<num::Q16>& o, const num::FixedVec<num::Q16>& n, const num::FixedVec<num::Q16>* p, num::Q16* out, size_t count) {
+			const __m256i ox = _mm256_set1_epi32(o.x.raw), oy = _mm256_set1_epi32(o.y.raw), oz = _mm256_set1_epi32(o.z.raw);
+			const __m256i nx = _mm256_set1_epi32(n.x.raw), ny = _mm256_set1_epi32(n.y.raw), nz = _mm256_set1_epi32(n.z.raw);
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256i px, py, pz;
+				detail::LoadQ16(p + i, px, py, pz);
+				px = _mm256_sub_epi32(px, ox);
+				py = _mm256_sub_epi32(py, oy);
+				pz = _mm256_sub_epi32(pz, oz);
+				const __m256i dot = detail::DotQ16(px, py, pz, nx, ny, nz);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), dot);
+			}
+			return i;
+		}
+#endif
+	}
+
+	template <num::FixedPoint Type>
+	void num::FixedVec<Type>::Dots(std::span<const num::FixedVec<Type>> a, std::span<const num::FixedVec<Type>> b, std::span<Type> out, size_t threads) {
+		num::Parallel(a.size(), threads, 16384, [&](size_t begin, size_t end, size_t) {
+			size_t i = begin;
+#if NUM_DISPATCH_X86
+			if constexpr (std::is_same_v<Type, num::Q16>) {
+				if (num::ActiveIsa() >= num::IsaAvx2)
+					i += detail::DotsQ16(a.data() + begin, b.data() + begin, out.data() + begin, end - begin);
+			}
+#endif
+			for (; i < end; ++i)
+				out[i] = a[i].dot(b[i]);
+		});
+	}
+
+	template <num::FixedPoint Type>
+	void num::FixedPlane<Type>::sides(std::span<const num::FixedVec<Type>> points, std::span<Type> out, size_t threads) const {
+		const num::FixedVec<Type> n = normal();
+		num::Parallel(points.size(), threads, 16384, [&](size_t begin, size_t end, size_t) {
+			size_t i = begin;
+#if NUM_DISPATCH_X86
+			if constexpr (std::is_same_v<Type, num::Q16>) {
+				if (num::ActiveIsa() >= num::IsaAvx2)
+					i += detail::SidesQ16(o, n, points.data() + begin, out.data() + begin, end - begin);
+			}
+#endif
+			for (; i < end; ++i)
+				out[i] = (points[i] - o).dot(n);
+		});
+	}
+}
@@ -0,0 +1,357 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <bit>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <memory_resource>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-plane.h"
+#include "num-box.h"
+#include "num-sphere.h"
+#include "num-octree.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+namespace num {
+	template <std::floating_point Type>
+	struct Frustum;
+
+	/* structure of arrays of axis aligned boxes, stored as centers and half extents */
+	template <std::floating_point Type>
+	struct BoxSet {
+	private:
+		std::pmr::vector<Type> pCenter[3];
+		std::pmr::vector<Type> pHalf[3];
+
+	public:
+		explicit BoxSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pCenter{ std::pmr::vector<Type>{ resource }, std::pmr::vector<Type>{ resource }, std::pmr::vector<Type>{ resource } },
+			pHalf{ std::pmr::vector<Type>{ resource }, std::pmr::vector<Type>{ resource }, std::pmr::vector<Type>{ resource } } {}
+
+	public:
+		size_t size() const {
+			return pCenter[0].size();
+		}
+		void clear() {
+			for (size_t i = 0; i < 3; ++i) {
+				pCenter[i].clear();
+				pHalf[i].clear();
+			}
+		}
+		void reserve(size_t count) {
+			for (size_t i = 0; i < 3; ++i) {
+				pCenter[i].reserve(count);
+				pHalf[i].reserve(count);
+			}
+		}
+		void push(const num::Box<Type>& b) {
+			const num::Vec<Type> c = b.center(), h = b.size() / 2;
+			for (size_t i = 0; i < 3; ++i) {
+				pCenter[i].push_back(c[i]);
+				pHalf[i].push_back(h[i]);
+			}
+		}
+		void set(size_t index, const num::Box<Type>& b) {
+			const num::Vec<Type> c = b.center(), h = b.size() / 2;
+			for (size_t i = 0; i < 3; ++i) {
+				pCenter[i][index] = c[i];
+				pHalf[i][index] = h[i];
+			}
+		}
+		num::Box<Type> box(size_t index) const {
+			const num::Vec<Type> c{ pCenter[0][index], pCenter[1][index], pCenter[2][index] };
+			const num::Vec<Type> h{ pHalf[0][index], pHalf[1][index], pHalf[2][index] };
+			return num::Box<Type>{ c - h, c + h };
+		}
+
+		/* components of the centers and half extents along the [axis] */
+		const Type* center(size_t axis) const {
+			return pCenter[axis].data();
+		}
+		const Type* half(size_t axis) const {
+			return pHalf[axis].data();
+		}
+	};
+
+	/* structure of arrays of spheres */
+	template <std::floating_point Type>
+	struct SphereSet {
+	private:
+		std::pmr::vector<Type> pCenter[3];
+		std::pmr::vector<Type> pRadius;
+
+	public:
+		explicit SphereSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pCenter{ std::pmr::vector<Type>{ resource }, std::pmr::vector<Type>{ resource }, std::pmr::vector<Type>{ resource } },
+			pRadius{ resource } {}
+
+	public:
+		size_t size() const {
+			return pRadius.size();
+		}
+		void clear() {
+			for (size_t i = 0; i < 3; ++i)
+				pCenter[i].clear();
+			pRadius.clear();
+		}
+		void reserve(size_t count) {
+			for (size_t i = 0; i < 3; ++i)
+				pCenter[i].reserve(count);
+			pRadius.reserve(count);
+		}
+		void push(const num::Sphere<Type>& s) {
+			for (size_t i = 0; i < 3; ++i)
+				pCenter[i].push_back(s.c[i]);
+			pRadius.push_back(s.r);
+		}
+		void set(size_t index, const num::Sphere<Type>& s) {
+			for (size_t i = 0; i < 3; ++i)
+				pCenter[i][index] = s.c[i];
+			pRadius[index] = s.r;
+		}
+		num::Sphere<Type> sphere(size_t index) const {
+			return num::Sphere<Type>{ num::Vec<Type>{ pCenter[0][index], pCenter[1][index], pCenter[2][index] }, pRadius[index] };
+		}
+
+		/* components of the centers along the [axis] and the radii */
+		const Type* center(size_t axis) const {
+			return pCenter[axis].data();
+		}
+		const Type* radius() const {
+			return pRadius.data();
+		}
+	};
+
+	/* reusable output of the bulk culling, which keeps its allocations across frames */
+	struct CullBuffer {
+		template <std::floating_point> friend struct num::Frustum;
+
+	private:
+		std::pmr::vector<uint32_t> pVisible;
+		std::pmr::vector<uint8_t> pFlags;
+		std::pmr::vector<size_t> pCounts;
+
+	public:
+		explicit CullBuffer(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pVisible{ resource }, pFlags{ resource }, pCounts{ resource } {}
+
+	public:
+		/* indices of the visible objects of the last culling in ascending order */
+		std::span<const uint32_t> visible() const {
+			return pVisible;
+		}
+	};
+
+	/*
+	*	Culling of boxes and spheres against up to 32 planes (such as the six planes of a view frustum)
+	*	- the planes are given like for num::Octree::frustum: their normals point outwards, and objects are visible
+	*		if they are not completely in front of any plane (conservative: objects close to edges may remain visible)
+	*	- the normalized normals and offsets of the planes are computed once, instead of once per object and plane
+	*	- the tests take a mask of the planes still to be tested and clear the planes the object lies completely behind,
+	*		such that children of hierarchies only test the planes their parent straddles
+	*	- an optional per-object hint stores the plane, which rejected the object last, and is tested first (plane coherency)
+	*	- the bulk culling evaluates blocks of objects of the structure of arrays plane by plane without branches, such that
+	*		the loops are vectorized by the kernels of the active instruction set
+	*/
+	template <std::floating_point Type>
+	struct Frustum {
+	public:
+		static constexpr size_t MaxPlanes = 32;
+
+	private:
+		static constexpr size_t MinChunk = 16384;
+		static constexpr size_t Block = 256;
+
+	private:
+		Type pNormal[3][MaxPlanes] = {};
+		Type pAbs[3][MaxPlanes] = {};
+		Type pOffset[MaxPlanes] = {};
+		size_t pCount = 0;
+
+	public:
+		constexpr Frustum() = default;
+
+		/* precompute the [planes] (invalid if more than MaxPlanes are given or any plane has no normal: uses the valid planes only) */
+		constexpr Frustum(std::span<const num::Plane<Type>> planes, bool* invalid = 0) {
+			bool failed = (planes.size() > MaxPlanes);
+			for (size_t i = 0; i < planes.size() && pCount < MaxPlanes; ++i) {
+				const num::Vec<Type> n = planes[i].normal();
+				const Type len = n.len();
+				if (!(len > 0)) {
+					failed = true;
+					continue;
+				}
+				for (size_t j = 0; j < 3; ++j) {
+					pNormal[j][pCount] = n[j] / len;
+					pAbs[j][pCount] = num::Abs(pNormal[j][pCount]);
+				}
+				pOffset[pCount++] = planes[i].o.dot(n) / len;
+			}
+			if (invalid)
+				*invalid = failed;
+		}
+
+	private:
+		/* check if the plane [p] rejects the box or sphere of the center [c] and the half extent [h] or radius (clears the plane of [mask] if it is passed) */
+		constexpr bool fRejects(size_t p, const num::Vec<Type>& c, const num::Vec<Type>& h, bool sphere, uint32_t& mask) const {
+			const Type dist = pNormal[0][p] * c.x + pNormal[1][p] * c.y + pNormal[2][p] * c.z - pOffset[p];
+			const Type extent = (sphere ? h.x : pAbs[0][p] * h.x + pAbs[1][p] * h.y + pAbs[2][p] * h.z);
+			if (dist - extent > 0)
+				return true;
+			if (dist + extent <= 0)
+				mask &= ~(uint32_t(1) << p);
+			return false;
+		}
+
+		constexpr bool fTest(const num::Vec<Type>& c, const num::Vec<Type>& h, bool sphere, uint32_t& mask, uint8_t* hint) const {
+			/* test the plane, which rejected the object last, first */
+			if (hint != 0 && *hint > 0 && *hint <= pCount && (mask & (uint32_t(1) << (*hint - 1))) != 0) {
+				if (fRejects(*hint - 1, c, h, sphere, mask))
+					return false;
+			}
+			for (uint32_t m = mask; m != 0; m &= m - 1) {
+				const size_t p = size_t(std::countr_zero(m));
+				if (fRejects(p, c, h, sphere, mask)) {
+					if (hint != 0)
+						*hint = uint8_t(p + 1);
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/* evaluate [visible(i, plane)] for all objects over all planes of the [mask] and write the indices of the visible objects to [out] */
+		template <class Kernel>
+		size_t fCull(size_t count, num::CullBuffer& out, uint32_t mask, size_t threads, const Kernel& kernel) const {
+			out.pFlags.resize(count);
+			out.pCounts.assign(num::ParallelChunks(count, threads, MinChunk), 0);
+			mask &= all();
+
+			/* flag the visible objects block by block and plane by plane */
+			uint8_t* flags = out.pFlags.data();
+			num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				out.pCounts[chunk] = num::Dispatch([&](size_t begin, size_t end) NUM_KERNEL {
+					/* accumulate the block in a local array, as stores to the byte flags could alias the captured arrays */
+					uint32_t keep[Block];
+					size_t visible = 0;
+					for (size_t b = begin; b < end; b += Block) {
+						const size_t size = std::min(Block, end - b);
+						for (size_t i = 0; i < size; ++i)
+							keep[i] = 1;
+						for (uint32_t m = mask; m != 0; m &= m - 1) {
+							const size_t p = size_t(std::countr_zero(m));
+							for (size_t i = 0; i < size; ++i)
+								keep[i] &= uint32_t(kernel(b + i, p));
+						}
+						for (size_t i = 0; i < size; ++i) {
+							flags[b + i] = uint8_t(keep[i]);
+							visible += keep[i];
+						}
+					}
+					return visible;
+				}, begin, end);
+			});
+
+			/* compact the flags to the indices at the offsets of the chunks (the counts are replaced by their offsets) */
+			size_t total = 0;
+			for (size_t& offset : out.pCounts) {
+				const size_t visible = offset;
+				offset = total;
+				total += visible;
+			}
+			out.pVisible.resize(total);
+			num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				uint32_t* dest = out.pVisible.data() + out.pCounts[chunk];
+				for (size_t i = begin; i < end; ++i) {
+					if (flags[i] != 0)
+						*(dest++) = uint32_t(i);
+				}
+			});
+			return total;
+		}
+
+	public:
+		/* number of planes used by the frustum */
+		constexpr size_t planes() const {
+			return pCount;
+		}
+
+		/* mask of all planes used by the frustum */
+		constexpr uint32_t all() const {
+			return (pCount >= 32 ? ~uint32_t(0) : (uint32_t(1) << pCount) - 1);
+		}
+
+		/* check if the box [b] is visible, while only testing the planes of the [mask] and clearing the planes it lies completely behind
+		*	([hint] optionally stores the last rejecting plane of the object) */
+		constexpr bool test(const num::Box<Type>& b, uint32_t& mask, uint8_t* hint = 0) const {
+			return fTest(b.center(), b.size() / 2, false, mask, hint);
+		}
+
+		/* check if the sphere [s] is visible, while only testing the planes of the [mask] and clearing the planes it lies completely behind
+		*	([hint] optionally stores the last rejecting plane of the object) */
+		constexpr bool test(const num::Sphere<Type>& s, uint32_t& mask, uint8_t* hint = 0) const {
+			return fTest(s.c, num::Vec<Type>{ s.r }, true, mask, hint);
+		}
+
+		/* check if the box [b] is visible */
+		constexpr bool visible(const num::Box<Type>& b) const {
+			uint32_t mask = all();
+			return test(b, mask);
+		}
+
+		/* check if the sphere [s] is visible */
+		constexpr bool visible(const num::Sphere<Type>& s) const {
+			uint32_t mask = all();
+			return test(s, mask);
+		}
+
+	public:
+		/* collect the indices of all visible [boxes] into [out], while only testing the planes of the [mask] (returns the number of visible boxes) */
+		size_t cull(const num::BoxSet<Type>& boxes, num::CullBuffer& out, uint32_t mask = ~uint32_t(0), size_t threads = 0) const {
+			const Type* cx = boxes.center(0), * cy = boxes.center(1), * cz = boxes.center(2);
+			const Type* hx = boxes.half(0), * hy = boxes.half(1), * hz = boxes.half(2);
+			return fCull(boxes.size(), out, mask, threads, [&](size_t i, size_t p) NUM_KERNEL {
+				const Type dist = pNormal[0][p] * cx[i] + pNormal[1][p] * cy[i] + pNormal[2][p] * cz[i] - pOffset[p];
+				const Type extent = pAbs[0][p] * hx[i] + pAbs[1][p] * hy[i] + pAbs[2][p] * hz[i];
+				return (dist - extent <= 0);
+			});
+		}
+
+		/* collect the indices of all visible [spheres] into [out], while only testing the planes of the [mask] (returns the number of visible spheres) */
+		size_t cull(const num::SphereSet<Type>& spheres, num::CullBuffer& out, uint32_t mask = ~uint32_t(0), size_t threads = 0) const {
+			const Type* cx = spheres.center(0), * cy = spheres.center(1), * cz = spheres.center(2), * r = spheres.radius();
+			return fCull(spheres.size(), out, mask, threads, [&](size_t i, size_t p) NUM_KERNEL {
+				const Type dist = pNormal[0][p] * cx[i] + pNormal[1][p] * cy[i] + pNormal[2][p] * cz[i] - pOffset[p];
+				return (dist - r[i] <= 0);
+			});
+		}
+
+		/* collect the visible nodes of the [tree] at the [level] or leaves above it into [out], while testing children only against the
+		*	planes their parent straddles ([hints] optionally holds one plane coherency hint per node, which is kept across calls) */
+		void collect(const num::Octree<Type>& tree, uint32_t level, std::vector<size_t>& out, std::span<uint8_t> hints = {}) const {
+			out.clear();
+			std::span<const num::OctreeNode<Type>> nodes = tree.nodes();
+			if (nodes.empty())
+				return;
+
+			/* the depth-first traversal holds at most the siblings of every level on the stack */
+			std::pair<size_t, uint32_t> stack[8 * (num::CurveBits + 2)];
+			size_t size = 0;
+			stack[size++] = { 0, all() };
+			while (size > 0) {
+				auto [index, mask] = stack[--size];
+				const num::OctreeNode<Type>& node = nodes[index];
+				if (mask != 0 && !test(node.bounds, mask, hints.empty() ? 0 : &hints[index]))
+					continue;
+				if (node.leaf() || node.level >= level) {
+					out.push_back(index);
+					continue;
+				}
+				for (size_t i = node.children; i > 0; --i)
+					stack[size++] = { size_t(node.child + i - 1), mask };
+			}
+		}
+	};
+}
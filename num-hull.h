@@ -0,0 +1,407 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <vector>
+#include <memory_resource>
+#include <limits>
+#include <type_traits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+
+namespace num {
+	/*
+	*	Convex hull of a set of points computed by the quickhull algorithm
+	*	- faces are produced as planes [p0:(p1-p0):(p2-p0)], which are oriented counterclockwise
+	*		when viewed from the outside, i.e. [num::Plane::normal] points away from the hull
+	*	- all internal buffers are allocated from the given memory resource and kept across builds,
+	*		thereby repeated builds of similar size do not allocate
+	*	- facet normals and distances are evaluated in a wider type than [Type], and points are only considered to lie on
+	*		a face within the rounding error of the wider type (a coarser tolerance would allow concave edges to build up)
+	*/
+	template <std::floating_point Type>
+	struct Hull {
+	private:
+		static constexpr size_t None = size_t(-1);
+		static constexpr uint8_t Unassigned = 0xff;
+		static constexpr size_t MinChunk = 4096;
+		using Wide = std::conditional_t<(sizeof(Type) < sizeof(double)), double, long double>;
+		static constexpr Wide Tolerance = std::numeric_limits<Wide>::epsilon() * 64;
+
+		struct Facet {
+			num::Vec<Wide> n;
+			Wide d = 0;
+			size_t v[3] = { 0, 0, 0 };
+			size_t adj[3] = { None, None, None };
+			size_t outside = None;
+			size_t furthest = None;
+			Wide furthestDist = 0;
+			size_t visited = 0;
+			bool alive = false;
+		};
+		struct Step {
+			size_t face = 0;
+			size_t edge = 0;
+			size_t k = 0;
+		};
+		struct Extreme {
+			size_t index = None;
+			Wide value = 0;
+		};
+
+	private:
+		std::span<const num::Vec<Type>> pPoints;
+		std::pmr::vector<Facet> pFacets;
+		std::pmr::vector<size_t> pNext;
+		std::pmr::vector<Wide> pDist;
+		std::pmr::vector<uint8_t> pAssign;
+		std::pmr::vector<Extreme> pExtremes;
+		std::pmr::vector<size_t> pFree;
+		std::pmr::vector<size_t> pPending;
+		std::pmr::vector<Step> pStack;
+		std::pmr::vector<size_t> pHorizon;
+		std::pmr::vector<size_t> pVisible;
+		std::pmr::vector<size_t> pCreated;
+		std::pmr::vector<num::Plane<Type>> pPlanes;
+		std::pmr::vector<size_t> pIndices;
+		Wide pEpsilon = 0;
+		size_t pStamp = 0;
+
+	public:
+		explicit Hull(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pFacets{ resource }, pNext{ resource }, pDist{ resource },
+			pAssign{ resource }, pExtremes{ resource }, pFree{ resource }, pPending{ resource }, pStack{ resource }, pHorizon{ resource },
+			pVisible{ resource }, pCreated{ resource }, pPlanes{ resource }, pIndices{ resource } {}
+
+	private:
+		/* compute the signed distance of point [p] to the facet [f] */
+		constexpr Wide fDistance(size_t f, const num::Vec<Type>& p) const {
+			return pFacets[f].n.dot(fWiden(p)) - pFacets[f].d;
+		}
+
+		/* convert the point [p] to the wider type used for all facet computations */
+		static constexpr num::Vec<Wide> fWiden(const num::Vec<Type>& p) {
+			return num::Vec<Wide>{ Wide(p.x), Wide(p.y), Wide(p.z) };
+		}
+
+		/* create a new facet [a:b:c] (counterclockwise when viewed from the outside) */
+		size_t fMakeFacet(size_t a, size_t b, size_t c) {
+			size_t index = 0;
+			if (pFree.empty()) {
+				index = pFacets.size();
+				pFacets.emplace_back();
+			}
+			else {
+				index = pFree.back();
+				pFree.pop_back();
+				pFacets[index] = Facet{};
+			}
+
+			/* compute the normalized outwards pointing normal and the offset of the facet */
+			Facet& facet = pFacets[index];
+			const num::Plane<Wide> plane = fWiden(pPoints[a]).plane(fWiden(pPoints[b]), fWiden(pPoints[c]));
+			const num::Vec<Wide> normal = plane.normal();
+			const Wide len = normal.len();
+			facet.n = (len > 0 ? normal / len : num::Vec<Wide>{});
+			facet.d = facet.n.dot(plane.o);
+			facet.v[0] = a;
+			facet.v[1] = b;
+			facet.v[2] = c;
+			facet.alive = true;
+			return index;
+		}
+
+		/* add the point [p] with the distance [dist] to the outside set of facet [f] */
+		void fAddOutside(size_t f, size_t p, Wide dist) {
+			Facet& facet = pFacets[f];
+			pNext[p] = facet.outside;
+			facet.outside = p;
+			if (facet.furthest == None || dist > facet.furthestDist) {
+				facet.furthest = p;
+				facet.furthestDist = dist;
+			}
+		}
+
+		/* find the point with the largest [fn(p)] value in parallel */
+		template <class Fn>
+		Extreme fArgMax(size_t threads, Fn&& fn) {
+			pExtremes.assign(num::ParallelChunks(pPoints.size(), threads, MinChunk), Extreme{});
+			num::Parallel(pPoints.size(), threads, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				Extreme best;
+				for (size_t i = begin; i < end; ++i) {
+					const Wide value = fn(fWiden(pPoints[i]));
+					if (best.index == None || value > best.value)
+						best = Extreme{ i, value };
+				}
+				pExtremes[chunk] = best;
+			});
+
+			/* merge the results of the separate chunks in order to be independent of the thread count */
+			Extreme best;
+			for (const Extreme& extreme : pExtremes) {
+				if (extreme.index != None && (best.index == None || extreme.value > best.value))
+					best = extreme;
+			}
+			return best;
+		}
+
+		/* setup the initial tetrahedron and return false if the points are degenerate */
+		bool fSimplex(size_t threads) {
+			/* find the extreme points along the axes and the magnitude of the point set */
+			size_t ext[6] = { 0, 0, 0, 0, 0, 0 };
+			Wide scale = 0;
+			for (size_t i = 0; i < pPoints.size(); ++i) {
+				for (size_t c = 0; c < 3; ++c) {
+					if (pPoints[i][c] < pPoints[ext[c * 2]][c])
+						ext[c * 2] = i;
+					if (pPoints[i][c] > pPoints[ext[c * 2 + 1]][c])
+						ext[c * 2 + 1] = i;
+					scale = std::max(scale, num::Abs(Wide(pPoints[i][c])));
+				}
+			}
+			pEpsilon = std::max<Wide>(scale, 1) * Tolerance;
+
+			/* select the axis with the largest extent as first edge */
+			size_t i0 = ext[0], i1 = ext[1];
+			for (size_t c = 1; c < 3; ++c) {
+				if ((pPoints[ext[c * 2 + 1]] - pPoints[ext[c * 2]]).lenSquared() > (pPoints[i1] - pPoints[i0]).lenSquared()) {
+					i0 = ext[c * 2];
+					i1 = ext[c * 2 + 1];
+				}
+			}
+			const num::Line<Wide> edge = fWiden(pPoints[i0]).line(fWiden(pPoints[i1]));
+			if (edge.d.len() <= pEpsilon)
+				return false;
+
+			/* select the point furthest away from the first edge */
+			const Extreme e2 = fArgMax(threads, [&](const num::Vec<Wide>& p) { return edge.closest(p).lenSquared(); });
+			if (std::sqrt(e2.value) <= pEpsilon)
+				return false;
+			size_t i2 = e2.index;
+
+			/* select the point furthest away from the base triangle */
+			const num::Vec<Wide> normal = fWiden(pPoints[i0]).plane(fWiden(pPoints[i1]), fWiden(pPoints[i2])).normal().norm();
+			const Wide offset = normal.dot(fWiden(pPoints[i0]));
+			const Extreme e3 = fArgMax(threads, [&](const num::Vec<Wide>& p) { return num::Abs(normal.dot(p) - offset); });
+			if (e3.value <= pEpsilon)
+				return false;
+			const size_t i3 = e3.index;
+
+			/* orient the base triangle such that the last point lies below it */
+			if (normal.dot(fWiden(pPoints[i3])) - offset > 0)
+				std::swap(i1, i2);
+
+			/* create the facets of the tetrahedron and link them together */
+			pCreated.clear();
+			pCreated.push_back(fMakeFacet(i0, i1, i2));
+			pCreated.push_back(fMakeFacet(i0, i3, i1));
+			pCreated.push_back(fMakeFacet(i1, i3, i2));
+			pCreated.push_back(fMakeFacet(i2, i3, i0));
+			for (size_t f : pCreated) {
+				for (size_t e = 0; e < 3; ++e) {
+					const size_t a = pFacets[f].v[e], b = pFacets[f].v[(e + 1) % 3];
+					for (size_t g : pCreated) {
+						for (size_t k = 0; k < 3; ++k) {
+							if (pFacets[g].v[k] == b && pFacets[g].v[(k + 1) % 3] == a)
+								pFacets[f].adj[e] = g;
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		/* assign all points to the outside sets of the tetrahedron (distances are computed in parallel) */
+		void fPartition(size_t threads) {
+			pAssign.resize(pPoints.size());
+			pDist.resize(pPoints.size());
+			pNext.assign(pPoints.size(), None);
+
+			num::Parallel(pPoints.size(), threads, MinChunk, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i) {
+					uint8_t best = Unassigned;
+					Wide bestDist = pEpsilon;
+					for (size_t f = 0; f < 4; ++f) {
+						const Wide dist = fDistance(pCreated[f], pPoints[i]);
+						if (dist > bestDist) {
+							best = uint8_t(f);
+							bestDist = dist;
+						}
+					}
+					pAssign[i] = best;
+					pDist[i] = bestDist;
+				}
+			});
+
+			/* link the points in order to keep the result independent of the thread count */
+			for (size_t i = 0; i < pPoints.size(); ++i) {
+				if (pAssign[i] != Unassigned)
+					fAddOutside(pCreated[pAssign[i]], i, pDist[i]);
+			}
+		}
+
+		/* collect the visible facets from the eye point and the horizon edges in counterclockwise order */
+		void fHorizon(size_t start, const num::Vec<Type>& eye) {
+			pVisible.clear();
+			pHorizon.clear();
+			pStack.clear();
+
+			++pStamp;
+			pFacets[start].visited = pStamp;
+			pVisible.push_back(start);
+			pStack.push_back(Step{ start, 0, 0 });
+
+			/* depth-first traversal across the edges, which yields the horizon as a closed loop */
+			while (!pStack.empty()) {
+				Step& step = pStack.back();
+				if (step.k == 3) {
+					pStack.pop_back();
+					continue;
+				}
+				const size_t face = step.face;
+				const size_t edge = (step.edge + step.k++) % 3;
+				const size_t next = pFacets[face].adj[edge];
+				if (pFacets[next].visited == pStamp)
+					continue;
+
+				/* check if the neighbor is visible as well, or if the edge is part of the horizon */
+				if (fDistance(next, eye) > pEpsilon) {
+					pFacets[next].visited = pStamp;
+					pVisible.push_back(next);
+					size_t back = 0;
+					while (pFacets[next].adj[back] != face)
+						++back;
+					pStack.push_back(Step{ next, back + 1, 0 });
+				}
+				else {
+					pHorizon.push_back(face);
+					pHorizon.push_back(edge);
+				}
+			}
+		}
+
+		/* add the point [eye] of facet [f] to the hull */
+		void fExpand(size_t f) {
+			const size_t eye = pFacets[f].furthest;
+			fHorizon(f, pPoints[eye]);
+
+			/* create the new facets along the horizon */
+			pCreated.clear();
+			for (size_t i = 0; i < pHorizon.size(); i += 2) {
+				const size_t face = pHorizon[i], edge = pHorizon[i + 1];
+				const size_t a = pFacets[face].v[edge], b = pFacets[face].v[(edge + 1) % 3];
+				const size_t neighbor = pFacets[face].adj[edge];
+				const size_t created = fMakeFacet(a, b, eye);
+
+				/* link the new facet to the remaining neighbor across the horizon */
+				pFacets[created].adj[0] = neighbor;
+				for (size_t k = 0; k < 3; ++k) {
+					if (pFacets[neighbor].adj[k] == face && pFacets[neighbor].v[k] == b)
+						pFacets[neighbor].adj[k] = created;
+				}
+				pCreated.push_back(created);
+			}
+
+			/* link the new facets among each other (the horizon forms a closed loop) */
+			for (size_t i = 0; i < pCreated.size(); ++i) {
+				const size_t next = pCreated[(i + 1) % pCreated.size()];
+				pFacets[pCreated[i]].adj[1] = next;
+				pFacets[next].adj[2] = pCreated[i];
+			}
+
+			/* reassign the outside points of the visible facets and release the facets */
+			for (size_t face : pVisible) {
+				for (size_t p = pFacets[face].outside; p != None;) {
+					const size_t next = pNext[p];
+					if (p != eye) {
+						size_t best = None;
+						Wide bestDist = pEpsilon;
+						for (size_t created : pCreated) {
+							const Wide dist = fDistance(created, pPoints[p]);
+							if (dist > bestDist) {
+								best = created;
+								bestDist = dist;
+							}
+						}
+						if (best != None)
+							fAddOutside(best, p, bestDist);
+					}
+					p = next;
+				}
+				pFacets[face].alive = false;
+				pFacets[face].outside = None;
+				pFree.push_back(face);
+			}
+
+			/* register the new facets, which still have outside points, to be processed */
+			for (size_t created : pCreated) {
+				if (pFacets[created].outside != None)
+					pPending.push_back(created);
+			}
+		}
+
+	public:
+		/* compute the convex hull of the [points] (returns false and produces an empty hull if the points do not span a volume) */
+		bool build(std::span<const num::Vec<Type>> points, size_t threads = 0) {
+			pPoints = points;
+			pFacets.clear();
+			pFree.clear();
+			pPending.clear();
+			pPlanes.clear();
+			pIndices.clear();
+			pStamp = 0;
+
+			/* setup the initial tetrahedron and distribute the points */
+			if (pPoints.size() < 4 || !fSimplex(threads))
+				return false;
+			fPartition(threads);
+			for (size_t f : pCreated) {
+				if (pFacets[f].outside != None)
+					pPending.push_back(f);
+			}
+
+			/* expand the hull until no facet has any points outside of it */
+			while (!pPending.empty()) {
+				const size_t f = pPending.back();
+				pPending.pop_back();
+				if (pFacets[f].alive && pFacets[f].outside != None)
+					fExpand(f);
+			}
+
+			/* produce the resulting faces */
+			for (const Facet& facet : pFacets) {
+				if (!facet.alive)
+					continue;
+				pIndices.insert(pIndices.end(), facet.v, facet.v + 3);
+				pPlanes.push_back(pPoints[facet.v[0]].plane(pPoints[facet.v[1]], pPoints[facet.v[2]]));
+			}
+			return true;
+		}
+
+		/* faces of the hull of the last build (normals point outwards) */
+		const std::pmr::vector<num::Plane<Type>>& faces() const {
+			return pPlanes;
+		}
+
+		/* indices into the points of the last build, with three consecutive indices per face (same order as [faces]) */
+		const std::pmr::vector<size_t>& indices() const {
+			return pIndices;
+		}
+
+		/* check if the point [p] lies within or on the hull of the last build */
+		bool contains(const num::Vec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			if (pPlanes.empty())
+				return false;
+			for (const num::Plane<Type>& face : pPlanes) {
+				const num::Vec<Type> normal = face.normal();
+				if (normal.dot(p - face.o) > precision * normal.len() * std::max<Type>(1, (p - face.o).len()))
+					return false;
+			}
+			return true;
+		}
+	};
+}
@@ -0,0 +1,362 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <bit>
+#include <span>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <memory_resource>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-plane.h"
+#include "num-transform.h"
+#include "num-parallel.h"
+#include "num-reduce.h"
+#include "num-fit.h"
+#include "num-octree.h"
+
+namespace num {
+	/* error metric minimized by the registration */
+	enum IcpMetric : uint8_t {
+		IcpPointToPoint = 0,
+		IcpPointToPlane = 1,
+	};
+
+	/* result of a registration: [transform] maps the source onto the target and is a rotation by [angles] in degrees
+	*	(applied as rotateX, rotateY, and rotateZ in that order) followed by the translation [transform.t] */
+	template <std::floating_point Type>
+	struct IcpResult {
+		num::Transform<Type> transform;
+		num::Vec<Type> angles;
+		Type error = 0;
+		size_t pairs = 0;
+		size_t iterations = 0;
+		bool converged = false;
+	};
+
+	namespace detail {
+		/* sums of the correspondences of one point-to-point iteration (relative to a reference point) */
+		template <std::floating_point Type>
+		struct IcpPointSums {
+			num::Vec<Type> p;
+			num::Vec<Type> q;
+			num::Vec<Type> cross[3];
+			Type squared = 0;
+			size_t count = 0;
+		};
+
+		/* normal equations of the correspondences of one point-to-plane iteration (upper triangle of the 6x6 matrix) */
+		template <std::floating_point Type>
+		struct IcpPlaneSums {
+			Type ata[21] = {};
+			Type atb[6] = {};
+			Type squared = 0;
+			size_t count = 0;
+		};
+
+		/* compute the eigenvector of the largest eigenvalue of the symmetric matrix [m] by cyclic jacobi rotations (destroys [m]) */
+		template <std::floating_point Type>
+		constexpr void LargestEigenvector4(Type(&m)[4][4], Type(&out)[4]) {
+			Type v[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+			for (size_t sweep = 0; sweep < 64; ++sweep) {
+				Type off = 0, diag = 0;
+				for (size_t i = 0; i < 4; ++i) {
+					diag += m[i][i] * m[i][i];
+					for (size_t j = i + 1; j < 4; ++j)
+						off += m[i][j] * m[i][j];
+				}
+				if (off <= diag * std::numeric_limits<Type>::epsilon() * std::numeric_limits<Type>::epsilon())
+					break;
+
+				for (size_t p = 0; p < 4; ++p) {
+					for (size_t q = p + 1; q < 4; ++q) {
+						if (m[p][q] == 0)
+							continue;
+						const Type theta = (m[q][q] - m[p][p]) / (2 * m[p][q]);
+						const Type t = (theta >= 0 ? 1 : -1) / (num::Abs(theta) + num::Sqrt(theta * theta + 1));
+						const Type c = 1 / num::Sqrt(t * t + 1), s = t * c;
+						for (size_t k = 0; k < 4; ++k) {
+							const Type a = m[k][p], b = m[k][q];
+							m[k][p] = c * a - s * b;
+							m[k][q] = s * a + c * b;
+						}
+						for (size_t k = 0; k < 4; ++k) {
+							const Type a = m[p][k], b = m[q][k];
+							m[p][k] = c * a - s * b;
+							m[q][k] = s * a + c * b;
+						}
+						for (size_t k = 0; k < 4; ++k) {
+							const Type a = v[k][p], b = v[k][q];
+							v[k][p] = c * a - s * b;
+							v[k][q] = s * a + c * b;
+						}
+					}
+				}
+			}
+
+			size_t largest = 0;
+			for (size_t i = 1; i < 4; ++i) {
+				if (m[i][i] > m[largest][largest])
+					largest = i;
+			}
+			for (size_t i = 0; i < 4; ++i)
+				out[i] = v[i][largest];
+		}
+
+		/* solve the linear system [m] * x = [b] by gaussian elimination with partial pivoting (false if singular) */
+		template <std::floating_point Type>
+		constexpr bool Solve6(Type(&m)[6][6], Type(&b)[6], Type(&x)[6]) {
+			for (size_t c = 0; c < 6; ++c) {
+				size_t pivot = c;
+				for (size_t r = c + 1; r < 6; ++r) {
+					if (num::Abs(m[r][c]) > num::Abs(m[pivot][c]))
+						pivot = r;
+				}
+				if (!(num::Abs(m[pivot][c]) > 0))
+					return false;
+				std::swap(m[c], m[pivot]);
+				std::swap(b[c], b[pivot]);
+				for (size_t r = c + 1; r < 6; ++r) {
+					const Type f = m[r][c] / m[c][c];
+					for (size_t k = c; k < 6; ++k)
+						m[r][k] -= f * m[c][k];
+					b[r] -= f * b[c];
+				}
+			}
+			for (size_t c = 6; c-- > 0;) {
+				Type sum = b[c];
+				for (size_t k = c + 1; k < 6; ++k)
+					sum -= m[c][k] * x[k];
+				x[c] = sum / m[c][c];
+			}
+			return true;
+		}
+	}
+
+	/*
+	*	Rigid registration of num::Vec clouds by the iterative closest point algorithm
+	*	- the target cloud is indexed once by a num::Octree for the correspondence search, and its normals are estimated
+	*		by the best-fit num::Plane of the nearest neighbors of every point
+	*	- point-to-point iterations solve the optimal rotation in closed form (Horn, unit quaternions), point-to-plane
+	*		iterations solve the linearized problem (Low, small angles) and converge faster on smooth surfaces
+	*	- correspondences further apart than [maxDistance] are rejected, and the iterations stop early once the rotation
+	*		of an update is below [tolerance] in radians and the translation of the target centroid below [tolerance]
+	*	- the correspondence search and the reductions run in parallel and the result is bitwise reproducible
+	*		for any number of threads
+	*/
+	template <std::floating_point Type>
+	struct Icp {
+	private:
+		std::pmr::vector<num::Vec<Type>> pTarget;
+		std::pmr::vector<num::Vec<Type>> pNormals;
+		num::Octree<Type> pTree;
+		num::Vec<Type> pCenter;
+
+	public:
+		explicit Icp(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pTarget{ resource }, pNormals{ resource }, pTree{ resource } {}
+
+	private:
+		/* compute the update of a point-to-point iteration (false if the correspondences are insufficient) */
+		bool fPointUpdate(const detail::IcpPointSums<Type>& sums, num::Transform<Type>& update, Type& angle) const {
+			if (sums.count < 3)
+				return false;
+
+			/* cross-covariance S[a][b] = sum((p - mp)[a] * (q - mq)[b]) */
+			const Type n = Type(sums.count);
+			const num::Vec<Type> mp = sums.p / n, mq = sums.q / n;
+			Type s[3][3] = {};
+			for (size_t a = 0; a < 3; ++a) {
+				for (size_t b = 0; b < 3; ++b)
+					s[a][b] = sums.cross[a][b] - n * mp[a] * mq[b];
+			}
+
+			/* the optimal rotation is the eigenvector of the largest eigenvalue of the symmetric 4x4 matrix N (Horn) */
+			Type m[4][4] = {
+				{ s[0][0] + s[1][1] + s[2][2], s[1][2] - s[2][1], s[2][0] - s[0][2], s[0][1] - s[1][0] },
+				{ s[1][2] - s[2][1], s[0][0] - s[1][1] - s[2][2], s[0][1] + s[1][0], s[2][0] + s[0][2] },
+				{ s[2][0] - s[0][2], s[0][1] + s[1][0], s[1][1] - s[0][0] - s[2][2], s[1][2] + s[2][1] },
+				{ s[0][1] - s[1][0], s[2][0] + s[0][2], s[1][2] + s[2][1], s[2][2] - s[0][0] - s[1][1] }
+			};
+			Type q[4] = {};
+			detail::LargestEigenvector4(m, q);
+			const Type len = num::Sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+			if (!(len > 0))
+				return false;
+			const Type w = q[0] / len, x = q[1] / len, y = q[2] / len, z = q[3] / len;
+
+			update = num::Transform<Type>{
+				num::Vec<Type>{ 1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y) },
+				num::Vec<Type>{ 2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x) },
+				num::Vec<Type>{ 2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y) }
+			};
+			update.t = (mq + pCenter) - update.direction(mp + pCenter);
+			angle = 2 * num::Atan2(num::Sqrt(x * x + y * y + z * z), num::Abs(w));
+			return true;
+		}
+
+		/* compute the update of a point-to-plane iteration (false if the correspondences are insufficient) */
+		bool fPlaneUpdate(const detail::IcpPlaneSums<Type>& sums, num::Transform<Type>& update, Type& angle) const {
+			if (sums.count < 6)
+				return false;
+
+			/* expand the normal equations and dampen them slightly, as translations along flat surfaces are undetermined */
+			Type m[6][6] = {}, b[6] = {}, x[6] = {}, trace = 0;
+			for (size_t r = 0, k = 0; r < 6; ++r) {
+				for (size_t c = r; c < 6; ++c, ++k)
+					m[r][c] = m[c][r] = sums.ata[k];
+				b[r] = sums.atb[r];
+				trace += m[r][r];
+			}
+			for (size_t r = 0; r < 6; ++r)
+				m[r][r] += trace * num::Const<Type>::Precision;
+			if (!detail::Solve6(m, b, x))
+				return false;
+
+			/* apply the small rotation [x[0..2]] around the target centroid followed by the translation [x[3..5]] */
+			const num::Vec<Type> omega{ x[0], x[1], x[2] }, shift{ x[3], x[4], x[5] };
+			angle = omega.len();
+			update = (angle > 0 ? num::Transform<Type>::Rotate(omega, num::ToDegree(angle)) : num::Transform<Type>{});
+			update.t = pCenter + shift - update.direction(pCenter);
+			return true;
+		}
+
+	public:
+		/* set the [points] of the target cloud (copied) and estimate their normals from the [neighbors] nearest points */
+		void target(std::span<const num::Vec<Type>> points, size_t neighbors = 8, size_t threads = 0) {
+			pTarget.assign(points.begin(), points.end());
+			pNormals.assign(points.size(), num::Vec<Type>{});
+			pCenter = num::Centroid(points, threads);
+
+			/* choose the depth such that the leaves hold a few points on average */
+			const uint32_t depth = std::clamp<uint32_t>(uint32_t(std::bit_width(points.size()) + 2) / 3, 1, 10);
+			pTree.build(points, depth, threads);
+
+			/* points without a well-defined plane among their neighbors keep a zero normal and are ignored by point-to-plane */
+			neighbors = std::max<size_t>(neighbors, 3);
+			num::Parallel(points.size(), threads, 1024, [&](size_t begin, size_t end, size_t) {
+				std::vector<size_t> near;
+				for (size_t i = begin; i < end; ++i) {
+					pTree.nearest(pTarget, pTarget[i], neighbors, near);
+					num::Moments<Type> moments;
+					for (size_t j : near)
+						moments.add(pTarget[j]);
+					bool invalid = false;
+					const num::Plane<Type> plane = moments.plane(&invalid);
+					if (!invalid)
+						pNormals[i] = plane.normal().norm();
+				}
+			});
+		}
+
+		/* points of the target cloud */
+		std::span<const num::Vec<Type>> points() const {
+			return pTarget;
+		}
+
+		/* estimated unit normals of the target cloud (zero if undetermined) */
+		std::span<const num::Vec<Type>> normals() const {
+			return pNormals;
+		}
+
+		/* register the [source] cloud onto the target cloud with the [metric], starting from the [initial] transformation */
+		num::IcpResult<Type> align(std::span<const num::Vec<Type>> source, num::IcpMetric metric = num::IcpPointToPlane, const num::Transform<Type>& initial = num::Transform<Type>{},
+			size_t iterations = 50, Type maxDistance = std::numeric_limits<Type>::infinity(), Type tolerance = num::Const<Type>::Precision, size_t threads = 0) const {
+			num::IcpResult<Type> out;
+			out.transform = initial;
+			const Type maxSquared = maxDistance * maxDistance;
+
+			while (out.iterations < iterations && !pTarget.empty()) {
+				const num::Transform<Type> current = out.transform;
+				num::Transform<Type> update;
+				Type angle = 0, squared = 0;
+				size_t count = 0;
+				bool valid = false;
+
+				/* find the correspondences and reduce them to the update in a reproducible order */
+				if (metric == num::IcpPointToPoint) {
+					using Sums = detail::IcpPointSums<Type>;
+					const Sums sums = detail::Reduce(source.size(), threads, Sums{}, [&](size_t i) {
+						Sums s;
+						const num::Vec<Type> p = current.point(source[i]);
+						const num::Vec<Type>& q = pTarget[pTree.nearest(pTarget, p)];
+						const Type dist = (q - p).lenSquared();
+						if (!(dist <= maxSquared))
+							return s;
+						const num::Vec<Type> pc = p - pCenter, qc = q - pCenter;
+						s.p = pc;
+						s.q = qc;
+						for (size_t a = 0; a < 3; ++a)
+							s.cross[a] = qc * pc[a];
+						s.squared = dist;
+						s.count = 1;
+						return s;
+					}, [](const Sums& a, const Sums& b) {
+						Sums s;
+						s.p = a.p + b.p;
+						s.q = a.q + b.q;
+						for (size_t i = 0; i < 3; ++i)
+							s.cross[i] = a.cross[i] + b.cross[i];
+						s.squared = a.squared + b.squared;
+						s.count = a.count + b.count;
+						return s;
+					});
+					count = sums.count;
+					squared = sums.squared;
+					valid = fPointUpdate(sums, update, angle);
+				}
+				else {
+					using Sums = detail::IcpPlaneSums<Type>;
+					const Sums sums = detail::Reduce(source.size(), threads, Sums{}, [&](size_t i) {
+						Sums s;
+						const num::Vec<Type> p = current.point(source[i]);
+						const size_t index = pTree.nearest(pTarget, p);
+						const num::Vec<Type>& q = pTarget[index], & n = pNormals[index];
+						if (!((q - p).lenSquared() <= maxSquared) || n.lenSquared() == 0)
+							return s;
+
+						/* residual r = (p - q) * n, linearized: r + omega * ((p - c) x n) + t * n */
+						const num::Vec<Type> a = (p - pCenter).cross(n);
+						const Type row[6] = { a.x, a.y, a.z, n.x, n.y, n.z };
+						const Type r = (p - q).dot(n);
+						for (size_t j = 0, k = 0; j < 6; ++j) {
+							for (size_t l = j; l < 6; ++l, ++k)
+								s.ata[k] = row[j] * row[l];
+							s.atb[j] = -row[j] * r;
+						}
+						s.squared = r * r;
+						s.count = 1;
+						return s;
+					}, [](const Sums& a, const Sums& b) {
+						Sums s;
+						for (size_t i = 0; i < 21; ++i)
+							s.ata[i] = a.ata[i] + b.ata[i];
+						for (size_t i = 0; i < 6; ++i)
+							s.atb[i] = a.atb[i] + b.atb[i];
+						s.squared = a.squared + b.squared;
+						s.count = a.count + b.count;
+						return s;
+					});
+					count = sums.count;
+					squared = sums.squared;
+					valid = fPlaneUpdate(sums, update, angle);
+				}
+
+				out.pairs = count;
+				out.error = (count > 0 ? num::Sqrt(squared / Type(count)) : 0);
+				if (!valid)
+					break;
+				out.transform = update * current;
+				++out.iterations;
+				if (angle <= tolerance && (update.point(pCenter) - pCenter).len() <= tolerance) {
+					out.converged = true;
+					break;
+				}
+			}
+			out.angles = out.transform.angles();
+			return out;
+		}
+	};
+}
@@ -0,0 +1,315 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <bit>
+#include <limits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-box.h"
+
+namespace num {
+	/* result of a predicate over uncertain values */
+	enum Tri : uint8_t {
+		TriNo = 0,
+		TriYes = 1,
+		TriMaybe = 2,
+	};
+
+	/* combine the predicates [a] and [b] to the result of [a and b] */
+	constexpr num::Tri TriAnd(num::Tri a, num::Tri b) {
+		if (a == num::TriNo || b == num::TriNo)
+			return num::TriNo;
+		return (a == num::TriYes && b == num::TriYes ? num::TriYes : num::TriMaybe);
+	}
+
+	/* combine the predicates [a] and [b] to the result of [a or b] */
+	constexpr num::Tri TriOr(num::Tri a, num::Tri b) {
+		if (a == num::TriYes || b == num::TriYes)
+			return num::TriYes;
+		return (a == num::TriNo && b == num::TriNo ? num::TriNo : num::TriMaybe);
+	}
+
+	/* invert the predicate [a] */
+	constexpr num::Tri TriNot(num::Tri a) {
+		return (a == num::TriMaybe ? a : (a == num::TriYes ? num::TriNo : num::TriYes));
+	}
+
+	namespace detail {
+		/* compute the next representable value above [v] (constexpr replacement of std::nextafter) */
+		template <std::floating_point Type>
+		constexpr Type NextUp(Type v) {
+			using Bits = std::conditional_t<sizeof(Type) == sizeof(uint32_t), uint32_t, uint64_t>;
+			static_assert(sizeof(Type) == sizeof(Bits), "only single and double precision are supported");
+			if (v != v || v == std::numeric_limits<Type>::infinity())
+				return v;
+			if (v == 0)
+				return std::numeric_limits<Type>::denorm_min();
+			const Bits bits = std::bit_cast<Bits>(v);
+			return std::bit_cast<Type>(v > 0 ? Bits(bits + 1) : Bits(bits - 1));
+		}
+
+		/* compute the next representable value below [v] */
+		template <std::floating_point Type>
+		constexpr Type NextDown(Type v) {
+			return -detail::NextUp(-v);
+		}
+	}
+
+	/*
+	*	Closed interval [lo; hi] of real numbers with outward rounding
+	*	- every operation computes the bounds with the default rounding and widens them by one unit of least precision,
+	*		which ensures that the exact result of the operation on any values within the operands lies within the result
+	*	- comparisons return num::TriMaybe if the answer depends on the values within the intervals
+	*/
+	template <std::floating_point Type>
+	struct Interval {
+	public:
+		Type lo = 0;
+		Type hi = 0;
+
+	public:
+		constexpr Interval() = default;
+		constexpr Interval(Type v) : lo{ v }, hi{ v } {}
+		constexpr Interval(Type lo, Type hi) : lo{ lo }, hi{ hi } {}
+
+	public:
+		/* create the interval [lo; hi] widened outwards by one unit of least precision */
+		static constexpr num::Interval<Type> Round(Type lo, Type hi) {
+			return num::Interval<Type>{ detail::NextDown(lo), detail::NextUp(hi) };
+		}
+
+		/* create the interval of all values within the distance [r] of [v] */
+		static constexpr num::Interval<Type> Around(Type v, Type r) {
+			return num::Interval<Type>::Round(v - r, v + r);
+		}
+
+		/* create the interval, which contains all real values */
+		static constexpr num::Interval<Type> Any() {
+			return num::Interval<Type>{ -std::numeric_limits<Type>::infinity(), std::numeric_limits<Type>::infinity() };
+		}
+
+	public:
+		constexpr num::Interval<Type> operator-() const {
+			return num::Interval<Type>{ -hi, -lo };
+		}
+		constexpr num::Interval<Type> operator+(const num::Interval<Type>& v) const {
+			return num::Interval<Type>::Round(lo + v.lo, hi + v.hi);
+		}
+		constexpr num::Interval<Type> operator-(const num::Interval<Type>& v) const {
+			return num::Interval<Type>::Round(lo - v.hi, hi - v.lo);
+		}
+		constexpr num::Interval<Type> operator*(const num::Interval<Type>& v) const {
+			const Type a = lo * v.lo, b = lo * v.hi, c = hi * v.lo, d = hi * v.hi;
+			return num::Interval<Type>::Round(std::min({ a, b, c, d }), std::max({ a, b, c, d }));
+		}
+		constexpr num::Interval<Type> operator/(const num::Interval<Type>& v) const {
+			/* division by an interval, which contains zero, can produce any value */
+			if (v.lo <= 0 && v.hi >= 0)
+				return num::Interval<Type>::Any();
+			const Type a = lo / v.lo, b = lo / v.hi, c = hi / v.lo, d = hi / v.hi;
+			return num::Interval<Type>::Round(std::min({ a, b, c, d }), std::max({ a, b, c, d }));
+		}
+		constexpr num::Interval<Type>& operator+=(const num::Interval<Type>& v) {
+			return (*this = *this + v);
+		}
+		constexpr num::Interval<Type>& operator-=(const num::Interval<Type>& v) {
+			return (*this = *this - v);
+		}
+		constexpr num::Interval<Type>& operator*=(const num::Interval<Type>& v) {
+			return (*this = *this * v);
+		}
+		constexpr num::Interval<Type>& operator/=(const num::Interval<Type>& v) {
+			return (*this = *this / v);
+		}
+
+	public:
+		/* check if the interval contains the value [v] */
+		constexpr bool contains(Type v) const {
+			return lo <= v && v <= hi;
+		}
+
+		/* width of the interval */
+		constexpr Type width() const {
+			return detail::NextUp(hi - lo);
+		}
+
+		/* compute the square of the interval (tighter than the product with itself, as it cannot become negative) */
+		constexpr num::Interval<Type> sqr() const {
+			if (lo >= 0)
+				return num::Interval<Type>::Round(lo * lo, hi * hi);
+			if (hi <= 0)
+				return num::Interval<Type>::Round(hi * hi, lo * lo);
+			return num::Interval<Type>{ 0, detail::NextUp(std::max(lo * lo, hi * hi)) };
+		}
+
+		/* compute the square root of the non-negative part of the interval */
+		constexpr num::Interval<Type> sqrt() const {
+			const Type l = num::Sqrt(std::max<Type>(lo, 0)), h = num::Sqrt(std::max<Type>(hi, 0));
+			return num::Interval<Type>{ std::max<Type>(detail::NextDown(l), 0), detail::NextUp(h) };
+		}
+
+		/* check if all values of the interval are less than all values of [v] */
+		constexpr num::Tri less(const num::Interval<Type>& v) const {
+			if (hi < v.lo)
+				return num::TriYes;
+			return (lo >= v.hi ? num::TriNo : num::TriMaybe);
+		}
+
+		/* check if the interval is positive (yes), negative or zero (no), or contains zero (maybe) */
+		constexpr num::Tri positive() const {
+			if (lo > 0)
+				return num::TriYes;
+			return (hi <= 0 ? num::TriNo : num::TriMaybe);
+		}
+
+		/* check if the interval is within [-precision; precision] (yes), outside of it (no), or overlaps it (maybe) */
+		constexpr num::Tri zero(const num::Interval<Type>& precision) const {
+			if (lo >= -precision.lo && hi <= precision.lo)
+				return num::TriYes;
+			return (lo > precision.hi || hi < -precision.hi ? num::TriNo : num::TriMaybe);
+		}
+	};
+
+	/* vector of intervals, which bounds all vectors within a box or a motion range */
+	template <std::floating_point Type>
+	struct IntervalVec {
+	public:
+		num::Interval<Type> x;
+		num::Interval<Type> y;
+		num::Interval<Type> z;
+
+	public:
+		constexpr IntervalVec() = default;
+		constexpr IntervalVec(const num::Interval<Type>& x, const num::Interval<Type>& y, const num::Interval<Type>& z) : x{ x }, y{ y }, z{ z } {}
+		constexpr IntervalVec(const num::Vec<Type>& v) : x{ v.x }, y{ v.y }, z{ v.z } {}
+		constexpr IntervalVec(const num::Box<Type>& b) : x{ b.min.x, b.max.x }, y{ b.min.y, b.max.y }, z{ b.min.z, b.max.z } {}
+
+	public:
+		/* create the bounds of all vectors within the distance [r] of [v] along every axis */
+		static constexpr num::IntervalVec<Type> Around(const num::Vec<Type>& v, Type r) {
+			return num::IntervalVec<Type>{ num::Interval<Type>::Around(v.x, r), num::Interval<Type>::Around(v.y, r), num::Interval<Type>::Around(v.z, r) };
+		}
+
+	public:
+		constexpr num::IntervalVec<Type> operator-() const {
+			return num::IntervalVec<Type>{ -x, -y, -z };
+		}
+		constexpr num::IntervalVec<Type> operator+(const num::IntervalVec<Type>& v) const {
+			return num::IntervalVec<Type>{ x + v.x, y + v.y, z + v.z };
+		}
+		constexpr num::IntervalVec<Type> operator-(const num::IntervalVec<Type>& v) const {
+			return num::IntervalVec<Type>{ x - v.x, y - v.y, z - v.z };
+		}
+		constexpr num::IntervalVec<Type> operator*(const num::Interval<Type>& f) const {
+			return num::IntervalVec<Type>{ x * f, y * f, z * f };
+		}
+		constexpr num::IntervalVec<Type> operator/(const num::Interval<Type>& f) const {
+			return num::IntervalVec<Type>{ x / f, y / f, z / f };
+		}
+
+	public:
+		/* check if the bounds contain the vector [v] */
+		constexpr bool contains(const num::Vec<Type>& v) const {
+			return x.contains(v.x) && y.contains(v.y) && z.contains(v.z);
+		}
+
+		/* bounds of the dot product of any vectors within [this] and [v] */
+		constexpr num::Interval<Type> dot(const num::IntervalVec<Type>& v) const {
+			return x * v.x + y * v.y + z * v.z;
+		}
+
+		/* bounds of the cross product of any vectors within [this] and [v] */
+		constexpr num::IntervalVec<Type> cross(const num::IntervalVec<Type>& v) const {
+			return num::IntervalVec<Type>{ y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x };
+		}
+
+		/* bounds of the squared length of any vector within [this] */
+		constexpr num::Interval<Type> lenSquared() const {
+			return x.sqr() + y.sqr() + z.sqr();
+		}
+
+		/* bounds of the length of any vector within [this] */
+		constexpr num::Interval<Type> len() const {
+			return lenSquared().sqrt();
+		}
+
+		/* check if any vector within [this] matches the vector [v] within [precision] per component */
+		constexpr num::Tri match(const num::IntervalVec<Type>& v, Type precision = num::Const<Type>::Precision) const {
+			return num::TriAnd(num::TriAnd((x - v.x).zero(precision), (y - v.y).zero(precision)), (z - v.z).zero(precision));
+		}
+
+		/* compute the box, which contains all vectors within [this] */
+		constexpr num::Box<Type> box() const {
+			return num::Box<Type>{ num::Vec<Type>{ x.lo, y.lo, z.lo }, num::Vec<Type>{ x.hi, y.hi, z.hi } };
+		}
+	};
+
+	/* line with uncertain origin and direction, which bounds all lines [o + s * d] with [o] and [d] within the bounds */
+	template <std::floating_point Type>
+	struct IntervalLine {
+	public:
+		num::IntervalVec<Type> o;
+		num::IntervalVec<Type> d;
+
+	public:
+		constexpr IntervalLine() = default;
+		constexpr IntervalLine(const num::IntervalVec<Type>& o, const num::IntervalVec<Type>& d) : o{ o }, d{ d } {}
+		constexpr IntervalLine(const num::Line<Type>& l) : o{ l.o }, d{ l.d } {}
+
+	public:
+		/* check if [p] lies on the line within the distance [precision] */
+		constexpr num::Tri touch(const num::IntervalVec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			/* |(p - o) x d|^2 <= precision^2 * |d|^2 */
+			const num::Interval<Type> dist = (p - o).cross(d).lenSquared(), bound = d.lenSquared() * num::Interval<Type>{ precision }.sqr();
+			return num::TriNot(bound.less(dist));
+		}
+	};
+
+	/* plane with uncertain origin and spanning vectors, which bounds all planes (and triangles) [o + s * a + t * b] within the bounds */
+	template <std::floating_point Type>
+	struct IntervalPlane {
+	public:
+		num::IntervalVec<Type> o;
+		num::IntervalVec<Type> a;
+		num::IntervalVec<Type> b;
+
+	public:
+		constexpr IntervalPlane() = default;
+		constexpr IntervalPlane(const num::IntervalVec<Type>& o, const num::IntervalVec<Type>& a, const num::IntervalVec<Type>& b) : o{ o }, a{ a }, b{ b } {}
+		constexpr IntervalPlane(const num::Plane<Type>& p) : o{ p.o }, a{ p.a }, b{ p.b } {}
+
+	public:
+		/* bounds of the (not normalized) normal [a x b] */
+		constexpr num::IntervalVec<Type> normal() const {
+			return a.cross(b);
+		}
+
+		/* check if [p] lies above the plane (in the direction of the normal) */
+		constexpr num::Tri above(const num::IntervalVec<Type>& p) const {
+			return (p - o).dot(normal()).positive();
+		}
+
+		/* check if [p] lies on the plane within the distance [precision] */
+		constexpr num::Tri touch(const num::IntervalVec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			/* ((p - o) * n)^2 <= precision^2 * |n|^2 */
+			const num::IntervalVec<Type> n = normal();
+			const num::Interval<Type> dist = (p - o).dot(n).sqr(), bound = n.lenSquared() * num::Interval<Type>{ precision }.sqr();
+			return num::TriNot(bound.less(dist));
+		}
+
+		/* check if [p] lies within the triangle of a and b when projected along the normal */
+		constexpr num::Tri inTriangle(const num::IntervalVec<Type>& p) const {
+			/* the point lies on the inner side of all three edges of the counterclockwise triangle [o, o + a, o + b] */
+			const num::IntervalVec<Type> n = normal(), v = p - o;
+			const num::Interval<Type> zero{ 0 };
+			const num::Tri e0 = num::TriNot(a.cross(v).dot(n).less(zero));
+			const num::Tri e1 = num::TriNot((b - a).cross(v - a).dot(n).less(zero));
+			const num::Tri e2 = num::TriNot((-b).cross(v - b).dot(n).less(zero));
+			return num::TriAnd(num::TriAnd(e0, e1), e2);
+		}
+	};
+}
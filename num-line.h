@@ -31,7 +31,7 @@ namespace num {
 			/* extract the two components to work with and compute the divisor */
 			const size_t _0 = (index + 1) % 3;
 			const size_t _1 = (index + 2) % 3;
-			const Type divisor = d.c[_0] * l.d.c[_1] - d.c[_1] * l.d.c[_0];
+			const Type divisor = d[_0] * l.d[_1] - d[_1] * l.d[_0];
 
 			/* check if the two lines are parallel */
 			parallel = (num::Abs(divisor) <= precision);
@@ -39,8 +39,8 @@ namespace num {
 				return num::Linear<Type>{};
 
 			/* compute the linear combination */
-			const Type s = (l.d.c[_1] * (l.o.c[_0] - o.c[_0]) - l.d.c[_0] * (l.o.c[_1] - o.c[_1])) / divisor;
-			const Type t = (d.c[_1] * (l.o.c[_0] - o.c[_0]) - d.c[_0] * (l.o.c[_1] - o.c[_1])) / divisor;
+			const Type s = (l.d[_1] * (l.o[_0] - o[_0]) - l.d[_0] * (l.o[_1] - o[_1])) / divisor;
+			const Type t = (d[_1] * (l.o[_0] - o[_0]) - d[_0] * (l.o[_1] - o[_1])) / divisor;
 			return num::Linear<Type>{ s, t };
 		}
 
@@ -101,7 +101,7 @@ namespace num {
 
 			/* find the largest component which should not be zero if the line is well defined */
 			size_t index = d.comp(true);
-			const Type s = (p.c[index] - o.c[index]) / d.c[index];
+			const Type s = (p[index] - o[index]) / d[index];
 
 			/* compute the point on the line where the given point is expected to be */
 			const num::Vec<Type> t = point(s);
@@ -114,7 +114,7 @@ namespace num {
 		constexpr Type find(const num::Vec<Type>& p) const {
 			/* extract the largest component of the direction and use it to compute the scaling factor */
 			size_t index = d.comp(true);
-			return (p.c[index] - o.c[index]) / d.c[index];
+			return (p[index] - o[index]) / d[index];
 		}
 
 		/* check if the line [l] and line [this] describe the same line */
@@ -353,7 +353,7 @@ namespace num {
 			/* check if the lines intersect */
 			bool on = false;
 			if (!parallel)
-				on = num::Cmp(o.c[index] + d.c[index] * lin.s, l.o.c[index] + l.d.c[index] * lin.t, precision);
+				on = num::Cmp(o[index] + d[index] * lin.s, l.o[index] + l.d[index] * lin.t, precision);
 
 			/* update the invalid flag and return the result */
 			if (invalid)
@@ -0,0 +1,327 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <array>
+#include <vector>
+#include <memory_resource>
+
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#endif
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+namespace num {
+	/* defines the space filling curve used to order objects by spatial locality */
+	enum Curve : uint8_t {
+		CurveMorton = 0,
+		CurveHilbert = 1,
+	};
+
+	/* number of bits per axis used by the 64-bit curve keys */
+	inline constexpr uint32_t CurveBits = 21;
+
+	namespace detail {
+		/* lookup table which spreads the 8 bits of the index to every third bit */
+		inline constexpr std::array<uint32_t, 256> MortonSpread = []() {
+			std::array<uint32_t, 256> table{};
+			for (uint32_t i = 0; i < 256; ++i) {
+				for (uint32_t b = 0; b < 8; ++b)
+					table[i] |= ((i >> b) & 0x01) << (3 * b);
+			}
+			return table;
+		}();
+
+		/* spread the lower 21 bits of [v] to every third bit of the result */
+		inline uint64_t MortonSplit(uint32_t v) {
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+			return _pdep_u64(v, 0x1249249249249249ull);
+#else
+			return uint64_t(detail::MortonSpread[v & 0xff]) | (uint64_t(detail::MortonSpread[(v >> 8) & 0xff]) << 24)
+				| (uint64_t(detail::MortonSpread[(v >> 16) & 0x1f]) << 48);
+#endif
+		}
+
+		/* compact every third bit of [v] into the lower 21 bits of the result */
+		inline uint32_t MortonCompact(uint64_t v) {
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+			return uint32_t(_pext_u64(v, 0x1249249249249249ull));
+#else
+			v &= 0x1249249249249249ull;
+			v = (v ^ (v >> 2)) & 0x10c30c30c30c30c3ull;
+			v = (v ^ (v >> 4)) & 0x100f00f00f00f00full;
+			v = (v ^ (v >> 8)) & 0x001f0000ff0000ffull;
+			v = (v ^ (v >> 16)) & 0x001f00000000ffffull;
+			v = (v ^ (v >> 32)) & 0x00000000001fffffull;
+			return uint32_t(v);
+#endif
+		}
+	}
+
+	/* interleave the lower 21 bits of the three coordinates to the morton key (x occupies the least significant bit) */
+	inline uint64_t MortonEncode(uint32_t x, uint32_t y, uint32_t z) {
+		return detail::MortonSplit(x) | (detail::MortonSplit(y) << 1) | (detail::MortonSplit(z) << 2);
+	}
+
+	/* extract the three coordinates from the morton key [key] */
+	inline void MortonDecode(uint64_t key, uint32_t& x, uint32_t& y, uint32_t& z) {
+		x = detail::MortonCompact(key);
+		y = detail::MortonCompact(key >> 1);
+		z = detail::MortonCompact(key >> 2);
+	}
+
+	/* compute the key along the hilbert curve of the lower 21 bits of the three coordinates */
+	inline uint64_t HilbertEncode(uint32_t x, uint32_t y, uint32_t z) {
+		/*
+		*	transform the coordinates into the transposed hilbert index (Skilling, 2004)
+		*	and interleave the result to the final key with the first axis being the most significant
+		*/
+		uint32_t c[3] = { x, y, z };
+		for (uint32_t q = (1u << (num::CurveBits - 1)); q > 1; q >>= 1) {
+			const uint32_t p = q - 1;
+			for (size_t i = 0; i < 3; ++i) {
+				if (c[i] & q)
+					c[0] ^= p;
+				else {
+					const uint32_t t = (c[0] ^ c[i]) & p;
+					c[0] ^= t;
+					c[i] ^= t;
+				}
+			}
+		}
+
+		/* apply the gray encoding */
+		c[1] ^= c[0];
+		c[2] ^= c[1];
+		uint32_t t = 0;
+		for (uint32_t q = (1u << (num::CurveBits - 1)); q > 1; q >>= 1) {
+			if (c[2] & q)
+				t ^= q - 1;
+		}
+		return num::MortonEncode(c[2] ^ t, c[1] ^ t, c[0] ^ t);
+	}
+
+	/*
+	*	Quantization of a bounding box to compute space filling curve keys
+	*	- every axis of the box is quantized into 21 bits, points outside of the box are clamped
+	*/
+	template <std::floating_point Type>
+	struct CurveKey {
+	public:
+		num::Vec<Type> min;
+		num::Vec<Type> scale;
+		num::Curve curve = num::CurveMorton;
+
+	public:
+		constexpr CurveKey() = default;
+		constexpr CurveKey(const num::Vec<Type>& min, const num::Vec<Type>& max, num::Curve curve = num::CurveMorton) : min{ min }, curve{ curve } {
+			constexpr Type cells = Type((1u << num::CurveBits) - 1);
+			for (size_t i = 0; i < 3; ++i)
+				scale[i] = (max[i] > min[i] ? cells / (max[i] - min[i]) : 0);
+		}
+
+	public:
+		/* position used to order a vector */
+		static constexpr num::Vec<Type> Position(const num::Vec<Type>& v) {
+			return v;
+		}
+
+		/* position used to order a line (its origin) */
+		static constexpr num::Vec<Type> Position(const num::Line<Type>& l) {
+			return l.o;
+		}
+
+		/* position used to order a plane (the center of its triangle) */
+		static constexpr num::Vec<Type> Position(const num::Plane<Type>& p) {
+			return p.center();
+		}
+
+		/* create the quantization for the bounding box of the positions of the [objects] */
+		template <class ObjType>
+		static constexpr num::CurveKey<Type> Bounds(std::span<const ObjType> objects, num::Curve curve = num::CurveMorton) {
+			if (objects.empty())
+				return num::CurveKey<Type>{ num::Vec<Type>{}, num::Vec<Type>{}, curve };
+			num::Vec<Type> min = Position(objects[0]), max = min;
+			for (const ObjType& obj : objects) {
+				const num::Vec<Type> p = Position(obj);
+				for (size_t i = 0; i < 3; ++i) {
+					min[i] = std::min(min[i], p[i]);
+					max[i] = std::max(max[i], p[i]);
+				}
+			}
+			return num::CurveKey<Type>{ min, max, curve };
+		}
+
+	public:
+		/* compute the quantized coordinate of [v] along the axis [index] */
+		constexpr uint32_t quantize(const num::Vec<Type>& v, size_t index) const {
+			const Type q = (v[index] - min[index]) * scale[index];
+			if (!(q > 0))
+				return 0;
+			return (q >= Type((1u << num::CurveBits) - 1) ? (1u << num::CurveBits) - 1 : uint32_t(q));
+		}
+
+		/* compute the key of the object [obj] along the configured curve */
+		template <class ObjType>
+		uint64_t key(const ObjType& obj) const {
+			const num::Vec<Type> p = Position(obj);
+			const uint32_t x = quantize(p, num::ComponentX), y = quantize(p, num::ComponentY), z = quantize(p, num::ComponentZ);
+			return (curve == num::CurveHilbert ? num::HilbertEncode(x, y, z) : num::MortonEncode(x, y, z));
+		}
+
+		/* compute the keys of all [objects] into [keys] (must be at least as large as [objects]) */
+		template <class ObjType>
+		void keys(std::span<const ObjType> objects, std::span<uint64_t> keys, size_t threads = 0) const {
+			num::ParallelDispatch(objects.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					keys[i] = key(objects[i]);
+			});
+		}
+	};
+
+	/*
+	*	Stable parallel radix sort of 64-bit keys, which produces the permutation of the original indices
+	*	- [keys] is sorted in place and [order] receives the original index of every sorted key
+	*	- passes of bytes, which are identical for all keys, are skipped
+	*/
+	inline void RadixSort(std::span<uint64_t> keys, std::span<size_t> order, size_t threads = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+		static constexpr size_t MinChunk = 65536;
+		const size_t count = keys.size();
+		for (size_t i = 0; i < count; ++i)
+			order[i] = i;
+		if (count <= 1)
+			return;
+
+		/* allocate the buffers to scatter into and the histograms of the separate chunks */
+		const size_t chunks = num::ParallelChunks(count, threads, MinChunk);
+		std::pmr::vector<uint64_t> tmpKeys{ count, resource };
+		std::pmr::vector<size_t> tmpOrder{ count, resource };
+		std::pmr::vector<size_t> histogram{ chunks * 256, resource };
+		std::span<uint64_t> srcKeys = keys, dstKeys = tmpKeys;
+		std::span<size_t> srcOrder = order, dstOrder = tmpOrder;
+
+		/* compute the bits, which differ between the keys, in order to skip identical bytes */
+		uint64_t diff = 0;
+		for (size_t i = 1; i < count; ++i)
+			diff |= (keys[i] ^ keys[0]);
+
+		for (size_t shift = 0; shift < 64; shift += 8) {
+			if (((diff >> shift) & 0xff) == 0)
+				continue;
+
+			/* count the digits of every chunk */
+			std::fill(histogram.begin(), histogram.end(), 0);
+			num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				size_t* hist = histogram.data() + chunk * 256;
+				for (size_t i = begin; i < end; ++i)
+					++hist[(srcKeys[i] >> shift) & 0xff];
+			});
+
+			/* convert the counts to the scatter offsets (ordered by digit and then by chunk to keep the sort stable) */
+			size_t offset = 0;
+			for (size_t digit = 0; digit < 256; ++digit) {
+				for (size_t chunk = 0; chunk < chunks; ++chunk) {
+					const size_t value = histogram[chunk * 256 + digit];
+					histogram[chunk * 256 + digit] = offset;
+					offset += value;
+				}
+			}
+
+			/* scatter the keys and indices to their destinations */
+			num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				size_t* hist = histogram.data() + chunk * 256;
+				for (size_t i = begin; i < end; ++i) {
+					const size_t dest = hist[(srcKeys[i] >> shift) & 0xff]++;
+					dstKeys[dest] = srcKeys[i];
+					dstOrder[dest] = srcOrder[i];
+				}
+			});
+			std::swap(srcKeys, dstKeys);
+			std::swap(srcOrder, dstOrder);
+		}
+
+		/* check if the result has ended up in the temporary buffers */
+		if (srcKeys.data() != keys.data()) {
+			std::copy(srcKeys.begin(), srcKeys.end(), keys.begin());
+			std::copy(srcOrder.begin(), srcOrder.end(), order.begin());
+		}
+	}
+
+	/*
+	*	Spatial ordering of vectors, lines, or planes along a space filling curve
+	*	- lines are ordered by their origin and planes by the center of their triangle
+	*	- the computed order can be applied to the objects themselves as well as to any attached payloads
+	*/
+	template <std::floating_point Type>
+	struct SpatialOrder {
+	private:
+		std::pmr::vector<uint64_t> pKeys;
+		std::pmr::vector<size_t> pOrder;
+		std::pmr::memory_resource* pResource = 0;
+
+	public:
+		explicit SpatialOrder(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pKeys{ resource }, pOrder{ resource }, pResource{ resource } {}
+
+	private:
+		template <class ObjType>
+		void fCompute(std::span<const ObjType> objects, num::Curve curve, size_t threads) {
+			pKeys.resize(objects.size());
+			pOrder.resize(objects.size());
+			num::CurveKey<Type>::Bounds(objects, curve).keys(objects, std::span<uint64_t>{ pKeys }, threads);
+			num::RadixSort(pKeys, pOrder, threads, pResource);
+		}
+
+	public:
+		/* compute the order of the vectors [objects] along the [curve] */
+		void compute(std::span<const num::Vec<Type>> objects, num::Curve curve = num::CurveMorton, size_t threads = 0) {
+			fCompute(objects, curve, threads);
+		}
+
+		/* compute the order of the lines [objects] along the [curve] */
+		void compute(std::span<const num::Line<Type>> objects, num::Curve curve = num::CurveMorton, size_t threads = 0) {
+			fCompute(objects, curve, threads);
+		}
+
+		/* compute the order of the planes [objects] along the [curve] */
+		void compute(std::span<const num::Plane<Type>> objects, num::Curve curve = num::CurveMorton, size_t threads = 0) {
+			fCompute(objects, curve, threads);
+		}
+
+		/* reorder the [data] by the last computed order (must have the same size as the ordered objects) */
+		template <class DataType>
+		void apply(std::span<DataType> data, size_t threads = 0) const {
+			std::pmr::vector<DataType> tmp{ data.size(), pResource };
+			num::Parallel(data.size(), threads, 16384, [&](size_t begin, size_t end, size_t) {
+				for (size_t i = begin; i < end; ++i)
+					tmp[i] = data[pOrder[i]];
+			});
+			std::copy(tmp.begin(), tmp.end(), data.begin());
+		}
+
+		/* sorted keys of the last computed order */
+		std::span<const uint64_t> keys() const {
+			return pKeys;
+		}
+
+		/* original index of every object of the last computed order */
+		std::span<const size_t> order() const {
+			return pOrder;
+		}
+	};
+
+	/* reorder the vectors, lines, or planes [objects] and all attached [payloads] along the [curve] */
+	template <std::floating_point Type, template <class> class ObjType, class... PayloadType>
+	void SpatialSort(std::span<ObjType<Type>> objects, num::Curve curve, std::span<PayloadType>... payloads) {
+		num::SpatialOrder<Type> order;
+		order.compute(std::span<const ObjType<Type>>{ objects }, curve);
+		order.apply(objects);
+		(order.apply(payloads), ...);
+	}
+}
@@ -0,0 +1,499 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <vector>
+#include <limits>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <type_traits>
+#include <memory_resource>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-box.h"
+#include "num-segment.h"
+#include "num-parallel.h"
+#include "num-reduce.h"
+#include "num-fit.h"
+#include "num-morton.h"
+
+namespace num {
+	/* node of the linear octree with the aggregated statistics of all points within its cell */
+	template <std::floating_point Type>
+	struct OctreeNode {
+	public:
+		num::Box<Type> bounds;
+		num::Moments<Type> moments;
+		uint64_t key = 0;
+		uint64_t first = 0;
+		uint64_t child = 0;
+		uint32_t children = 0;
+		uint32_t level = 0;
+
+	public:
+		/* number of points within the node */
+		constexpr size_t count() const {
+			return moments.count();
+		}
+
+		/* centroid of the points within the node */
+		constexpr const num::Vec<Type>& centroid() const {
+			return moments.mean();
+		}
+
+		/* check if the node has no children */
+		constexpr bool leaf() const {
+			return children == 0;
+		}
+
+		/* compute the best-fit plane of the points within the node (invalid if the points do not span a plane) */
+		constexpr num::Plane<Type> plane(bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			return moments.plane(invalid, precision);
+		}
+	};
+
+	/*
+	*	Pointer-free octree over point clouds, whose nodes are identified by the prefixes of the morton keys of the points
+	*	- the bounding cube is split [depth] times (at most num::CurveBits), and only non-empty cells are stored
+	*	- the nodes are stored level by level (root first) in morton order, and the children of a node are consecutive
+	*	- every node covers a consecutive range [first; first + count) of the point indices in morton order
+	*	- the levels are built bottom-up in parallel, and the aggregates of a parent are the ordered merge of its children
+	*	- queries collect the nodes at a requested level of detail or the leaves above it
+	*	- nearest neighbor queries take the points the octree was built over, as the octree only stores their indices
+	*	- the frustum is given as planes, whose normals point outwards, and a point is inside if it lies behind or on all planes
+	*/
+	template <std::floating_point Type>
+	struct Octree {
+	public:
+		using Node = num::OctreeNode<Type>;
+		static_assert(std::is_trivially_copyable_v<Node>, "octree nodes must be trivially copyable to be serialized");
+
+	private:
+		static constexpr size_t MinChunk = 65536;
+		static constexpr uint64_t Magic = 0x3165657274636f4eull;
+
+	private:
+		struct Header {
+			uint64_t magic = 0;
+			uint64_t nodeSize = 0;
+			uint64_t indexSize = 0;
+			uint64_t nodes = 0;
+			uint64_t points = 0;
+			uint64_t depth = 0;
+			num::Vec<Type> origin;
+			Type size = 0;
+		};
+
+	private:
+		std::pmr::vector<Node> pNodes;
+		std::pmr::vector<size_t> pLevels;
+		std::pmr::vector<size_t> pOrder;
+		std::pmr::vector<uint64_t> pKeys;
+		std::pmr::vector<size_t> pStarts;
+		std::pmr::vector<size_t> pCounts;
+		std::pmr::vector<Node> pBuild;
+		num::Vec<Type> pOrigin;
+		Type pSize = 0;
+		uint32_t pDepth = 0;
+		std::pmr::memory_resource* pResource = 0;
+
+	public:
+		explicit Octree(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pNodes{ resource }, pLevels{ resource },
+			pOrder{ resource }, pKeys{ resource }, pStarts{ resource }, pCounts{ resource }, pBuild{ resource }, pResource{ resource } {}
+
+	private:
+		/* write the starts of all runs of equal [keyOf(i)] within the [count] items to [pStarts] (with a closing [count]) */
+		template <class KeyOf>
+		void fRuns(size_t count, const KeyOf& keyOf, size_t threads) {
+			const size_t chunks = num::ParallelChunks(count, threads, MinChunk);
+			pCounts.assign(chunks, 0);
+			num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				size_t runs = 0;
+				for (size_t i = begin; i < end; ++i)
+					runs += size_t(i == 0 || keyOf(i) != keyOf(i - 1));
+				pCounts[chunk] = runs;
+			});
+
+			size_t total = 0;
+			for (size_t& runs : pCounts) {
+				const size_t value = runs;
+				runs = total;
+				total += value;
+			}
+			pStarts.resize(total + 1);
+			pStarts[total] = count;
+			num::Parallel(count, threads, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				size_t offset = pCounts[chunk];
+				for (size_t i = begin; i < end; ++i) {
+					if (i == 0 || keyOf(i) != keyOf(i - 1))
+						pStarts[offset++] = i;
+				}
+			});
+		}
+
+		/* collect all nodes, which pass [test(node)] together with all of their ancestors, at the [level] or leaves above it into [out] (in morton order) */
+		template <class Test>
+		void fCollect(uint32_t level, std::vector<size_t>& out, const Test& test) const {
+			out.clear();
+			if (pNodes.empty())
+				return;
+
+			/* the depth-first traversal holds at most the siblings of every level on the stack */
+			size_t stack[8 * (num::CurveBits + 2)];
+			size_t size = 0;
+			stack[size++] = 0;
+			while (size > 0) {
+				const size_t index = stack[--size];
+				const Node& node = pNodes[index];
+				if (!test(node))
+					continue;
+				if (node.leaf() || node.level >= level) {
+					out.push_back(index);
+					continue;
+				}
+				for (size_t i = node.children; i > 0; --i)
+					stack[size++] = size_t(node.child + i - 1);
+			}
+		}
+
+		/* collect all nodes at the [level] or leaves above it, whose bounds are hit by [o + t * d] for [t] in [lo; hi], into [out] */
+		void fRay(const num::Vec<Type>& o, const num::Vec<Type>& d, Type lo, Type hi, uint32_t level, std::vector<size_t>& out) const {
+			std::pmr::vector<std::pair<Type, size_t>> hits{ pResource };
+			fCollect(level, out, [&](const Node& node) {
+				Type t0 = lo, t1 = hi;
+				return node.bounds.clip(o, d, t0, t1);
+			});
+			for (size_t index : out) {
+				Type t0 = lo, t1 = hi;
+				pNodes[index].bounds.clip(o, d, t0, t1);
+				hits.emplace_back(t0, index);
+			}
+			std::stable_sort(hits.begin(), hits.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+			for (size_t i = 0; i < hits.size(); ++i)
+				out[i] = hits[i].second;
+		}
+
+	public:
+		/* build the octree with [depth] levels below the root over the [points] */
+		void build(std::span<const num::Vec<Type>> points, uint32_t depth = 10, size_t threads = 0) {
+			pDepth = std::min(depth, num::CurveBits);
+			pNodes.clear();
+			pLevels.assign(size_t(pDepth) + 2, 0);
+			pOrder.resize(points.size());
+			if (points.empty())
+				return;
+
+			/* compute the bounding cube and sort the points along the morton curve */
+			const num::Box<Type> bounds = num::Bounds(points, threads);
+			const num::Vec<Type> size = bounds.size();
+			pOrigin = bounds.min;
+			pSize = std::max({ size.x, size.y, size.z });
+			pKeys.resize(points.size());
+			num::CurveKey<Type>{ pOrigin, pOrigin + num::Vec<Type>{ pSize }, num::CurveMorton }.keys(points, std::span<uint64_t>{ pKeys }, threads);
+			num::RadixSort(pKeys, pOrder, threads, pResource);
+
+			/* create the leaves from the runs of equal key prefixes (nodes are built into [pBuild] from the deepest level upwards) */
+			const uint32_t leafShift = 3 * (num::CurveBits - pDepth);
+			fRuns(points.size(), [&](size_t i) { return pKeys[i] >> leafShift; }, threads);
+			size_t levelBegin[num::CurveBits + 1] = { 0 };
+			pBuild.resize(pStarts.size() - 1);
+			num::Parallel(pBuild.size(), threads, 1024, [&](size_t begin, size_t end, size_t) {
+				for (size_t n = begin; n < end; ++n) {
+					Node node;
+					node.key = pKeys[pStarts[n]] >> leafShift;
+					node.first = pStarts[n];
+					node.level = pDepth;
+					for (size_t i = pStarts[n]; i < pStarts[n + 1]; ++i) {
+						const num::Vec<Type>& p = points[pOrder[i]];
+						node.bounds = node.bounds.extend(p);
+						node.moments.add(p);
+					}
+					pBuild[n] = node;
+				}
+			});
+
+			/* merge the runs of siblings of every level into their parents */
+			for (uint32_t level = pDepth; level > 0; --level) {
+				const size_t begin = levelBegin[level], count = pBuild.size() - begin;
+				fRuns(count, [&](size_t i) { return pBuild[begin + i].key >> 3; }, threads);
+				const size_t parents = pStarts.size() - 1;
+				levelBegin[level - 1] = pBuild.size();
+				pBuild.resize(pBuild.size() + parents);
+				num::Parallel(parents, threads, 1024, [&](size_t first, size_t last, size_t) {
+					for (size_t n = first; n < last; ++n) {
+						Node node;
+						const Node& head = pBuild[begin + pStarts[n]];
+						node.key = head.key >> 3;
+						node.first = head.first;
+						node.child = begin + pStarts[n];
+						node.children = uint32_t(pStarts[n + 1] - pStarts[n]);
+						node.level = level - 1;
+						for (size_t i = pStarts[n]; i < pStarts[n + 1]; ++i) {
+							node.bounds = node.bounds.merge(pBuild[begin + i].bounds);
+							node.moments.merge(pBuild[begin + i].moments);
+						}
+						pBuild[levelBegin[level - 1] + n] = node;
+					}
+				});
+			}
+
+			/* reverse the level order to place the root first and remap the child indices */
+			size_t offset = 0;
+			for (uint32_t level = 0; level <= pDepth; ++level) {
+				const size_t end = (level == 0 ? pBuild.size() : levelBegin[level - 1]);
+				pLevels[level] = offset;
+				offset += end - levelBegin[level];
+			}
+			pLevels[size_t(pDepth) + 1] = offset;
+			pNodes.resize(offset);
+			num::Parallel(pDepth + 1, threads, 1, [&](size_t first, size_t last, size_t) {
+				for (size_t level = first; level < last; ++level) {
+					const size_t src = levelBegin[level];
+					for (size_t i = pLevels[level]; i < pLevels[level + 1]; ++i) {
+						Node node = pBuild[src + i - pLevels[level]];
+						if (node.children > 0)
+							node.child = node.child - levelBegin[level + 1] + pLevels[level + 1];
+						pNodes[i] = node;
+					}
+				}
+			});
+		}
+
+	public:
+		/* number of levels below the root */
+		constexpr uint32_t depth() const {
+			return pDepth;
+		}
+
+		/* all nodes, level by level starting with the root (empty if no points) */
+		std::span<const Node> nodes() const {
+			return pNodes;
+		}
+
+		/* all nodes of the [level] in morton order */
+		std::span<const Node> nodes(uint32_t level) const {
+			if (pNodes.empty() || level > pDepth)
+				return {};
+			return std::span<const Node>{ pNodes }.subspan(pLevels[level], pLevels[size_t(level) + 1] - pLevels[level]);
+		}
+
+		/* index of the first node of the [level] within all nodes */
+		size_t levelOffset(uint32_t level) const {
+			return (pNodes.empty() ? 0 : pLevels[std::min(level, pDepth + 1)]);
+		}
+
+		/* original indices of all points in morton order */
+		std::span<const size_t> order() const {
+			return pOrder;
+		}
+
+		/* original indices of all points within the [node] */
+		std::span<const size_t> points(const Node& node) const {
+			return std::span<const size_t>{ pOrder }.subspan(node.first, node.count());
+		}
+
+		/* compute the cube of the cell covered by the [node] */
+		num::Box<Type> cell(const Node& node) const {
+			uint32_t x = 0, y = 0, z = 0;
+			num::MortonDecode(node.key, x, y, z);
+
+			/* the quantization maps the cube onto [0; 2^bits - 1] instead of [0; 2^bits) */
+			const Type extent = pSize * Type(uint64_t(1) << (num::CurveBits - node.level)) / Type((uint64_t(1) << num::CurveBits) - 1);
+			const num::Vec<Type> min = pOrigin + num::Vec<Type>{ Type(x), Type(y), Type(z) } * extent;
+			return num::Box<Type>{ min, min + num::Vec<Type>{ extent } };
+		}
+
+	public:
+		/* collect the nodes at the [level] or leaves above it, which are not completely outside of the [frustum], into [out] */
+		void frustum(std::span<const num::Plane<Type>> frustum, uint32_t level, std::vector<size_t>& out) const {
+			fCollect(level, out, [&](const Node& node) {
+				for (const num::Plane<Type>& p : frustum) {
+					const num::Vec<Type> n = p.normal();
+					if ((node.bounds.support(-n) - p.o).dot(n) > 0)
+						return false;
+				}
+				return true;
+			});
+		}
+
+		/* collect the nodes at the [level] or leaves above it, whose bounds are hit by the line [l], into [out] (sorted by the entry factor) */
+		void ray(const num::Line<Type>& l, uint32_t level, std::vector<size_t>& out) const {
+			fRay(l.o, l.d, -std::numeric_limits<Type>::infinity(), std::numeric_limits<Type>::infinity(), level, out);
+		}
+
+		/* collect the nodes at the [level] or leaves above it, whose bounds are hit by the bounded line [l], into [out] (sorted by the entry factor) */
+		template <num::Extent Ext>
+		void ray(const num::Bounded<Type, Ext>& l, uint32_t level, std::vector<size_t>& out) const {
+			fRay(l.o, l.d, 0, num::Bounded<Type, Ext>::Upper, level, out);
+		}
+
+	public:
+		/* find the point of [points] (the points the octree was built over) closest to [p] (returns its index or points.size() if empty) */
+		size_t nearest(std::span<const num::Vec<Type>> points, const num::Vec<Type>& p, Type* distance = 0) const {
+			/* depth-first search with the nearest child first, which prunes nodes further away than the best point */
+			std::pair<Type, size_t> stack[8 * (num::CurveBits + 2)];
+			size_t size = 0, best = points.size();
+			Type bestDist = std::numeric_limits<Type>::infinity();
+			if (!pNodes.empty())
+				stack[size++] = { 0, 0 };
+			while (size > 0) {
+				const auto [dist, index] = stack[--size];
+				if (dist >= bestDist)
+					continue;
+				const Node& node = pNodes[index];
+				if (node.leaf()) {
+					for (size_t i : this->points(node)) {
+						const Type d = (points[i] - p).lenSquared();
+						if (d < bestDist || (d == bestDist && i < best)) {
+							bestDist = d;
+							best = i;
+						}
+					}
+					continue;
+				}
+				const size_t first = size;
+				for (size_t i = 0; i < node.children; ++i)
+					stack[size++] = { pNodes[node.child + i].bounds.closest(p).lenSquared(), size_t(node.child + i) };
+				std::sort(stack + first, stack + size, [](const auto& a, const auto& b) { return a.first > b.first; });
+			}
+			if (distance != 0)
+				*distance = num::Sqrt(bestDist);
+			return best;
+		}
+
+		/* collect the indices of the [k] points of [points] (the points the octree was built over) closest to [p] into [out] (sorted by distance) */
+		void nearest(std::span<const num::Vec<Type>> points, const num::Vec<Type>& p, size_t k, std::vector<size_t>& out) const {
+			out.clear();
+			if (pNodes.empty() || k == 0)
+				return;
+
+			/* the best points are kept in a max-heap of their distances (ties are resolved by the index) */
+			std::pmr::vector<std::pair<Type, size_t>> best{ pResource };
+			best.reserve(k);
+			std::pair<Type, size_t> stack[8 * (num::CurveBits + 2)];
+			size_t size = 0;
+			stack[size++] = { 0, 0 };
+			while (size > 0) {
+				const auto [dist, index] = stack[--size];
+				if (best.size() == k && dist > best.front().first)
+					continue;
+				const Node& node = pNodes[index];
+				if (node.leaf()) {
+					for (size_t i : this->points(node)) {
+						const std::pair<Type, size_t> entry{ (points[i] - p).lenSquared(), i };
+						if (best.size() < k) {
+							best.push_back(entry);
+							std::push_heap(best.begin(), best.end());
+						}
+						else if (entry < best.front()) {
+							std::pop_heap(best.begin(), best.end());
+							best.back() = entry;
+							std::push_heap(best.begin(), best.end());
+						}
+					}
+					continue;
+				}
+				const size_t first = size;
+				for (size_t i = 0; i < node.children; ++i)
+					stack[size++] = { pNodes[node.child + i].bounds.closest(p).lenSquared(), size_t(node.child + i) };
+				std::sort(stack + first, stack + size, [](const auto& a, const auto& b) { return a.first > b.first; });
+			}
+			std::sort_heap(best.begin(), best.end());
+			for (const auto& entry : best)
+				out.push_back(entry.second);
+		}
+
+	private:
+		/* read [count] items into [out] in blocks, such that a corrupted count fails at the end of the stream instead of allocating it up front */
+		template <class ItemType>
+		static bool fRead(std::istream& in, std::pmr::vector<ItemType>& out, uint64_t count) {
+			constexpr size_t Block = 65536;
+			out.clear();
+			while (out.size() < count) {
+				const size_t offset = out.size(), next = size_t(std::min<uint64_t>(Block, count - offset));
+				out.resize(offset + next);
+				in.read(reinterpret_cast<char*>(out.data() + offset), std::streamsize(next * sizeof(ItemType)));
+				if (!in)
+					return false;
+			}
+			return true;
+		}
+
+		/* check that the levels, child ranges, point ranges, and point indices of a loaded image are consistent */
+		bool fValid() const {
+			/* the levels must start at zero, be monotonic, cover all nodes, and contain a single root if not empty */
+			if (pLevels.front() != 0 || pLevels.back() != pNodes.size())
+				return false;
+			for (size_t l = 1; l < pLevels.size(); ++l) {
+				if (pLevels[l] < pLevels[l - 1])
+					return false;
+			}
+			if (!pNodes.empty() && pLevels[1] != 1)
+				return false;
+
+			/* every node must lie on its level, its children within the next level, and its points within the order */
+			for (size_t l = 0; l + 1 < pLevels.size(); ++l) {
+				for (size_t i = pLevels[l]; i < pLevels[l + 1]; ++i) {
+					const Node& node = pNodes[i];
+					if (node.level != l || node.children > 8 || node.first > pOrder.size() || node.count() > pOrder.size() - node.first)
+						return false;
+					if (node.children == 0)
+						continue;
+					if (l + 2 >= pLevels.size() || node.child < pLevels[l + 1] || node.child > pLevels[l + 2] || node.children > pLevels[l + 2] - node.child)
+						return false;
+				}
+			}
+
+			/* every point index must refer to a point of the source */
+			for (size_t index : pOrder) {
+				if (index >= pOrder.size())
+					return false;
+			}
+			return true;
+		}
+
+	public:
+		/* write the binary image of the octree to [out] (only valid for the same platform and floating point type) */
+		void save(std::ostream& out) const {
+			Header header;
+			header.magic = Magic;
+			header.nodeSize = sizeof(Node);
+			header.indexSize = sizeof(size_t);
+			header.nodes = pNodes.size();
+			header.points = pOrder.size();
+			header.depth = pDepth;
+			header.origin = pOrigin;
+			header.size = pSize;
+			out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+			out.write(reinterpret_cast<const char*>(pLevels.data()), std::streamsize(pLevels.size() * sizeof(size_t)));
+			out.write(reinterpret_cast<const char*>(pNodes.data()), std::streamsize(pNodes.size() * sizeof(Node)));
+			out.write(reinterpret_cast<const char*>(pOrder.data()), std::streamsize(pOrder.size() * sizeof(size_t)));
+		}
+
+		/* read the binary image of an octree written by [save] from [in] (invalid if the image is truncated or inconsistent: leaves the octree empty) */
+		void load(std::istream& in, bool* invalid = 0) {
+			Header header;
+			in.read(reinterpret_cast<char*>(&header), sizeof(Header));
+			bool valid = (in && header.magic == Magic && header.nodeSize == sizeof(Node) && header.indexSize == sizeof(size_t) && header.depth <= num::CurveBits);
+			if (valid) {
+				pDepth = uint32_t(header.depth);
+				pOrigin = header.origin;
+				pSize = header.size;
+				valid = (fRead(in, pLevels, size_t(pDepth) + 2) && fRead(in, pNodes, header.nodes) && fRead(in, pOrder, header.points) && fValid());
+			}
+			if (!valid) {
+				pNodes.clear();
+				pOrder.clear();
+				pLevels.assign(2, 0);
+				pDepth = 0;
+			}
+			if (invalid)
+				*invalid = !valid;
+		}
+	};
+}
@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "num-common.h"
+
+namespace num {
+	/* resolve the number of threads to be used by a bulk operation (zero selects the hardware concurrency) */
+	inline size_t Threads(size_t threads = 0) {
+		if (threads > 0)
+			return threads;
+		const size_t hardware = std::thread::hardware_concurrency();
+		return (hardware == 0 ? 1 : hardware);
+	}
+
+	/* number of chunks [num::Parallel] will produce for the given configuration (every chunk receives at least [minChunk] items) */
+	inline size_t ParallelChunks(size_t count, size_t threads, size_t minChunk) {
+		if (count == 0)
+			return 0;
+		return std::max<size_t>(1, std::min(num::Threads(threads), count / std::max<size_t>(minChunk, 1)));
+	}
+
+	namespace detail {
+		/*
+		*	Persistent worker threads, which execute the chunks of num::Parallel
+		*	- threads are only created when a call requests more workers than exist, and are kept until the program exits,
+		*		thereby repeated parallel calls neither spawn threads nor allocate
+		*	- one call is executed at a time, concurrent calls from other threads and nested calls from within a chunk
+		*		process their chunks sequentially on the calling thread (the chunk boundaries remain identical)
+		*/
+		struct Workers {
+		private:
+			using Call = void (*)(void*, size_t);
+
+		private:
+			std::mutex pSubmit;
+			std::mutex pMutex;
+			std::condition_variable pWake;
+			std::condition_variable pDone;
+			std::vector<std::thread> pThreads;
+			std::atomic<size_t> pNext = 0;
+			std::atomic<size_t> pFinished = 0;
+			Call pCall = 0;
+			void* pContext = 0;
+			size_t pChunks = 0;
+			size_t pSlots = 0;
+			size_t pActive = 0;
+			uint64_t pJob = 0;
+			bool pStop = false;
+
+		public:
+			Workers() = default;
+			Workers(const detail::Workers&) = delete;
+			detail::Workers& operator=(const detail::Workers&) = delete;
+			~Workers() {
+				{
+					std::unique_lock<std::mutex> lock{ pMutex };
+					pStop = true;
+				}
+				pWake.notify_all();
+				for (std::thread& thread : pThreads)
+					thread.join();
+			}
+
+		private:
+			/* check if the current thread is executing a chunk */
+			static bool& fInside() {
+				thread_local bool inside = false;
+				return inside;
+			}
+
+			/* process chunks of the current call until all have been claimed */
+			void fDrain() {
+				for (size_t chunk = pNext.fetch_add(1); chunk < pChunks; chunk = pNext.fetch_add(1)) {
+					pCall(pContext, chunk);
+					if (pFinished.fetch_add(1) + 1 == pChunks) {
+						std::unique_lock<std::mutex> lock{ pMutex };
+						pDone.notify_all();
+					}
+				}
+			}
+
+			void fWorker() {
+				fInside() = true;
+				uint64_t seen = 0;
+				std::unique_lock<std::mutex> lock{ pMutex };
+				while (true) {
+					pWake.wait(lock, [&]() { return pStop || pJob != seen; });
+					if (pStop)
+						return;
+					seen = pJob;
+
+					/* only attach to the call if it still requires workers */
+					if (pSlots == 0)
+						continue;
+					--pSlots;
+					++pActive;
+					lock.unlock();
+					fDrain();
+					lock.lock();
+					if (--pActive == 0)
+						pDone.notify_all();
+				}
+			}
+
+		public:
+			/* workers of the process */
+			static detail::Workers& Get() {
+				static detail::Workers workers;
+				return workers;
+			}
+
+			/* invoke [fn(chunk)] for all [chunks] with up to [chunks - 1] workers next to the calling thread */
+			template <class Fn>
+			void run(size_t chunks, const Fn& fn) {
+				const Call call = [](void* context, size_t chunk) { (*static_cast<const Fn*>(context))(chunk); };
+				std::unique_lock<std::mutex> submit{ pSubmit, std::defer_lock };
+				if (fInside() || !submit.try_lock()) {
+					for (size_t i = 0; i < chunks; ++i)
+						fn(i);
+					return;
+				}
+
+				/* publish the call and wake the workers */
+				{
+					std::unique_lock<std::mutex> lock{ pMutex };
+					while (pThreads.size() < chunks - 1)
+						pThreads.emplace_back([this]() { fWorker(); });
+					pCall = call;
+					pContext = const_cast<Fn*>(&fn);
+					pChunks = chunks;
+					pNext.store(0);
+					pFinished.store(0);
+					pSlots = chunks - 1;
+					++pJob;
+				}
+				pWake.notify_all();
+
+				/* participate in the call and wait for all chunks and attached workers to finish */
+				fInside() = true;
+				fDrain();
+				fInside() = false;
+				std::unique_lock<std::mutex> lock{ pMutex };
+				pDone.wait(lock, [&]() { return pFinished.load() == pChunks && pActive == 0; });
+				pSlots = 0;
+			}
+		};
+	}
+
+	/* split [count] items into consecutive chunks of at least [minChunk] items (or a single chunk of fewer items) and invoke [fn(begin, end, chunk)]
+	*	for each chunk on up to [threads] threads (the calling thread participates, and the other threads are kept across calls) */
+	template <class Fn>
+	void Parallel(size_t count, size_t threads, size_t minChunk, Fn&& fn) {
+		if (count == 0)
+			return;
+
+		/* compute the number of chunks to be used and check if the work can be done in place */
+		const size_t chunks = num::ParallelChunks(count, threads, minChunk);
+		if (chunks <= 1) {
+			fn(size_t(0), count, size_t(0));
+			return;
+		}
+		detail::Workers::Get().run(chunks, [&](size_t i) { fn((count * i) / chunks, (count * (i + 1)) / chunks, i); });
+	}
+}
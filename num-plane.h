@@ -29,12 +29,12 @@ namespace num {
 			const size_t _0 = (index + 1) % 3;
 			const size_t _1 = (index + 2) % 3;
 
-			const Type divisor = a.c[_0] * b.c[_1] - a.c[_1] * b.c[_0];
+			const Type divisor = a[_0] * b[_1] - a[_1] * b[_0];
 
-			const Type _v0 = p.c[_0] - o.c[_0];
-			const Type _v1 = p.c[_1] - o.c[_1];
-			const Type _s = (_v0 * b.c[_1] - _v1 * b.c[_0]) / divisor;
-			const Type _t = (a.c[_0] * _v1 - a.c[_1] * _v0) / divisor;
+			const Type _v0 = p[_0] - o[_0];
+			const Type _v1 = p[_1] - o[_1];
+			const Type _s = (_v0 * b[_1] - _v1 * b[_0]) / divisor;
+			const Type _t = (a[_0] * _v1 - a[_1] * _v0) / divisor;
 			return num::Linear<Type>{ _s, _t };
 		}
 
@@ -195,7 +195,7 @@ namespace num {
 
 			/* check if the touching property should be validated */
 			if (touching != 0)
-				*touching = num::Cmp(p.c[index] - o.c[index], r.s * a.c[index] + r.t * b.c[index], precision);
+				*touching = num::Cmp(p[index] - o[index], r.s * a[index] + r.t * b[index], precision);
 			return r.s >= -precision && r.t >= -precision && (r.s + r.t) <= (1 + precision);
 		}
 
@@ -230,7 +230,7 @@ namespace num {
 
 			/* check if the touching property should be validated */
 			if (touching != 0)
-				*touching = num::Cmp(p.c[index] - o.c[index], r.s * a.c[index] + r.t * b.c[index], precision);
+				*touching = num::Cmp(p[index] - o[index], r.s * a[index] + r.t * b[index], precision);
 			return r.s >= -precision && r.t >= -precision && (r.s <= 1 + precision) && (r.t <= 1 + precision);
 		}
 
@@ -279,6 +279,57 @@ namespace num {
 			return crs * f;
 		}
 
+		/* compute the shortest vector which connects [p] to a point within the triangle of a and b */
+		constexpr num::Vec<Type> closestTriangle(const num::Vec<Type>& p) const {
+			/*
+			*	find the voronoi region of the triangle [o, o + a, o + b] the point lies in
+			*	(vertices, edges or the face) and return the closest point within it
+			*	(Ericson, Real-Time Collision Detection, 5.1.5)
+			*/
+			const num::Vec<Type> ap = p - o;
+			const Type d1 = a.dot(ap), d2 = b.dot(ap);
+			if (d1 <= 0 && d2 <= 0)
+				return -ap;
+
+			const num::Vec<Type> bp = ap - a;
+			const Type d3 = a.dot(bp), d4 = b.dot(bp);
+			if (d3 >= 0 && d4 <= d3)
+				return -bp;
+
+			const Type vc = d1 * d4 - d3 * d2;
+			if (vc <= 0 && d1 >= 0 && d3 <= 0)
+				return a * (d1 / (d1 - d3)) - ap;
+
+			const num::Vec<Type> cp = ap - b;
+			const Type d5 = a.dot(cp), d6 = b.dot(cp);
+			if (d6 >= 0 && d5 <= d6)
+				return -cp;
+
+			const Type vb = d5 * d2 - d1 * d6;
+			if (vb <= 0 && d2 >= 0 && d6 <= 0)
+				return b * (d2 / (d2 - d6)) - ap;
+
+			const Type va = d3 * d6 - d5 * d4;
+			if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+				return (b - a) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))) - bp;
+
+			/* degenerate triangles are covered by the edge regions above, unless they collapse to a point */
+			const Type sum = va + vb + vc;
+			if (sum <= 0)
+				return -ap;
+			return a * (vb / sum) + b * (vc / sum) - ap;
+		}
+
+		/* compute the signed solid angle of the triangle of a and b seen from [p] (positive if the normal points away from [p]) */
+		constexpr Type solidAngle(const num::Vec<Type>& p) const {
+			/* tan(omega / 2) = det(x, y, z) / (|x||y||z| + (x * y)|z| + (y * z)|x| + (z * x)|y|) (Van Oosterom and Strackee) */
+			const num::Vec<Type> x = o - p, y = x + a, z = x + b;
+			const Type lx = x.len(), ly = y.len(), lz = z.len();
+			const Type det = x.dot(y.cross(z));
+			const Type div = lx * ly * lz + x.dot(y) * lz + y.dot(z) * lx + z.dot(x) * ly;
+			return 2 * num::Atan2(det, div);
+		}
+
 		/* compute the vector of steepest ascent in the plane for the X axis */
 		constexpr num::Vec<Type> steepestX() const {
 			/*
@@ -291,7 +342,7 @@ namespace num {
 
 			/* stretch the vectors to the same lengths */
 			const Type lF = a.lenSquared() / t.lenSquared();
-			t = t * std::sqrt(lF);
+			t = t * num::Sqrt(lF);
 
 			/* compute the vector of steepest ascent */
 			return a * a.x + t * t.x;
@@ -309,7 +360,7 @@ namespace num {
 
 			/* stretch the vectors to the same lengths */
 			const Type lF = a.lenSquared() / t.lenSquared();
-			t = t * std::sqrt(lF);
+			t = t * num::Sqrt(lF);
 
 			/* compute the vector of steepest ascent */
 			return a * a.y + t * t.y;
@@ -327,7 +378,7 @@ namespace num {
 
 			/* stretch the vectors to the same lengths */
 			const Type lF = a.lenSquared() / t.lenSquared();
-			t = t * std::sqrt(lF);
+			t = t * num::Sqrt(lF);
 
 			/* compute the vector of steepest ascent */
 			return a * a.z + t * t.z;
@@ -527,7 +578,7 @@ namespace num {
 
 			/* check if the touching property should be validated */
 			if (touching != 0)
-				*touching = num::Cmp(p.c[index] - o.c[index], r.s * a.c[index] + r.t * b.c[index], precision);
+				*touching = num::Cmp(p[index] - o[index], r.s * a[index] + r.t * b[index], precision);
 			return r;
 		}
 	};
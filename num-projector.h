@@ -0,0 +1,172 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <atomic>
+#include <memory_resource>
+#include <limits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+namespace num {
+	/* defines how the values of multiple points, which fall into the same cell of a grid, are combined */
+	enum Bin : uint8_t {
+		BinMin = 0,
+		BinMax = 1,
+		BinMean = 2,
+	};
+
+	/*
+	*	Projection of points onto the coordinate frame [o:a:b] of a plane
+	*	- points are mapped to (s, t, signed distance) with p = o + s * a + t * b + distance * normal.norm()
+	*	- the frame is prepared once as the dual basis of [a, b, normal], thereby every point costs three dot products
+	*	- points off the plane are projected along the normal, whereas num::Plane::linear projects along an axis
+	*		(both are identical for points on the plane)
+	*	- the tiles used for binning are allocated from the given memory resource and kept across calls, and their
+	*		total size is limited by TileBudget, which reduces the number of parallel chunks for large grids
+	*/
+	template <std::floating_point Type>
+	struct Projector {
+	private:
+		static constexpr size_t MinChunk = 65536;
+		static constexpr size_t TileBudget = size_t(64) << 20;
+
+	private:
+		num::Vec<Type> pOrigin;
+		num::Vec<Type> pS;
+		num::Vec<Type> pT;
+		num::Vec<Type> pN;
+		std::pmr::vector<Type> pTiles;
+		std::pmr::vector<size_t> pCounts;
+
+	public:
+		explicit Projector(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pTiles{ resource }, pCounts{ resource } {}
+		explicit Projector(const num::Plane<Type>& p, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pTiles{ resource }, pCounts{ resource } {
+			frame(p);
+		}
+
+	public:
+		/* prepare the frame of the plane [p] for all following projections (returns false and leaves the frame unchanged if the plane is degenerate) */
+		bool frame(const num::Plane<Type>& p, Type precision = num::Const<Type>::Precision) {
+			/*
+			*	dual basis of [a, b, n], such that (p - o) * s = s, (p - o) * t = t, (p - o) * n = distance
+			*	s = (b x n) / (n * n)
+			*	t = (n x a) / (n * n)
+			*/
+			const num::Vec<Type> n = p.normal();
+			const Type nn = n.dot(n);
+			if (num::Zero(nn, precision))
+				return false;
+			pOrigin = p.o;
+			pS = p.b.cross(n) / nn;
+			pT = n.cross(p.a) / nn;
+			pN = n / num::Sqrt(nn);
+			return true;
+		}
+
+		/* project the point [p] to (x: s, y: t, z: signed distance) */
+		constexpr num::Vec<Type> project(const num::Vec<Type>& p) const {
+			const num::Vec<Type> v = p - pOrigin;
+			return num::Vec<Type>{ v.dot(pS), v.dot(pT), v.dot(pN) };
+		}
+
+		/* compute the linear combination of the plane vectors to the projection of [p] onto the plane */
+		constexpr num::Linear<Type> linear(const num::Vec<Type>& p) const {
+			const num::Vec<Type> v = p - pOrigin;
+			return num::Linear<Type>{ v.dot(pS), v.dot(pT) };
+		}
+
+		/* project all points of [in] to (x: s, y: t, z: signed distance) into [out] (may be identical to [in]) */
+		void project(std::span<const num::Vec<Type>> in, std::span<num::Vec<Type>> out, size_t threads = 0) const {
+			const num::Vec<Type> o = pOrigin, s = pS, t = pT, n = pN;
+			num::ParallelDispatch(in.size(), threads, MinChunk, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i) {
+					const num::Vec<Type> v = in[i] - o;
+					out[i] = num::Vec<Type>{ v.dot(s), v.dot(t), v.dot(n) };
+				}
+			});
+		}
+
+		/* project all points of [in] and bin their signed distances into the row-major [grid] of [width] x [height] cells, which covers
+		*	the plane coordinates [min; max), and write [empty] to all cells without points (returns the number of points within the grid) */
+		size_t raster(std::span<const num::Vec<Type>> in, std::span<Type> grid, size_t width, size_t height, const num::Linear<Type>& min, const num::Linear<Type>& max,
+			num::Bin bin, size_t threads = 0, Type empty = std::numeric_limits<Type>::quiet_NaN()) {
+			const size_t cells = width * height;
+			if (cells == 0 || grid.size() < cells)
+				return 0;
+
+			/*
+			*	every chunk accumulates into its own tile, which are merged afterwards (the counts mark the cells without points
+			*	and divide the sums of the means), and the number of chunks is limited such that the tiles fit into the budget
+			*	(at least one tile is allocated, as an empty input still writes [empty] to all cells)
+			*/
+			const size_t budget = std::max<size_t>(1, TileBudget / (cells * (sizeof(Type) + sizeof(size_t))));
+			const size_t chunks = std::max<size_t>(1, num::ParallelChunks(in.size(), std::min(num::Threads(threads), budget), MinChunk));
+			const Type identity = (bin == num::BinMin ? std::numeric_limits<Type>::infinity() : (bin == num::BinMax ? -std::numeric_limits<Type>::infinity() : Type(0)));
+			pTiles.assign(chunks * cells, identity);
+			pCounts.assign(chunks * cells, 0);
+
+			/* prepare the mapping of the plane coordinates to the cells */
+			const num::Vec<Type> o = pOrigin, s = pS, t = pT, n = pN;
+			const Type scaleS = Type(width) / (max.s - min.s), scaleT = Type(height) / (max.t - min.t);
+			std::atomic<size_t> inside = 0;
+
+			num::Parallel(in.size(), chunks, MinChunk, [&](size_t begin, size_t end, size_t chunk) {
+				Type* tile = pTiles.data() + chunk * cells;
+				size_t* count = pCounts.data() + chunk * cells;
+				size_t total = 0;
+
+				for (size_t i = begin; i < end; ++i) {
+					const num::Vec<Type> v = in[i] - o;
+					const Type cs = (v.dot(s) - min.s) * scaleS, ct = (v.dot(t) - min.t) * scaleT;
+
+					/* the negated comparisons additionally reject nan */
+					if (!(cs >= 0 && cs < Type(width) && ct >= 0 && ct < Type(height)))
+						continue;
+					const size_t cell = size_t(ct) * width + size_t(cs);
+					const Type value = v.dot(n);
+
+					if (bin == num::BinMin)
+						tile[cell] = std::min(tile[cell], value);
+					else if (bin == num::BinMax)
+						tile[cell] = std::max(tile[cell], value);
+					else
+						tile[cell] += value;
+					++count[cell];
+					++total;
+				}
+				inside.fetch_add(total, std::memory_order_relaxed);
+			});
+
+			/* merge the tiles of all chunks into the grid */
+			num::Parallel(cells, threads, MinChunk, [&](size_t begin, size_t end, size_t) {
+				for (size_t c = begin; c < end; ++c) {
+					Type value = pTiles[c];
+					size_t count = pCounts[c];
+					for (size_t i = 1; i < chunks; ++i) {
+						const Type next = pTiles[i * cells + c];
+						if (bin == num::BinMin)
+							value = std::min(value, next);
+						else if (bin == num::BinMax)
+							value = std::max(value, next);
+						else
+							value += next;
+						count += pCounts[i * cells + c];
+					}
+
+					if (count == 0)
+						grid[c] = empty;
+					else
+						grid[c] = (bin == num::BinMean ? value / Type(count) : value);
+				}
+			});
+
+			return inside.load(std::memory_order_relaxed);
+		}
+	};
+}
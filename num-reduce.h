@@ -0,0 +1,346 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-plane.h"
+#include "num-box.h"
+#include "num-parallel.h"
+
+namespace num {
+	/* symmetric 3x3 matrix (e.g. covariance or second moments) */
+	template <std::floating_point Type>
+	struct Symmetric {
+	public:
+		Type xx = 0;
+		Type xy = 0;
+		Type xz = 0;
+		Type yy = 0;
+		Type yz = 0;
+		Type zz = 0;
+
+	public:
+		constexpr Symmetric() = default;
+		constexpr Symmetric(Type xx, Type xy, Type xz, Type yy, Type yz, Type zz) : xx{ xx }, xy{ xy }, xz{ xz }, yy{ yy }, yz{ yz }, zz{ zz } {}
+
+	public:
+		constexpr num::Symmetric<Type> operator+(const num::Symmetric<Type>& m) const {
+			return num::Symmetric<Type>{ xx + m.xx, xy + m.xy, xz + m.xz, yy + m.yy, yz + m.yz, zz + m.zz };
+		}
+		constexpr num::Symmetric<Type> operator-(const num::Symmetric<Type>& m) const {
+			return num::Symmetric<Type>{ xx - m.xx, xy - m.xy, xz - m.xz, yy - m.yy, yz - m.yz, zz - m.zz };
+		}
+		constexpr num::Symmetric<Type> operator*(Type f) const {
+			return num::Symmetric<Type>{ xx * f, xy * f, xz * f, yy * f, yz * f, zz * f };
+		}
+		constexpr num::Symmetric<Type> operator/(Type f) const {
+			return num::Symmetric<Type>{ xx / f, xy / f, xz / f, yy / f, yz / f, zz / f };
+		}
+		constexpr num::Vec<Type> operator*(const num::Vec<Type>& v) const {
+			return num::Vec<Type>{ xx * v.x + xy * v.y + xz * v.z, xy * v.x + yy * v.y + yz * v.z, xz * v.x + yz * v.y + zz * v.z };
+		}
+		constexpr bool operator==(const num::Symmetric<Type>& m) const {
+			return xx == m.xx && xy == m.xy && xz == m.xz && yy == m.yy && yz == m.yz && zz == m.zz;
+		}
+		constexpr bool operator!=(const num::Symmetric<Type>& m) const {
+			return !(*this == m);
+		}
+
+	public:
+		/* create the outer product [v * v^T] */
+		static constexpr num::Symmetric<Type> Outer(const num::Vec<Type>& v) {
+			return num::Symmetric<Type>{ v.x * v.x, v.x * v.y, v.x * v.z, v.y * v.y, v.y * v.z, v.z * v.z };
+		}
+
+		/* create the symmetric part of the outer product [(a * b^T + b * a^T) / 2] */
+		static constexpr num::Symmetric<Type> Outer(const num::Vec<Type>& a, const num::Vec<Type>& b) {
+			return num::Symmetric<Type>{ a.x * b.x, (a.x * b.y + a.y * b.x) / 2, (a.x * b.z + a.z * b.x) / 2,
+				a.y * b.y, (a.y * b.z + a.z * b.y) / 2, a.z * b.z };
+		}
+
+	public:
+		/* compute the trace of the matrix */
+		constexpr Type trace() const {
+			return xx + yy + zz;
+		}
+
+		/* compute the determinant of the matrix */
+		constexpr Type determinant() const {
+			return xx * (yy * zz - yz * yz) - xy * (xy * zz - yz * xz) + xz * (xy * yz - yy * xz);
+		}
+
+	private:
+		/* compute the eigenvector of the eigenvalue [value] from the largest cross product of two rows of [this - value * I] */
+		constexpr num::Vec<Type> fEigenvector0(Type value) const {
+			const num::Vec<Type> r0{ xx - value, xy, xz }, r1{ xy, yy - value, yz }, r2{ xz, yz, zz - value };
+			const num::Vec<Type> c0 = r0.cross(r1), c1 = r0.cross(r2), c2 = r1.cross(r2);
+			const Type d0 = c0.lenSquared(), d1 = c1.lenSquared(), d2 = c2.lenSquared();
+			if (d0 >= d1 && d0 >= d2)
+				return c0 / num::Sqrt(d0);
+			if (d1 >= d2)
+				return c1 / num::Sqrt(d1);
+			return c2 / num::Sqrt(d2);
+		}
+
+		/* compute the eigenvector of the eigenvalue [value] perpendicular to the eigenvector [w] by solving within the orthogonal complement of [w] */
+		constexpr num::Vec<Type> fEigenvector1(const num::Vec<Type>& w, Type value) const {
+			num::Vec<Type> u;
+			if (num::Abs(w.x) > num::Abs(w.y))
+				u = num::Vec<Type>{ -w.z, 0, w.x } / num::Sqrt(w.x * w.x + w.z * w.z);
+			else
+				u = num::Vec<Type>{ 0, w.z, -w.y } / num::Sqrt(w.y * w.y + w.z * w.z);
+			const num::Vec<Type> v = w.cross(u);
+
+			/* 2x2 system [m00, m01; m01, m11] within the plane of [u] and [v], whose null space is the eigenvector */
+			Type m00 = u.dot((*this) * u) - value, m01 = u.dot((*this) * v), m11 = v.dot((*this) * v) - value;
+			const Type a00 = num::Abs(m00), a01 = num::Abs(m01), a11 = num::Abs(m11);
+			if (a00 >= a11) {
+				if (std::max(a00, a01) <= 0)
+					return u;
+				if (a00 >= a01) {
+					m01 /= m00;
+					m00 = 1 / num::Sqrt(1 + m01 * m01);
+					m01 *= m00;
+				}
+				else {
+					m00 /= m01;
+					m01 = 1 / num::Sqrt(1 + m00 * m00);
+					m00 *= m01;
+				}
+				return u * m01 - v * m00;
+			}
+			if (std::max(a11, a01) <= 0)
+				return u;
+			if (a11 >= a01) {
+				m01 /= m11;
+				m11 = 1 / num::Sqrt(1 + m01 * m01);
+				m01 *= m11;
+			}
+			else {
+				m11 /= m01;
+				m01 = 1 / num::Sqrt(1 + m11 * m11);
+				m11 *= m01;
+			}
+			return u * m11 - v * m01;
+		}
+
+	public:
+		/* compute the eigenvalues in ascending order and optionally the corresponding orthonormal eigenvectors (right-handed) into [vectors] (which also refines the eigenvalues) */
+		constexpr num::Vec<Type> eigen(num::Vec<Type>* vectors = 0) const {
+			/*
+			*	closed form solution of the characteristic polynomial by the trigonometric method and robust computation of the
+			*	eigenvectors, by first computing the one of the most separated eigenvalue and the second one within its orthogonal
+			*	complement (Eberly, A Robust Eigensolver for 3x3 Symmetric Matrices)
+			*/
+			const Type scale = std::max({ num::Abs(xx), num::Abs(xy), num::Abs(xz), num::Abs(yy), num::Abs(yz), num::Abs(zz) });
+			if (scale <= 0) {
+				if (vectors != 0) {
+					vectors[0] = num::Vec<Type>::AxisX();
+					vectors[1] = num::Vec<Type>::AxisY();
+					vectors[2] = num::Vec<Type>::AxisZ();
+				}
+				return num::Vec<Type>{};
+			}
+			const num::Symmetric<Type> a = (*this) / scale;
+
+			/* shift the matrix by the mean eigenvalue and check if all eigenvalues are identical */
+			const Type q = a.trace() / 3;
+			const num::Symmetric<Type> b{ a.xx - q, a.xy, a.xz, a.yy - q, a.yz, a.zz - q };
+			const Type p = num::Sqrt((b.xx * b.xx + b.yy * b.yy + b.zz * b.zz + 2 * (b.xy * b.xy + b.xz * b.xz + b.yz * b.yz)) / 6);
+			if (p <= 0) {
+				if (vectors != 0) {
+					vectors[0] = num::Vec<Type>::AxisX();
+					vectors[1] = num::Vec<Type>::AxisY();
+					vectors[2] = num::Vec<Type>::AxisZ();
+				}
+				return num::Vec<Type>{ scale * q };
+			}
+
+			/* compute the eigenvalues of [b / p] as 2 * cos(angle + k * 2pi/3) */
+			const Type halfDet = std::clamp<Type>((b / p).determinant() / 2, -1, 1);
+			const Type angle = num::Acos(halfDet) / 3;
+			const Type beta2 = 2 * num::Cos(angle), beta0 = 2 * num::Cos(angle + Type(2.0943951023931954923)), beta1 = -(beta0 + beta2);
+			const num::Vec<Type> values{ q + p * beta0, q + p * beta1, q + p * beta2 };
+			if (vectors == 0)
+				return values * scale;
+
+			if (halfDet >= 0) {
+				vectors[2] = a.fEigenvector0(values.z);
+				vectors[1] = a.fEigenvector1(vectors[2], values.y);
+				vectors[0] = vectors[1].cross(vectors[2]);
+			}
+			else {
+				vectors[0] = a.fEigenvector0(values.x);
+				vectors[1] = a.fEigenvector1(vectors[0], values.y);
+				vectors[2] = vectors[0].cross(vectors[1]);
+			}
+
+			/* refine the eigenvalues by the rayleigh quotients, as the roots lose precision for (nearly) repeated eigenvalues (reorder
+			*	the possibly swapped neighbors, while keeping the axes right-handed) */
+			Type refined[3] = { vectors[0].dot(a * vectors[0]), vectors[1].dot(a * vectors[1]), vectors[2].dot(a * vectors[2]) };
+			for (size_t i : { 0, 1, 0 }) {
+				if (refined[i] <= refined[i + 1])
+					continue;
+				std::swap(refined[i], refined[i + 1]);
+				std::swap(vectors[i], vectors[i + 1]);
+				vectors[i] = -vectors[i];
+			}
+			return num::Vec<Type>{ refined[0], refined[1], refined[2] } * scale;
+		}
+	};
+
+	/*
+	*	Deterministic parallel reductions
+	*	- the items are split into blocks of a fixed size, which are independent of the number of threads, and every block as well as
+	*		the partial results of the blocks are combined by pairwise summation along a fixed tree (splitting at the midpoint)
+	*	- the results are thereby bitwise reproducible for any number of threads, and the error grows only logarithmically with the count
+	*/
+	namespace detail {
+		inline constexpr size_t ReduceBlock = 4096;
+		inline constexpr size_t ReduceLeaf = 32;
+
+		/* reduce the non-empty range [begin; end) of [load(i)] by pairwise [combine] */
+		template <class Acc, class Load, class Combine>
+		Acc Pairwise(size_t begin, size_t end, const Load& load, const Combine& combine) {
+			if (end - begin <= detail::ReduceLeaf) {
+				Acc acc = load(begin);
+				for (size_t i = begin + 1; i < end; ++i)
+					acc = combine(acc, load(i));
+				return acc;
+			}
+			const size_t mid = begin + (end - begin) / 2;
+			return combine(detail::Pairwise<Acc>(begin, mid, load, combine), detail::Pairwise<Acc>(mid, end, load, combine));
+		}
+
+		/* enumerate the subtrees of detail::Pairwise over [begin; end) at the [depth] (or the leaves above it) in order into [bounds] */
+		inline void ReduceSplit(size_t begin, size_t end, size_t depth, size_t* bounds, size_t& count) {
+			if (depth == 0 || end - begin <= detail::ReduceLeaf) {
+				bounds[count++] = begin;
+				return;
+			}
+			const size_t mid = begin + (end - begin) / 2;
+			detail::ReduceSplit(begin, mid, depth - 1, bounds, count);
+			detail::ReduceSplit(mid, end, depth - 1, bounds, count);
+		}
+
+		/* combine the [results] of the subtrees enumerated by detail::ReduceSplit along the same tree */
+		template <class Acc, class Combine>
+		Acc ReduceJoin(size_t begin, size_t end, size_t depth, const Acc* results, size_t& next, const Combine& combine) {
+			if (depth == 0 || end - begin <= detail::ReduceLeaf)
+				return results[next++];
+			const size_t mid = begin + (end - begin) / 2;
+			const Acc left = detail::ReduceJoin<Acc>(begin, mid, depth - 1, results, next, combine);
+			const Acc right = detail::ReduceJoin<Acc>(mid, end, depth - 1, results, next, combine);
+			return combine(left, right);
+		}
+
+		/* reduce [load(i)] for all [count] items with [combine] in parallel blocks (returns [identity] if empty) */
+		template <class Acc, class Load, class Combine>
+		Acc Reduce(size_t count, size_t threads, const Acc& identity, const Load& load, const Combine& combine) {
+			static constexpr size_t Depth = 6;
+			static constexpr size_t Tasks = size_t(1) << Depth;
+			if (count == 0)
+				return identity;
+			const size_t blocks = (count + detail::ReduceBlock - 1) / detail::ReduceBlock;
+			const auto block = [&](size_t b) {
+				return detail::Pairwise<Acc>(b * detail::ReduceBlock, std::min(count, (b + 1) * detail::ReduceBlock), load, combine);
+			};
+
+			/* the partial results are kept on the stack: either one per block, or one per subtree of the upper levels
+			*	of the tree over the blocks, whose combination follows the same tree and thereby yields identical results */
+			Acc results[Tasks];
+			if (blocks <= Tasks) {
+				num::Parallel(blocks, threads, 4, [&](size_t begin, size_t end, size_t) {
+					for (size_t b = begin; b < end; ++b)
+						results[b] = block(b);
+				});
+				return detail::Pairwise<Acc>(0, blocks, [&](size_t i) { return results[i]; }, combine);
+			}
+			size_t bounds[Tasks + 1], tasks = 0;
+			detail::ReduceSplit(0, blocks, Depth, bounds, tasks);
+			bounds[tasks] = blocks;
+			num::Parallel(tasks, threads, 1, [&](size_t begin, size_t end, size_t) {
+				for (size_t t = begin; t < end; ++t)
+					results[t] = detail::Pairwise<Acc>(bounds[t], bounds[t + 1], block, combine);
+			});
+			size_t next = 0;
+			return detail::ReduceJoin<Acc>(0, blocks, Depth, results, next, combine);
+		}
+
+		/* accumulator of the area weighted centers of triangles */
+		template <std::floating_point Type>
+		struct Weighted {
+			num::Vec<Type> sum;
+			Type weight = 0;
+		};
+	}
+
+	/* compute the sum of all [points] (bitwise reproducible) */
+	template <std::floating_point Type>
+	num::Vec<Type> Sum(std::span<const num::Vec<Type>> points, size_t threads = 0) {
+		return detail::Reduce(points.size(), threads, num::Vec<Type>{},
+			[&](size_t i) { return points[i]; },
+			[](const num::Vec<Type>& a, const num::Vec<Type>& b) { return a + b; });
+	}
+
+	/* compute the centroid of all [points] (bitwise reproducible, zero if empty) */
+	template <std::floating_point Type>
+	num::Vec<Type> Centroid(std::span<const num::Vec<Type>> points, size_t threads = 0) {
+		if (points.empty())
+			return num::Vec<Type>{};
+		return num::Sum(points, threads) / Type(points.size());
+	}
+
+	/* compute the area weighted centroid of all triangles of [planes] (bitwise reproducible, zero if empty or degenerate) */
+	template <std::floating_point Type>
+	num::Vec<Type> Centroid(std::span<const num::Plane<Type>> planes, size_t threads = 0) {
+		using Acc = detail::Weighted<Type>;
+		const Acc acc = detail::Reduce(planes.size(), threads, Acc{},
+			[&](size_t i) { const Type area = planes[i].area(); return Acc{ planes[i].center() * area, area }; },
+			[](const Acc& a, const Acc& b) { return Acc{ a.sum + b.sum, a.weight + b.weight }; });
+		return (acc.weight > 0 ? acc.sum / acc.weight : num::Vec<Type>{});
+	}
+
+	/* compute the total area of all triangles of [planes] (bitwise reproducible) */
+	template <std::floating_point Type>
+	Type Area(std::span<const num::Plane<Type>> planes, size_t threads = 0) {
+		return detail::Reduce(planes.size(), threads, Type(0),
+			[&](size_t i) { return planes[i].area(); },
+			[](Type a, Type b) { return a + b; });
+	}
+
+	/* compute the bounding box of all [points] (empty box if no points) */
+	template <std::floating_point Type>
+	num::Box<Type> Bounds(std::span<const num::Vec<Type>> points, size_t threads = 0) {
+		return detail::Reduce(points.size(), threads, num::Box<Type>{},
+			[&](size_t i) { return num::Box<Type>{ points[i] }; },
+			[](const num::Box<Type>& a, const num::Box<Type>& b) { return a.merge(b); });
+	}
+
+	/* compute the bounding box of all triangles of [planes] (empty box if no planes) */
+	template <std::floating_point Type>
+	num::Box<Type> Bounds(std::span<const num::Plane<Type>> planes, size_t threads = 0) {
+		return detail::Reduce(planes.size(), threads, num::Box<Type>{},
+			[&](size_t i) { return num::Box<Type>{ planes[i].o }.extend(planes[i].o + planes[i].a).extend(planes[i].o + planes[i].b); },
+			[](const num::Box<Type>& a, const num::Box<Type>& b) { return a.merge(b); });
+	}
+
+	/* compute the (population) covariance matrix of all [points] around their centroid (bitwise reproducible, zero if empty) */
+	template <std::floating_point Type>
+	num::Symmetric<Type> Covariance(std::span<const num::Vec<Type>> points, size_t threads = 0) {
+		/* two passes, as the deviations from the centroid are far better conditioned than the raw second moments */
+		if (points.empty())
+			return num::Symmetric<Type>{};
+		const num::Vec<Type> center = num::Centroid(points, threads);
+		const num::Symmetric<Type> sum = detail::Reduce(points.size(), threads, num::Symmetric<Type>{},
+			[&](size_t i) { return num::Symmetric<Type>::Outer(points[i] - center); },
+			[](const num::Symmetric<Type>& a, const num::Symmetric<Type>& b) { return a + b; });
+		return sum / Type(points.size());
+	}
+}
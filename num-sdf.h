@@ -0,0 +1,302 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <vector>
+#include <memory_resource>
+#include <limits>
+#include <type_traits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+
+namespace num {
+	/* regular grid of [nx] x [ny] x [nz] sample points at [origin + (x, y, z) * cell] (stored with x running fastest) */
+	template <std::floating_point Type>
+	struct Voxels {
+	public:
+		num::Vec<Type> origin;
+		Type cell = 1;
+		size_t nx = 0;
+		size_t ny = 0;
+		size_t nz = 0;
+
+	public:
+		constexpr Voxels() = default;
+		constexpr Voxels(const num::Vec<Type>& origin, Type cell, size_t nx, size_t ny, size_t nz) : origin{ origin }, cell{ cell }, nx{ nx }, ny{ ny }, nz{ nz } {}
+
+	public:
+		/* number of sample points of the grid */
+		constexpr size_t size() const {
+			return nx * ny * nz;
+		}
+
+		/* index of the sample point [x, y, z] */
+		constexpr size_t index(size_t x, size_t y, size_t z) const {
+			return (z * ny + y) * nx + x;
+		}
+
+		/* position of the sample point [x, y, z] */
+		constexpr num::Vec<Type> point(size_t x, size_t y, size_t z) const {
+			return origin + num::Vec<Type>{ Type(x), Type(y), Type(z) } *cell;
+		}
+	};
+
+	/*
+	*	Signed distance field of a set of triangles [p0:(p1-p0):(p2-p0)] sampled on a num::Voxels grid
+	*	- the exact distances are computed within a band of one cell around every triangle, and the nearest triangles are
+	*		propagated through the remaining grid by jump flooding (every sample evaluates the exact distance to the candidates,
+	*		but may miss the actual nearest triangle by a small fraction of a cell far off the surface)
+	*	- the sign is negative for samples with a non-zero winding number, which is counted robustly per row of samples along the
+	*		x axis by consistent edge tie-breaking, thereby the triangles must form closed (consistently oriented) surfaces
+	*	- triangles are bucketed into the z-layers of the grid, which are processed in parallel slabs
+	*	- the field is written to a caller-provided float buffer (e.g. a memory mapped file) of at least [Voxels::size] entries,
+	*		and all internal buffers are allocated from the given memory resource and kept across builds
+	*/
+	template <std::floating_point Type>
+	struct Sdf {
+	private:
+		static constexpr uint32_t None = uint32_t(-1);
+		static constexpr int64_t Band = 1;
+		using Wide = std::conditional_t<(sizeof(Type) < sizeof(double)), double, Type>;
+
+	private:
+		std::span<const num::Plane<Type>> pTriangles;
+		num::Voxels<Type> pGrid;
+		std::pmr::vector<size_t> pOffsets;
+		std::pmr::vector<uint32_t> pLayers;
+		std::pmr::vector<uint32_t> pNearest;
+		std::pmr::vector<uint32_t> pSwap;
+		std::pmr::vector<int32_t> pWinding;
+
+	public:
+		explicit Sdf(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pOffsets{ resource }, pLayers{ resource },
+			pNearest{ resource }, pSwap{ resource }, pWinding{ resource } {}
+
+	private:
+		/* compute the squared distance of [p] to the triangle [t] */
+		static constexpr Type fDistance(const num::Plane<Type>& t, const num::Vec<Type>& p) {
+			return t.closestTriangle(p).lenSquared();
+		}
+
+		/* compute the sign of the twice signed area of the origin and [x0, y0] -> [x1, y1] with a consistent
+		*	decision for points exactly on the edge, such that adjacent triangles never both or neither contain it */
+		static constexpr int32_t fOrientation(Wide x0, Wide y0, Wide x1, Wide y1, Wide& area) {
+			area = y0 * x1 - x0 * y1;
+			if (area > 0)
+				return 1;
+			if (area < 0)
+				return -1;
+			if (y1 > y0)
+				return 1;
+			if (y1 < y0)
+				return -1;
+			if (x0 > x1)
+				return 1;
+			if (x0 < x1)
+				return -1;
+			return 0;
+		}
+
+		/* check if the ray along the x axis through [y, z] crosses the triangle [t] and compute its x coordinate and orientation */
+		static constexpr int32_t fCrossing(const num::Plane<Type>& t, Wide y, Wide z, Wide& x) {
+			const Wide y0 = Wide(t.o.y) - y, z0 = Wide(t.o.z) - z;
+			const Wide y1 = y0 + Wide(t.a.y), z1 = z0 + Wide(t.a.z);
+			const Wide y2 = y0 + Wide(t.b.y), z2 = z0 + Wide(t.b.z);
+
+			/* compute the barycentric coordinates of the ray within the projected triangle */
+			Wide a = 0, b = 0, c = 0;
+			const int32_t sign = fOrientation(y1, z1, y2, z2, a);
+			if (sign == 0 || fOrientation(y2, z2, y0, z0, b) != sign || fOrientation(y0, z0, y1, z1, c) != sign)
+				return 0;
+			const Wide sum = a + b + c;
+			x = (a * Wide(t.o.x) + b * (Wide(t.o.x) + Wide(t.a.x)) + c * (Wide(t.o.x) + Wide(t.b.x))) / sum;
+			return sign;
+		}
+
+		/* compute the clamped range of sample indices of a grid axis, which lie within [lo; hi] extended by the band */
+		static void fRange(Type lo, Type hi, Type origin, Type cell, size_t count, size_t& first, size_t& last) {
+			const int64_t _first = int64_t(std::ceil((lo - origin) / cell)) - Band;
+			const int64_t _last = int64_t(std::floor((hi - origin) / cell)) + Band;
+			first = size_t(std::clamp<int64_t>(_first, 0, int64_t(count)));
+			last = size_t(std::clamp<int64_t>(_last + 1, 0, int64_t(count)));
+		}
+
+		/* bucket all triangles into the z-layers, which they affect */
+		void fBucket() {
+			pOffsets.assign(pGrid.nz + 1, 0);
+			for (size_t pass = 0; pass < 2; ++pass) {
+				if (pass == 1) {
+					for (size_t i = 0; i < pGrid.nz; ++i)
+						pOffsets[i + 1] += pOffsets[i];
+					pLayers.resize(pOffsets[pGrid.nz]);
+				}
+
+				for (size_t i = 0; i < pTriangles.size(); ++i) {
+					const num::Plane<Type>& t = pTriangles[i];
+					const Type lo = std::min({ t.o.z, t.o.z + t.a.z, t.o.z + t.b.z });
+					const Type hi = std::max({ t.o.z, t.o.z + t.a.z, t.o.z + t.b.z });
+					size_t first = 0, last = 0;
+					fRange(lo, hi, pGrid.origin.z, pGrid.cell, pGrid.nz, first, last);
+					for (size_t z = first; z < last; ++z) {
+						if (pass == 0)
+							++pOffsets[z + 1];
+						else
+							pLayers[--pOffsets[z + 1]] = uint32_t(i);
+					}
+				}
+			}
+
+			/* the decrementing fill moved every end offset to the start of its layer */
+			for (size_t i = 0; i < pGrid.nz; ++i)
+				pOffsets[i] = pOffsets[i + 1];
+			pOffsets[pGrid.nz] = pLayers.size();
+		}
+
+		/* compute the exact distances of all samples of the layer [z] within the band of its triangles */
+		void fSeed(size_t z, std::span<float> out) {
+			for (size_t k = pOffsets[z]; k < pOffsets[z + 1]; ++k) {
+				const num::Plane<Type>& t = pTriangles[pLayers[k]];
+				size_t x0 = 0, x1 = 0, y0 = 0, y1 = 0;
+				fRange(std::min({ t.o.x, t.o.x + t.a.x, t.o.x + t.b.x }), std::max({ t.o.x, t.o.x + t.a.x, t.o.x + t.b.x }), pGrid.origin.x, pGrid.cell, pGrid.nx, x0, x1);
+				fRange(std::min({ t.o.y, t.o.y + t.a.y, t.o.y + t.b.y }), std::max({ t.o.y, t.o.y + t.a.y, t.o.y + t.b.y }), pGrid.origin.y, pGrid.cell, pGrid.ny, y0, y1);
+
+				for (size_t y = y0; y < y1; ++y) {
+					for (size_t x = x0; x < x1; ++x) {
+						const size_t index = pGrid.index(x, y, z);
+						const Type dist = fDistance(t, pGrid.point(x, y, z));
+						if (dist < Type(out[index])) {
+							out[index] = float(dist);
+							pNearest[index] = pLayers[k];
+						}
+					}
+				}
+			}
+		}
+
+		/* propagate the nearest triangles of the neighbors at distance [step] for all samples of the layer [z] */
+		void fFlood(size_t z, size_t step) {
+			const int64_t s = int64_t(step);
+			for (size_t y = 0; y < pGrid.ny; ++y) {
+				for (size_t x = 0; x < pGrid.nx; ++x) {
+					const size_t index = pGrid.index(x, y, z);
+					const num::Vec<Type> p = pGrid.point(x, y, z);
+					uint32_t best = pNearest[index];
+					Type dist = (best == None ? std::numeric_limits<Type>::infinity() : fDistance(pTriangles[best], p));
+
+					for (int64_t dz = -s; dz <= s; dz += s) {
+						const int64_t _z = int64_t(z) + dz;
+						if (_z < 0 || _z >= int64_t(pGrid.nz))
+							continue;
+						for (int64_t dy = -s; dy <= s; dy += s) {
+							const int64_t _y = int64_t(y) + dy;
+							if (_y < 0 || _y >= int64_t(pGrid.ny))
+								continue;
+							for (int64_t dx = -s; dx <= s; dx += s) {
+								const int64_t _x = int64_t(x) + dx;
+								if (_x < 0 || _x >= int64_t(pGrid.nx))
+									continue;
+
+								const uint32_t next = pNearest[pGrid.index(size_t(_x), size_t(_y), size_t(_z))];
+								if (next == None || next == best)
+									continue;
+								const Type _dist = fDistance(pTriangles[next], p);
+								if (_dist < dist) {
+									dist = _dist;
+									best = next;
+								}
+							}
+						}
+					}
+					pSwap[index] = best;
+				}
+			}
+		}
+
+		/* compute the winding numbers of all rows of the layer [z] and write the final signed distances */
+		void fSign(size_t z, std::span<float> out, int32_t* winding) {
+			const size_t stride = pGrid.nx + 1;
+			std::fill(winding, winding + stride * pGrid.ny, 0);
+			const Wide _z = Wide(pGrid.origin.z) + Wide(z) * Wide(pGrid.cell);
+
+			/* register the crossings of every triangle at the first sample behind them */
+			for (size_t k = pOffsets[z]; k < pOffsets[z + 1]; ++k) {
+				const num::Plane<Type>& t = pTriangles[pLayers[k]];
+				size_t y0 = 0, y1 = 0;
+				fRange(std::min({ t.o.y, t.o.y + t.a.y, t.o.y + t.b.y }), std::max({ t.o.y, t.o.y + t.a.y, t.o.y + t.b.y }), pGrid.origin.y, pGrid.cell, pGrid.ny, y0, y1);
+
+				for (size_t y = y0; y < y1; ++y) {
+					Wide x = 0;
+					const int32_t sign = fCrossing(t, Wide(pGrid.origin.y) + Wide(y) * Wide(pGrid.cell), _z, x);
+					if (sign == 0)
+						continue;
+					const Wide first = std::ceil((x - Wide(pGrid.origin.x)) / Wide(pGrid.cell));
+					const size_t _x = (first <= 0 ? 0 : size_t(std::min<Wide>(first, Wide(pGrid.nx))));
+					winding[y * stride + _x] += sign;
+				}
+			}
+
+			/* accumulate the crossings along the rows and apply the sign to the distances */
+			for (size_t y = 0; y < pGrid.ny; ++y) {
+				int32_t count = 0;
+				for (size_t x = 0; x < pGrid.nx; ++x) {
+					count += winding[y * stride + x];
+					const size_t index = pGrid.index(x, y, z);
+					const uint32_t best = pNearest[index];
+					const float dist = (best == None ? std::numeric_limits<float>::infinity() : float(num::Sqrt(fDistance(pTriangles[best], pGrid.point(x, y, z)))));
+					out[index] = (count != 0 ? -dist : dist);
+				}
+			}
+		}
+
+	public:
+		/* build the signed distance field of the [triangles] (at most 2^32 - 1) sampled on [grid] into [out] (returns false if [out] is too small or the grid is empty) */
+		bool build(std::span<const num::Plane<Type>> triangles, const num::Voxels<Type>& grid, std::span<float> out, size_t threads = 0) {
+			if (grid.size() == 0 || out.size() < grid.size() || !(grid.cell > 0) || triangles.size() >= size_t(None))
+				return false;
+			pTriangles = triangles;
+			pGrid = grid;
+			out = out.subspan(0, grid.size());
+
+			/* bucket the triangles and compute the exact distances within the band (out is used to hold the squared distances) */
+			fBucket();
+			pNearest.assign(grid.size(), None);
+			pSwap.resize(grid.size());
+			std::fill(out.begin(), out.end(), std::numeric_limits<float>::infinity());
+			num::Parallel(grid.nz, threads, 1, [&](size_t begin, size_t end, size_t) {
+				for (size_t z = begin; z < end; ++z)
+					fSeed(z, out);
+			});
+
+			/* propagate the nearest triangles with halving steps followed by an additional pass of step one */
+			size_t step = 1;
+			while (step * 2 < std::max({ grid.nx, grid.ny, grid.nz }))
+				step *= 2;
+			for (bool extra = false;;) {
+				num::Parallel(grid.nz, threads, 1, [&](size_t begin, size_t end, size_t) {
+					for (size_t z = begin; z < end; ++z)
+						fFlood(z, step);
+				});
+				std::swap(pNearest, pSwap);
+				if (step > 1)
+					step /= 2;
+				else if (!extra)
+					extra = true;
+				else
+					break;
+			}
+
+			/* compute the winding numbers and the final signed distances with a separate row buffer per chunk */
+			const size_t rows = (grid.nx + 1) * grid.ny;
+			pWinding.resize(num::ParallelChunks(grid.nz, threads, 1) * rows);
+			num::Parallel(grid.nz, threads, 1, [&](size_t begin, size_t end, size_t chunk) {
+				for (size_t z = begin; z < end; ++z)
+					fSign(z, out, pWinding.data() + chunk * rows);
+			});
+			return true;
+		}
+	};
+}
@@ -0,0 +1,313 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <limits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+namespace num {
+	/* defines the range of factors along the direction, which belong to a bounded line */
+	enum Extent : uint8_t {
+		ExtentRay = 0,
+		ExtentSegment = 1,
+	};
+
+	/*
+	*	Line bounded at its origin (ray: factors [0; inf)) or at its origin and its end (segment: factors [0; 1], i.e. [o] to [o + d])
+	*	- inherits all operations of num::Line, of which the closest/intersect operations are replaced by bounded versions
+	*	- hits outside of the range are rejected before the full solution is computed wherever possible
+	*/
+	template <std::floating_point Type, num::Extent Ext>
+	struct Bounded : public num::Line<Type> {
+		using num::Line<Type>::o;
+		using num::Line<Type>::d;
+		using num::Line<Type>::point;
+
+	public:
+		/* largest valid factor along the direction */
+		static constexpr Type Upper = (Ext == num::ExtentSegment ? Type(1) : std::numeric_limits<Type>::infinity());
+
+	public:
+		constexpr Bounded() = default;
+		constexpr Bounded(const num::Vec<Type>& d) : num::Line<Type>{ d } {}
+		constexpr Bounded(const num::Vec<Type>& o, const num::Vec<Type>& d) : num::Line<Type>{ o, d } {}
+		constexpr explicit Bounded(const num::Line<Type>& l) : num::Line<Type>{ l } {}
+
+	private:
+		/* clamp [v] into [lo; hi] like std::clamp (written as two independent selects, which the vectorizer converts into blends) */
+		static constexpr Type fClamp(Type v, Type lo, Type hi) {
+			const Type c = (v < lo ? lo : v);
+			return (hi < v ? hi : c);
+		}
+
+		/* compute the factors of the closest points of [o0 + s * d0] and [o1 + t * d1] with s in [l0; u0] and t in [l1; u1] */
+		static NUM_KERNEL constexpr num::Linear<Type> fClosest(const num::Vec<Type>& o0, const num::Vec<Type>& d0, Type l0, Type u0, const num::Vec<Type>& o1, const num::Vec<Type>& d1, Type l1, Type u1) {
+			/*
+			*	minimize |(o0 + s * d0) - (o1 + t * d1)|^2 for s and then for t and
+			*	recompute s whenever t had to be clamped into its range (Ericson, 5.1.9)
+			*	all cases are evaluated and selected without branches, such that the batches of num::Capsule vectorize
+			*	(the divisions of the discarded cases are evaluated as well, see detail::Divisor)
+			*/
+			const num::Vec<Type> r = o0 - o1;
+			const Type a = d0.dot(d0), e = d1.dot(d1), f = d1.dot(r), c = d0.dot(r), b = d0.dot(d1);
+			const bool zeroA = num::Zero(a), zeroE = num::Zero(e);
+			const Type da = detail::Divisor(a, zeroA), de = detail::Divisor(e, zeroE);
+
+			/* compute the unbounded solution for s (parallel lines start at the closest point to the other origin) */
+			const Type denom = a * e - b * b;
+			const bool parallel = (denom <= a * e * num::Const<Type>::Precision);
+			const Type start = fClamp(0, l0, u0), free = fClamp((b * f - c * e) / detail::Divisor(denom, parallel), l0, u0);
+			Type s = (parallel ? start : free);
+			Type t = (b * s + f) / de;
+			const bool outside = (t < l1) | (t > u1);
+			const Type clamped = fClamp(t, l1, u1), recomputed = fClamp((b * clamped - c) / da, l0, u0);
+			s = (outside ? recomputed : s);
+			t = (outside ? clamped : t);
+
+			/* degenerate directions start at their origin or at the closest point to the other origin */
+			const Type first = fClamp(-c / da, l0, u0), second = fClamp(f / de, l1, u1), origin = fClamp(0, l1, u1);
+			const bool degenerate = (zeroA | zeroE);
+			s = (degenerate ? (zeroA ? start : first) : s);
+			t = (degenerate ? (zeroE ? origin : second) : t);
+			return num::Linear<Type>{ s, t };
+		}
+
+		/* compute the signed distance of the origin and the distance covered by the direction towards the plane [p] and
+		*	check if the range can reach the plane at all (early rejection before the intersection is solved) */
+		constexpr bool fReaches(const num::Vec<Type>& n, const num::Vec<Type>& po, Type& dist, Type& dir, Type precision) const {
+			dist = n.dot(o - po);
+			dir = n.dot(d);
+			if constexpr (Ext == num::ExtentSegment)
+				return !(dist > precision && dist + dir > precision) && !(dist < -precision && dist + dir < -precision);
+			else
+				return !(dist > precision && dir >= 0) && !(dist < -precision && dir <= 0);
+		}
+
+	public:
+		/* check if the factor [f] lies within the range of [this] */
+		constexpr bool inRange(Type f, Type precision = num::Const<Type>::Precision) const {
+			return f >= -precision && f <= Upper + precision;
+		}
+
+		/* clamp the factor [f] to the range of [this] */
+		constexpr Type clamp(Type f) const {
+			return fClamp(f, 0, Upper);
+		}
+
+		/* check if [p] lies on the bounded line [this] */
+		constexpr bool touch(const num::Vec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			return num::Line<Type>::touch(p, precision) && inRange(num::Line<Type>::find(p), precision);
+		}
+
+		/* compute the factor for which [this] reaches the point closest to [p] within its range */
+		constexpr Type closestf(const num::Vec<Type>& p) const {
+			return clamp(num::Line<Type>::closestf(p));
+		}
+
+		/* compute the shortest vector which connects [p] to a point on [this] within its range */
+		constexpr num::Vec<Type> closest(const num::Vec<Type>& p) const {
+			return point(closestf(p)) - p;
+		}
+
+		/* compute the factors of the points on [this] and the line [l] within their ranges, which are closest to each other */
+		constexpr num::Linear<Type> closestf(const num::Line<Type>& l) const {
+			constexpr Type inf = std::numeric_limits<Type>::infinity();
+			return fClosest(o, d, 0, Upper, l.o, l.d, -inf, inf);
+		}
+
+		/* compute the factors of the points on [this] and the bounded line [l] within their ranges, which are closest to each other */
+		template <num::Extent OExt>
+		constexpr num::Linear<Type> closestf(const num::Bounded<Type, OExt>& l) const {
+			return fClosest(o, d, 0, Upper, l.o, l.d, 0, num::Bounded<Type, OExt>::Upper);
+		}
+
+		/* compute the shortest line which connects [this] and the line [l] within their ranges (origin on [this]) */
+		constexpr num::Line<Type> closest(const num::Line<Type>& l) const {
+			const num::Linear<Type> f = closestf(l);
+			return num::Line<Type>{ point(f.s), l.point(f.t) - point(f.s) };
+		}
+
+		/* compute the shortest line which connects [this] and the bounded line [l] within their ranges (origin on [this]) */
+		template <num::Extent OExt>
+		constexpr num::Line<Type> closest(const num::Bounded<Type, OExt>& l) const {
+			const num::Linear<Type> f = closestf(l);
+			return num::Line<Type>{ point(f.s), l.point(f.t) - point(f.s) };
+		}
+
+		/* compute the factors to scale [this] and the bounded line [l] with to intersect within their ranges (invalid if no intersection point: returns 0, 0) */
+		template <num::Extent OExt>
+		constexpr num::Linear<Type> intersectf(const num::Bounded<Type, OExt>& l, bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			/* reject segments, whose bounding boxes do not overlap, before solving */
+			bool on = true;
+			if constexpr (Ext == num::ExtentSegment && OExt == num::ExtentSegment) {
+				for (size_t i = 0; i < 3 && on; ++i) {
+					const Type lo0 = std::min(o[i], o[i] + d[i]), hi0 = std::max(o[i], o[i] + d[i]);
+					const Type lo1 = std::min(l.o[i], l.o[i] + l.d[i]), hi1 = std::max(l.o[i], l.o[i] + l.d[i]);
+					on = (lo0 <= hi1 + precision && lo1 <= hi0 + precision);
+				}
+			}
+
+			/* compute the closest points and check if they are identical */
+			num::Linear<Type> f{};
+			if (on) {
+				f = closestf(l);
+				on = point(f.s).identical(l.point(f.t), precision);
+			}
+			if (invalid)
+				*invalid = !on;
+			return on ? f : num::Linear<Type>{};
+		}
+
+		/* compute the intersection point of [this] and the bounded line [l] within their ranges (invalid if no intersection point: returns [this] origin) */
+		template <num::Extent OExt>
+		constexpr num::Vec<Type> intersect(const num::Bounded<Type, OExt>& l, bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			return point(intersectf(l, invalid, precision).s);
+		}
+
+		/* compute the factor to scale [this] with to reach the plane [p] within its range (invalid if parallel or out of range: returns 0) */
+		constexpr Type intersectf(const num::Plane<Type>& p, bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			Type dist = 0, dir = 0;
+			const bool hit = fReaches(p.normal(), p.o, dist, dir, precision) && num::Abs(dir) > precision;
+			const Type f = (hit ? -dist / dir : 0);
+			const bool on = hit && inRange(f, precision);
+			if (invalid)
+				*invalid = !on;
+			return on ? f : 0;
+		}
+
+		/* compute the intersection point of [this] and the plane [p] within its range (invalid if parallel or out of range: returns [this] origin) */
+		constexpr num::Vec<Type> intersect(const num::Plane<Type>& p, bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			return point(intersectf(p, invalid, precision));
+		}
+
+		/* compute the factor to scale [this] with to reach the triangle of plane [p] within its range (invalid if no intersection: returns 0) */
+		constexpr Type intersectTrianglef(const num::Plane<Type>& p, bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			/*
+			*	reject ranges, which do not reach the plane, and otherwise solve
+			*	o + f * d = p.o + u * p.a + v * p.b (Moeller-Trumbore) with early
+			*	rejection of the barycentric coordinates one after another
+			*/
+			Type dist = 0, dir = 0, f = 0;
+			bool on = fReaches(p.normal(), p.o, dist, dir, precision);
+			if (on) {
+				const num::Vec<Type> pv = d.cross(p.b);
+				const Type det = p.a.dot(pv);
+				on = (num::Abs(det) > precision);
+				if (on) {
+					const num::Vec<Type> tv = o - p.o;
+					const Type u = tv.dot(pv) / det;
+					on = (u >= -precision && u <= 1 + precision);
+					if (on) {
+						const num::Vec<Type> qv = tv.cross(p.a);
+						const Type v = d.dot(qv) / det;
+						f = p.b.dot(qv) / det;
+						on = (v >= -precision && u + v <= 1 + precision && inRange(f, precision));
+					}
+				}
+			}
+			if (invalid)
+				*invalid = !on;
+			return on ? f : 0;
+		}
+
+		/* compute the intersection point of [this] and the triangle of plane [p] within its range (invalid if no intersection: returns [this] origin) */
+		constexpr num::Vec<Type> intersectTriangle(const num::Plane<Type>& p, bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			return point(intersectTrianglef(p, invalid, precision));
+		}
+
+	public:
+		/* test all [items] against the plane [p] and write the hit flags to [hits] (returns the number of hits) */
+		static size_t PlaneHits(std::span<const num::Bounded<Type, Ext>> items, const num::Plane<Type>& p, std::span<uint8_t> hits, Type precision = num::Const<Type>::Precision, size_t threads = 0) {
+			const num::Vec<Type> n = p.normal();
+			return detail::CountHits(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				/* copy the captured values, as the byte stores could otherwise alias them and prevent vectorization */
+				const num::Bounded<Type, Ext>* data = items.data();
+				const num::Vec<Type> origin = p.o, normal = n;
+				const Type tol = precision;
+				uint8_t* flags = hits.data();
+				detail::VecLanes<Type> o, d;
+				size_t count = 0;
+
+				/* transpose every block of lines and evaluate all conditions on it without branches, which vectorizes the second loop */
+				for (size_t block = begin; block < end; block += detail::BatchBlock) {
+					const size_t size = std::min(detail::BatchBlock, end - block);
+					for (size_t i = 0; i < size; ++i) {
+						o.set(i, data[block + i].o);
+						d.set(i, data[block + i].d);
+					}
+					uint8_t* out = flags + block;
+					for (size_t i = 0; i < size; ++i) {
+						const Type dist = normal.dot(o[i] - origin), dir = normal.dot(d[i]);
+						bool hit = false;
+						if constexpr (Ext == num::ExtentSegment)
+							hit = (dist * (dist + dir) <= tol * tol) & (num::Abs(dir) > tol);
+						else
+							hit = (dist * dir <= 0) & (num::Abs(dir) > tol);
+						out[i] = uint8_t(hit);
+						count += size_t(hit);
+					}
+				}
+				return count;
+			});
+		}
+
+		/* test all [items] against the triangle of plane [p] and write the hit flags to [hits] (returns the number of hits) */
+		static size_t TriangleHits(std::span<const num::Bounded<Type, Ext>> items, const num::Plane<Type>& p, std::span<uint8_t> hits, Type precision = num::Const<Type>::Precision, size_t threads = 0) {
+			return detail::CountHits(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				/* copy the captured values, as the byte stores could otherwise alias them and prevent vectorization */
+				const num::Bounded<Type, Ext>* data = items.data();
+				const num::Plane<Type> plane = p;
+				const Type eps = precision;
+				uint8_t* flags = hits.data();
+				detail::VecLanes<Type> o, d;
+				size_t count = 0;
+
+				/* transpose every block of lines and evaluate all conditions on it without branches, which vectorizes the second loop */
+				for (size_t block = begin; block < end; block += detail::BatchBlock) {
+					const size_t size = std::min(detail::BatchBlock, end - block);
+					for (size_t i = 0; i < size; ++i) {
+						o.set(i, data[block + i].o);
+						d.set(i, data[block + i].d);
+					}
+					uint8_t* out = flags + block;
+					for (size_t i = 0; i < size; ++i) {
+						const num::Vec<Type> pv = d[i].cross(plane.b), tv = o[i] - plane.o, qv = tv.cross(plane.a);
+						const Type det = plane.a.dot(pv);
+						const Type u = tv.dot(pv), v = d[i].dot(qv), f = plane.b.dot(qv);
+
+						/* compare the scaled barycentric coordinates in order to avoid the divisions */
+						const Type sign = (det < 0 ? Type(-1) : Type(1)), adet = det * sign, tol = eps * adet;
+						const Type su = u * sign, sv = v * sign, sf = f * sign;
+						bool hit = (adet > eps) & (su >= -tol) & (sv >= -tol) & (su + sv <= adet + tol) & (sf >= -tol);
+						if constexpr (Ext == num::ExtentSegment)
+							hit = hit & (sf <= adet + tol);
+						out[i] = uint8_t(hit);
+						count += size_t(hit);
+					}
+				}
+				return count;
+			});
+		}
+
+		/* compute the factors of the points on all [items] closest to [p] into [factors] */
+		static void Closest(std::span<const num::Bounded<Type, Ext>> items, const num::Vec<Type>& p, std::span<Type> factors, size_t threads = 0) {
+			num::ParallelDispatch(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					factors[i] = items[i].closestf(p);
+			});
+		}
+	};
+
+	template <std::floating_point Type>
+	using Ray = num::Bounded<Type, num::ExtentRay>;
+
+	template <std::floating_point Type>
+	using Segment = num::Bounded<Type, num::ExtentSegment>;
+}
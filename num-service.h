@@ -0,0 +1,409 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-dispatch.h"
+
+/*
+*	Asynchronous front end, which collects single geometry queries from many threads into micro-batches
+*	- every query returns a std::future, which is resolved once the batch containing the query has been evaluated
+*	- queries are batched per kind and a batch is evaluated as soon as it reaches the batch size, or once its
+*		oldest query has waited for the deadline, thereby bounding the added latency under low load
+*	- batches are evaluated on the worker threads of the service, which transpose them block by block into separate
+*		component arrays and evaluate every kind by a branch-free NUM_KERNEL loop compiled and vectorized for the active
+*		instruction set (see num-dispatch.h), and the results are identical to calling the operations directly
+*	- the latency from submission to resolution of every query is recorded in a log-linear histogram
+*	- as the service owns its worker threads, it is not included through vec.h, but must be included explicitly
+*/
+namespace num {
+	/* latency statistics of the resolved queries in nanoseconds (percentiles overestimate by less than 12.5%) */
+	struct QueryLatency {
+		uint64_t queries = 0;
+		uint64_t batches = 0;
+		double mean = 0;
+		uint64_t p50 = 0;
+		uint64_t p90 = 0;
+		uint64_t p99 = 0;
+		uint64_t p999 = 0;
+		uint64_t max = 0;
+	};
+
+	namespace detail {
+		/* histogram with 8 linear sub-buckets per power of two */
+		struct LatencyHistogram {
+		private:
+			static constexpr size_t Buckets = 62 * 8;
+
+		private:
+			std::array<uint64_t, Buckets> pCounts{};
+			uint64_t pQueries = 0;
+			uint64_t pBatches = 0;
+			uint64_t pMax = 0;
+			long double pSum = 0;
+
+		private:
+			static constexpr size_t fIndex(uint64_t v) {
+				if (v < 8)
+					return size_t(v);
+				const size_t exp = size_t(std::bit_width(v)) - 1;
+				return (exp - 2) * 8 + size_t((v >> (exp - 3)) & 7);
+			}
+			static constexpr uint64_t fUpper(size_t index) {
+				if (index < 8)
+					return index;
+				const size_t exp = index / 8 + 2, sub = index % 8;
+				return ((uint64_t(9 + sub) << (exp - 3)) - 1);
+			}
+
+		public:
+			void add(uint64_t nanoseconds) {
+				++pCounts[fIndex(nanoseconds)];
+				++pQueries;
+				pSum += nanoseconds;
+				pMax = std::max(pMax, nanoseconds);
+			}
+			void batch() {
+				++pBatches;
+			}
+			num::QueryLatency stats() const {
+				num::QueryLatency out;
+				out.queries = pQueries;
+				out.batches = pBatches;
+				out.max = pMax;
+				if (pQueries == 0)
+					return out;
+				out.mean = double(pSum / pQueries);
+
+				/* smallest bucket, which covers the given fraction of all queries */
+				const auto percentile = [&](uint64_t perMille) -> uint64_t {
+					const uint64_t target = std::max<uint64_t>(1, (pQueries * perMille + 999) / 1000);
+					uint64_t sum = 0;
+					for (size_t i = 0; i < Buckets; ++i) {
+						if ((sum += pCounts[i]) >= target)
+							return std::min(fUpper(i), pMax);
+					}
+					return pMax;
+				};
+				out.p50 = percentile(500);
+				out.p90 = percentile(900);
+				out.p99 = percentile(990);
+				out.p999 = percentile(999);
+				return out;
+			}
+		};
+	}
+
+	template <std::floating_point Type>
+	struct QueryService {
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct IntersectQuery {
+			num::Plane<Type> plane;
+			num::Line<Type> line;
+			Type precision = 0;
+		};
+		struct ClosestQuery {
+			num::Line<Type> line;
+			num::Vec<Type> point;
+		};
+		struct TriangleQuery {
+			num::Plane<Type> plane;
+			num::Vec<Type> point;
+			Type precision = 0;
+		};
+
+		template <class Query, class Result>
+		struct Pending {
+			Query query;
+			std::promise<Result> promise;
+			Clock::time_point submitted;
+		};
+
+		template <class Query, class Result>
+		using Queue = std::vector<Pending<Query, Result>>;
+
+	private:
+		Queue<IntersectQuery, std::optional<num::Vec<Type>>> pIntersect;
+		Queue<ClosestQuery, num::Vec<Type>> pClosest;
+		Queue<TriangleQuery, bool> pTriangle;
+		std::vector<std::thread> pWorkers;
+		std::mutex pMutex;
+		std::condition_variable pCondition;
+		std::mutex pMetricsMutex;
+		detail::LatencyHistogram pMetrics;
+		Clock::duration pDeadline;
+		size_t pBatchSize = 0;
+		bool pStop = false;
+
+	public:
+		/* create the service with [workers] threads (zero selects the hardware concurrency), which evaluate batches
+		*	once they contain [batchSize] queries, or once their oldest query has waited for [deadline] */
+		explicit QueryService(size_t workers = 1, size_t batchSize = 256, std::chrono::microseconds deadline = std::chrono::microseconds{ 100 }) : pDeadline{ deadline }, pBatchSize{ std::max<size_t>(batchSize, 1) } {
+			workers = num::Threads(workers);
+			pWorkers.reserve(workers);
+			for (size_t i = 0; i < workers; ++i)
+				pWorkers.emplace_back([this]() { fWorker(); });
+		}
+		QueryService(const num::QueryService<Type>&) = delete;
+		num::QueryService<Type>& operator=(const num::QueryService<Type>&) = delete;
+
+		/* resolve all pending queries and stop the workers */
+		~QueryService() {
+			{
+				std::lock_guard<std::mutex> lock{ pMutex };
+				pStop = true;
+			}
+			pCondition.notify_all();
+			for (std::thread& worker : pWorkers)
+				worker.join();
+		}
+
+	private:
+		template <class Query, class Result>
+		std::future<Result> fSubmit(Queue<Query, Result>& queue, const Query& query) {
+			std::promise<Result> promise;
+			std::future<Result> future = promise.get_future();
+			size_t size = 0;
+			{
+				std::lock_guard<std::mutex> lock{ pMutex };
+				queue.push_back(Pending<Query, Result>{ query, std::move(promise), Clock::now() });
+				size = queue.size();
+			}
+
+			/* wake a worker to either schedule the deadline of the new batch or to evaluate the full batch */
+			if (size == 1 || size >= pBatchSize)
+				pCondition.notify_one();
+			return future;
+		}
+
+		/* submission time of the oldest query of [queue] if its batch is full, has reached its deadline, or the service is stopping */
+		template <class Query, class Result>
+		Clock::time_point fReady(const Queue<Query, Result>& queue, Clock::time_point now, Clock::time_point& wake) const {
+			if (queue.empty())
+				return Clock::time_point::max();
+			const Clock::time_point deadline = queue.front().submitted + pDeadline;
+			if (queue.size() < pBatchSize && now < deadline && !pStop) {
+				wake = std::min(wake, deadline);
+				return Clock::time_point::max();
+			}
+			return queue.front().submitted;
+		}
+
+		/* move the next batch out of [queue] (wakes another worker for the remaining queries) */
+		template <class Query, class Result>
+		void fTake(Queue<Query, Result>& queue, Queue<Query, Result>& batch) {
+			const size_t count = std::min(queue.size(), pBatchSize);
+			batch.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.begin() + count));
+			queue.erase(queue.begin(), queue.begin() + count);
+			if (!queue.empty())
+				pCondition.notify_one();
+		}
+
+		/* evaluate [kernel(queries, results, begin, end)] over the batch and resolve the promises */
+		template <class Query, class Result, class Raw, class Kernel>
+		void fEvaluate(Queue<Query, Result>& batch, std::vector<Query>& queries, std::vector<Raw>& results, const Kernel& kernel) {
+			queries.clear();
+			for (const Pending<Query, Result>& pending : batch)
+				queries.push_back(pending.query);
+			results.resize(batch.size());
+			num::Dispatch([&](size_t begin, size_t end) NUM_KERNEL {
+				kernel(queries.data(), results.data(), begin, end);
+			}, size_t(0), batch.size());
+
+			for (size_t i = 0; i < batch.size(); ++i) {
+				if constexpr (std::is_same_v<Result, std::optional<num::Vec<Type>>>)
+					batch[i].promise.set_value(results[i].valid ? Result{ results[i].point } : Result{});
+				else
+					batch[i].promise.set_value(Result(results[i]));
+			}
+
+			const Clock::time_point now = Clock::now();
+			std::lock_guard<std::mutex> lock{ pMetricsMutex };
+			for (const Pending<Query, Result>& pending : batch)
+				pMetrics.add(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now - pending.submitted).count()));
+			pMetrics.batch();
+			batch.clear();
+		}
+
+		void fWorker() {
+			struct Hit {
+				num::Vec<Type> point;
+				bool valid = false;
+			};
+			Queue<IntersectQuery, std::optional<num::Vec<Type>>> intersect;
+			Queue<ClosestQuery, num::Vec<Type>> closest;
+			Queue<TriangleQuery, bool> triangle;
+			std::vector<IntersectQuery> intersectQueries;
+			std::vector<ClosestQuery> closestQueries;
+			std::vector<TriangleQuery> triangleQueries;
+			std::vector<Hit> hits;
+			std::vector<num::Vec<Type>> points;
+			std::vector<uint8_t> flags;
+
+			std::unique_lock<std::mutex> lock{ pMutex };
+			while (true) {
+				const Clock::time_point now = Clock::now();
+				Clock::time_point wake = Clock::time_point::max();
+
+				/* evaluate the ready batch with the oldest query (one batch at a time to allow other workers to pick up the remaining batches) */
+				const Clock::time_point ready[3] = { fReady(pIntersect, now, wake), fReady(pClosest, now, wake), fReady(pTriangle, now, wake) };
+				const size_t next = size_t(std::min_element(ready, ready + 3) - ready);
+				if (ready[next] != Clock::time_point::max()) {
+					if (next == 0) {
+						fTake(pIntersect, intersect);
+						lock.unlock();
+						fEvaluate(intersect, intersectQueries, hits, [](const IntersectQuery* q, Hit* out, size_t begin, size_t end) NUM_KERNEL {
+							detail::VecLanes<Type> po, pa, pb, lo, ld, point;
+							Type precision[detail::BatchBlock];
+							uint8_t valid[detail::BatchBlock];
+							for (size_t block = begin; block < end; block += detail::BatchBlock) {
+								const size_t size = std::min(detail::BatchBlock, end - block);
+								for (size_t i = 0; i < size; ++i) {
+									const IntersectQuery& query = q[block + i];
+									po.set(i, query.plane.o);
+									pa.set(i, query.plane.a);
+									pb.set(i, query.plane.b);
+									lo.set(i, query.line.o);
+									ld.set(i, query.line.d);
+									precision[i] = query.precision;
+								}
+
+								/* num::Plane::intersect with the parallel check as selection instead of a branch */
+								for (size_t i = 0; i < size; ++i) {
+									const num::Vec<Type> crs = pa[i].cross(pb[i]), o = lo[i], d = ld[i];
+									const Type f = (po[i] - o).dot(crs) / d.dot(crs);
+									point.set(i, o + d * f);
+									valid[i] = uint8_t(!(num::Abs(crs.dot(d)) <= precision[i]));
+								}
+								for (size_t i = 0; i < size; ++i) {
+									out[block + i].point = point[i];
+									out[block + i].valid = (valid[i] != 0);
+								}
+							}
+						});
+					}
+					else if (next == 1) {
+						fTake(pClosest, closest);
+						lock.unlock();
+						fEvaluate(closest, closestQueries, points, [](const ClosestQuery* q, num::Vec<Type>* out, size_t begin, size_t end) NUM_KERNEL {
+							detail::VecLanes<Type> lo, ld, pt, closest;
+							for (size_t block = begin; block < end; block += detail::BatchBlock) {
+								const size_t size = std::min(detail::BatchBlock, end - block);
+								for (size_t i = 0; i < size; ++i) {
+									lo.set(i, q[block + i].line.o);
+									ld.set(i, q[block + i].line.d);
+									pt.set(i, q[block + i].point);
+								}
+
+								/* num::Line::closest */
+								for (size_t i = 0; i < size; ++i) {
+									const num::Vec<Type> o = lo[i], d = ld[i], p = pt[i];
+									const Type f = (p - o).dot(d) / d.dot(d);
+									closest.set(i, (o + d * f) - p);
+								}
+								for (size_t i = 0; i < size; ++i)
+									out[block + i] = closest[i];
+							}
+						});
+					}
+					else {
+						fTake(pTriangle, triangle);
+						lock.unlock();
+						fEvaluate(triangle, triangleQueries, flags, [](const TriangleQuery* q, uint8_t* out, size_t begin, size_t end) NUM_KERNEL {
+							detail::VecLanes<Type> po, pa, pb, pt;
+							Type precision[detail::BatchBlock];
+							for (size_t block = begin; block < end; block += detail::BatchBlock) {
+								const size_t size = std::min(detail::BatchBlock, end - block);
+								for (size_t i = 0; i < size; ++i) {
+									const TriangleQuery& query = q[block + i];
+									po.set(i, query.plane.o);
+									pa.set(i, query.plane.a);
+									pb.set(i, query.plane.b);
+									pt.set(i, query.point);
+									precision[i] = query.precision;
+								}
+
+								/* num::Plane::inTriangle with the ignored axis (smallest normal component like num::Vec::comp) as selection instead of an index */
+								uint8_t* flags = out + block;
+								for (size_t i = 0; i < size; ++i) {
+									const num::Vec<Type> a = pa[i], b = pb[i], v = pt[i] - po[i], n = a.cross(b);
+									const bool first = (num::Abs(n.x) > num::Abs(n.y)), last = ((first ? num::Abs(n.y) : num::Abs(n.x)) > num::Abs(n.z));
+
+									/* select the axes of index one over zero and then of index two (nested selections are not if-converted) */
+									Type a0 = (first ? a.z : a.y), a1 = (first ? a.x : a.z), b0 = (first ? b.z : b.y), b1 = (first ? b.x : b.z), v0 = (first ? v.z : v.y), v1 = (first ? v.x : v.z);
+									a0 = (last ? a.x : a0);
+									a1 = (last ? a.y : a1);
+									b0 = (last ? b.x : b0);
+									b1 = (last ? b.y : b1);
+									v0 = (last ? v.x : v0);
+									v1 = (last ? v.y : v1);
+									const Type divisor = a0 * b1 - a1 * b0;
+									const Type s = (v0 * b1 - v1 * b0) / divisor, t = (a0 * v1 - a1 * v0) / divisor;
+									flags[i] = uint8_t((s >= -precision[i]) & (t >= -precision[i]) & ((s + t) <= (1 + precision[i])));
+								}
+							}
+						});
+					}
+					lock.lock();
+					continue;
+				}
+
+				/* stop once all queries have been taken, or wait for new queries or the earliest deadline */
+				if (pStop)
+					return;
+				if (wake == Clock::time_point::max())
+					pCondition.wait(lock);
+				else
+					pCondition.wait_until(lock, wake);
+			}
+		}
+
+	public:
+		/* asynchronous num::Plane::intersect of the [plane] and the [line] (empty if they are parallel) */
+		std::future<std::optional<num::Vec<Type>>> intersect(const num::Plane<Type>& plane, const num::Line<Type>& line, Type precision = num::Const<Type>::Precision) {
+			return fSubmit(pIntersect, IntersectQuery{ plane, line, precision });
+		}
+
+		/* asynchronous num::Line::closest of the [line] to the [point] */
+		std::future<num::Vec<Type>> closest(const num::Line<Type>& line, const num::Vec<Type>& point) {
+			return fSubmit(pClosest, ClosestQuery{ line, point });
+		}
+
+		/* asynchronous num::Plane::inTriangle of the [point] for the triangle [plane] */
+		std::future<bool> inTriangle(const num::Plane<Type>& plane, const num::Vec<Type>& point, Type precision = num::Const<Type>::Precision) {
+			return fSubmit(pTriangle, TriangleQuery{ plane, point, precision });
+		}
+
+	public:
+		/* latency statistics of all queries resolved since the construction or the last reset */
+		num::QueryLatency latency() {
+			std::lock_guard<std::mutex> lock{ pMetricsMutex };
+			return pMetrics.stats();
+		}
+
+		/* reset the latency statistics */
+		void resetLatency() {
+			std::lock_guard<std::mutex> lock{ pMetricsMutex };
+			pMetrics = detail::LatencyHistogram{};
+		}
+	};
+
+	using QueryServicef = num::QueryService<float>;
+	using QueryServiced = num::QueryService<double>;
+}
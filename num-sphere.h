@@ -0,0 +1,177 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <limits>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-segment.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+namespace num {
+	namespace detail {
+		/* compute the terms [dd] and [b] of the quadratic, whose roots are the factors for which [o + t * d] has the distance [r] to the point [c] (returns its discriminant) */
+		template <std::floating_point Type>
+		NUM_KERNEL constexpr Type SphereTerms(const num::Vec<Type>& c, Type r, const num::Vec<Type>& o, const num::Vec<Type>& d, Type& dd, Type& b) {
+			/* (o - c + t * d)^2 = r^2 -> dd * t^2 + 2 * b * t + cc = 0 */
+			const num::Vec<Type> oc = o - c;
+			dd = d.dot(d);
+			b = oc.dot(d);
+			const Type cc = oc.dot(oc) - r * r;
+			return b * b - dd * cc;
+		}
+
+		/* compute the square root of the discriminant [h] (negative discriminants have no roots and are replaced by zero) */
+		template <std::floating_point Type>
+		constexpr Type SphereRoot(Type h) {
+			return (h < 0 ? Type(0) : num::Sqrt(h));
+		}
+
+		/* compute the smaller and larger root from the terms [dd] and [b] and the square root [s] of the discriminant [h] (false if there are no roots, in which case the factors are meaningless) */
+		template <std::floating_point Type>
+		NUM_KERNEL constexpr bool SphereSolve(Type h, Type dd, Type b, Type s, Type& t0, Type& t1) {
+			/* evaluated without branches, such that the batches vectorize */
+			const bool hit = !((h < 0) | (dd <= 0));
+			const Type div = detail::Divisor(dd, !hit);
+			t0 = (-b - s) / div;
+			t1 = (-b + s) / div;
+			return hit;
+		}
+
+		/* compute the smaller and larger factor for which [o + t * d] has the distance [r] to the point [c] (false if never reached, in which case the factors are meaningless) */
+		template <std::floating_point Type>
+		constexpr bool SphereRoots(const num::Vec<Type>& c, Type r, const num::Vec<Type>& o, const num::Vec<Type>& d, Type& t0, Type& t1) {
+			Type dd = 0, b = 0;
+			const Type h = detail::SphereTerms(c, r, o, d, dd, b);
+			return detail::SphereSolve(h, dd, b, detail::SphereRoot(h), t0, t1);
+		}
+	}
+
+	/*
+	*	Sphere around the center [c] with the radius [r]
+	*	- the overlap tests include touching primitives
+	*	- intersections with bounded lines (num::Ray, num::Segment) report the first factor within their range,
+	*		which is zero if the origin lies within the sphere
+	*	- the batch versions run the scalar tests in parallel with kernels compiled for the active instruction set,
+	*		only the branch-free overlap tests vectorize, the intersections evaluate one sphere at a time
+	*/
+	template <std::floating_point Type>
+	struct Sphere {
+	public:
+		num::Vec<Type> c;
+		Type r = 0;
+
+	public:
+		constexpr Sphere() = default;
+		constexpr Sphere(const num::Vec<Type>& c, Type r) : c{ c }, r{ r } {}
+
+	public:
+		/* check if [p] lies within the sphere */
+		constexpr bool contains(const num::Vec<Type>& p, Type precision = num::Const<Type>::Precision) const {
+			return (p - c).lenSquared() <= (r + precision) * (r + precision);
+		}
+
+		/* check if the sphere [s] overlaps [this] */
+		constexpr bool overlaps(const num::Sphere<Type>& s) const {
+			return (s.c - c).lenSquared() <= (r + s.r) * (r + s.r);
+		}
+
+		/* check if the (infinite) plane [p] cuts [this] */
+		constexpr bool overlaps(const num::Plane<Type>& p) const {
+			/* |(c - o) * n| <= r * |n| without the square root */
+			const num::Vec<Type> n = p.normal();
+			const Type dist = (c - p.o).dot(n);
+			return dist * dist <= r * r * n.dot(n);
+		}
+
+		/* check if the triangle of plane [p] overlaps [this] */
+		constexpr bool overlapsTriangle(const num::Plane<Type>& p) const {
+			return p.closestTriangle(c).lenSquared() <= r * r;
+		}
+
+		/* compute the factor to scale the line [l] with to enter [this] (invalid if the line misses the sphere: returns 0) */
+		constexpr Type intersectf(const num::Line<Type>& l, bool* invalid = 0) const {
+			Type t0 = 0, t1 = 0;
+			const bool hit = detail::SphereRoots(c, r, l.o, l.d, t0, t1);
+			if (invalid)
+				*invalid = !hit;
+			return hit ? t0 : 0;
+		}
+
+		/* compute the factor to scale the bounded line [l] with to reach [this] first within its range (invalid if missed: returns 0) */
+		template <num::Extent Ext>
+		constexpr Type intersectf(const num::Bounded<Type, Ext>& l, bool* invalid = 0) const {
+			Type t0 = 0, t1 = 0;
+			bool hit = detail::SphereRoots(c, r, l.o, l.d, t0, t1);
+			hit = hit && t1 >= 0 && t0 <= num::Bounded<Type, Ext>::Upper;
+			if (invalid)
+				*invalid = !hit;
+			return hit ? std::max<Type>(t0, 0) : 0;
+		}
+
+		/* compute the point at which the (bounded) line [l] enters [this] (invalid if missed: returns the line origin) */
+		template <class LineType>
+		constexpr num::Vec<Type> intersect(const LineType& l, bool* invalid = 0) const {
+			return l.point(intersectf(l, invalid));
+		}
+
+	public:
+		/* test all [items] for overlapping the sphere [s] and write the hit flags to [hits] (returns the number of hits) */
+		static size_t Overlaps(std::span<const num::Sphere<Type>> items, const num::Sphere<Type>& s, std::span<uint8_t> hits, size_t threads = 0) {
+			return detail::CountHits(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				/* copy the captured values, as the byte stores could otherwise alias them and prevent vectorization */
+				const num::Sphere<Type>* data = items.data();
+				const num::Sphere<Type> sphere = s;
+				uint8_t* flags = hits.data();
+				size_t count = 0;
+				for (size_t i = begin; i < end; ++i) {
+					const bool hit = data[i].overlaps(sphere);
+					flags[i] = uint8_t(hit);
+					count += size_t(hit);
+				}
+				return count;
+			});
+		}
+
+		/* test all [items] for being cut by the (infinite) plane [p] and write the hit flags to [hits] (returns the number of hits) */
+		static size_t Overlaps(std::span<const num::Sphere<Type>> items, const num::Plane<Type>& p, std::span<uint8_t> hits, size_t threads = 0) {
+			const num::Vec<Type> n = p.normal();
+			const Type nn = n.dot(n);
+			return detail::CountHits(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				/* copy the captured values, as the byte stores could otherwise alias them and prevent vectorization */
+				const num::Sphere<Type>* data = items.data();
+				const num::Vec<Type> origin = p.o, normal = n;
+				const Type squared = nn;
+				uint8_t* flags = hits.data();
+				size_t count = 0;
+				for (size_t i = begin; i < end; ++i) {
+					const Type dist = (data[i].c - origin).dot(normal);
+					const bool hit = (dist * dist <= data[i].r * data[i].r * squared);
+					flags[i] = uint8_t(hit);
+					count += size_t(hit);
+				}
+				return count;
+			});
+		}
+
+		/* compute the factors to scale the (bounded) line [l] with to reach all [items] into [factors] (infinity if missed, returns the number of hits) */
+		template <class LineType>
+		static size_t Intersectf(std::span<const num::Sphere<Type>> items, const LineType& l, std::span<Type> factors, size_t threads = 0) {
+			return detail::CountHits(items.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				size_t count = 0;
+				for (size_t i = begin; i < end; ++i) {
+					bool invalid = false;
+					const Type f = items[i].intersectf(l, &invalid);
+					factors[i] = (invalid ? std::numeric_limits<Type>::infinity() : f);
+					count += size_t(!invalid);
+				}
+				return count;
+			});
+		}
+	};
+}
@@ -0,0 +1,215 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <tuple>
+#include <vector>
+#include <memory_resource>
+#include <algorithm>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-transform.h"
+#include "num-parallel.h"
+
+/*
+*	Stages of a num::Stream, which operate in place on a tile of [count] points and return the number of remaining points
+*	- mapping stages replace every point, filtering stages compact the tile to the points, which pass the filter
+*	- all invariants of the wrapped operations (normals, sine and cosine of angles) are computed once per stage
+*	- the results are identical to calling the wrapped operations on every point separately
+*/
+namespace num::stage {
+	/* stage, which replaces every point [p] by [fn(p)] */
+	template <class Fn>
+	struct Map {
+	public:
+		Fn fn;
+
+	public:
+		constexpr Map(Fn fn) : fn{ fn } {}
+
+	public:
+		template <std::floating_point Type>
+		constexpr size_t operator()(num::Vec<Type>* data, size_t count) const {
+			for (size_t i = 0; i < count; ++i)
+				data[i] = fn(data[i]);
+			return count;
+		}
+	};
+
+	/* stage, which keeps all points [p], for which [fn(p)] is true (order is preserved) */
+	template <class Fn>
+	struct Filter {
+	public:
+		Fn fn;
+
+	public:
+		constexpr Filter(Fn fn) : fn{ fn } {}
+
+	public:
+		template <std::floating_point Type>
+		constexpr size_t operator()(num::Vec<Type>* data, size_t count) const {
+			size_t kept = 0;
+			for (size_t i = 0; i < count; ++i) {
+				if (fn(data[i]))
+					data[kept++] = data[i];
+			}
+			return kept;
+		}
+	};
+
+	/* equivalent to num::Vec::rotateX */
+	template <std::floating_point Type>
+	constexpr auto RotateX(Type a) {
+		const Type sa = num::Sin(num::ToRadian(a)), ca = num::Cos(num::ToRadian(a));
+		return stage::Map{ [=](const num::Vec<Type>& p) { return num::Vec<Type>{ p.x, p.y * ca - p.z * sa, p.y * sa + p.z * ca }; } };
+	}
+
+	/* equivalent to num::Vec::rotateY */
+	template <std::floating_point Type>
+	constexpr auto RotateY(Type a) {
+		const Type sa = num::Sin(num::ToRadian(a)), ca = num::Cos(num::ToRadian(a));
+		return stage::Map{ [=](const num::Vec<Type>& p) { return num::Vec<Type>{ p.x * ca + p.z * sa, p.y, p.z * ca - p.x * sa }; } };
+	}
+
+	/* equivalent to num::Vec::rotateZ */
+	template <std::floating_point Type>
+	constexpr auto RotateZ(Type a) {
+		const Type sa = num::Sin(num::ToRadian(a)), ca = num::Cos(num::ToRadian(a));
+		return stage::Map{ [=](const num::Vec<Type>& p) { return num::Vec<Type>{ p.x * ca - p.y * sa, p.x * sa + p.y * ca, p.z }; } };
+	}
+
+	/* equivalent to num::Transform::point */
+	template <std::floating_point Type>
+	constexpr auto Transform(const num::Transform<Type>& t) {
+		return stage::Map{ [=](const num::Vec<Type>& p) { return t.point(p); } };
+	}
+
+	/* equivalent to num::Plane::project */
+	template <std::floating_point Type>
+	constexpr auto Project(const num::Plane<Type>& plane) {
+		const num::Vec<Type> n = plane.normal();
+		return stage::Map{ [=](const num::Vec<Type>& p) { return p - n.project(p); } };
+	}
+
+	/* move every point onto its closest point on the plane (equivalent to p + num::Plane::closest) */
+	template <std::floating_point Type>
+	constexpr auto Closest(const num::Plane<Type>& plane) {
+		const num::Vec<Type> o = plane.o, n = plane.normal();
+		const Type nn = n.dot(n);
+		return stage::Map{ [=](const num::Vec<Type>& p) { return p + n * ((o - p).dot(n) / nn); } };
+	}
+
+	/* move every point onto its closest point on the line (equivalent to p + num::Line::closest) */
+	template <std::floating_point Type>
+	constexpr auto Closest(const num::Line<Type>& line) {
+		return stage::Map{ [=](const num::Vec<Type>& p) { return p + line.closest(p); } };
+	}
+
+	/* keep all points, which lie within the triangle of the plane (equivalent to num::Plane::inTriangle) */
+	template <std::floating_point Type>
+	constexpr auto InTriangle(const num::Plane<Type>& plane, Type precision = num::Const<Type>::Precision) {
+		return stage::Filter{ [=](const num::Vec<Type>& p) { return plane.inTriangle(p, 0, precision); } };
+	}
+}
+
+namespace num {
+	/*
+	*	Pull-based pipeline of stages (num::stage), which are applied to a source array of points
+	*	- the stages are fused and applied tile by tile, thereby only a single tile of intermediate points exists at
+	*		a time (per thread), which is sized to remain in the cache, instead of one full array per stage
+	*	- stages are appended by [stream | stage], which produces a new stream and leaves the original unchanged
+	*	- the stream is consumed either by pulling the surviving points tile by tile or by writing them to an array
+	*	- the tiles are allocated from the given memory resource only by the calling thread, which may thereby be a
+	*		non-thread-safe resource such as num::Arena
+	*/
+	template <std::floating_point Type, class... Stages>
+	struct Stream {
+	private:
+		std::span<const num::Vec<Type>> pSource;
+		std::tuple<Stages...> pStages;
+		std::pmr::vector<num::Vec<Type>> pTile;
+		size_t pTileSize = 0;
+		size_t pOffset = 0;
+
+	public:
+		explicit Stream(std::span<const num::Vec<Type>> source, size_t tile = 1024, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			pSource{ source }, pTile{ resource }, pTileSize{ std::max<size_t>(tile, 1) } {}
+		Stream(std::span<const num::Vec<Type>> source, const std::tuple<Stages...>& stages, size_t tile, std::pmr::memory_resource* resource) :
+			pSource{ source }, pStages{ stages }, pTile{ resource }, pTileSize{ tile } {}
+
+	public:
+		/* create a new stream with [stage] appended to the stages of [this] */
+		template <class Stage>
+		num::Stream<Type, Stages..., Stage> operator|(const Stage& stage) const {
+			return num::Stream<Type, Stages..., Stage>{ pSource, std::tuple_cat(pStages, std::make_tuple(stage)), pTileSize, pTile.get_allocator().resource() };
+		}
+
+	private:
+		/* apply all stages to the [count] points of [data] and return the number of remaining points */
+		size_t fApply(num::Vec<Type>* data, size_t count) const {
+			std::apply([&](const Stages&... stages) {
+				((count = (count == 0 ? 0 : stages(data, count))), ...);
+			}, pStages);
+			return count;
+		}
+
+	public:
+		/* pull the next tile of surviving points (empty once the source is exhausted, the tile remains valid until the next pull) */
+		std::span<const num::Vec<Type>> pull() {
+			pTile.resize(pTileSize);
+			while (pOffset < pSource.size()) {
+				const size_t count = std::min(pTileSize, pSource.size() - pOffset);
+				std::copy(pSource.begin() + pOffset, pSource.begin() + pOffset + count, pTile.begin());
+				pOffset += count;
+				const size_t kept = fApply(pTile.data(), count);
+				if (kept > 0)
+					return std::span<const num::Vec<Type>>{ pTile.data(), kept };
+			}
+			return {};
+		}
+
+		/* restart pulling from the beginning of the source */
+		void reset() {
+			pOffset = 0;
+		}
+
+		/* write all surviving points in order to [out], which must be at least as large as the source and may be identical
+		*	to it, with every thread processing its own part of the source with its own tile (returns the number of points) */
+		size_t into(std::span<num::Vec<Type>> out, size_t threads = 0) const {
+			/*
+			*	every chunk writes its survivors to the start of its own range, which are compacted afterwards, and the tiles of
+			*	all chunks are allocated up front by the calling thread, as the memory resource does not need to be thread-safe
+			*/
+			const size_t minChunk = pTileSize * 16;
+			const size_t chunks = num::ParallelChunks(pSource.size(), threads, minChunk);
+			std::pmr::memory_resource* resource = pTile.get_allocator().resource();
+			std::pmr::vector<num::Vec<Type>> tiles{ chunks * pTileSize, resource };
+			std::pmr::vector<size_t> counts{ chunks, 0, resource };
+			num::Parallel(pSource.size(), chunks, minChunk, [&](size_t begin, size_t end, size_t chunk) {
+				num::Vec<Type>* tile = tiles.data() + chunk * pTileSize;
+				size_t written = begin;
+				for (size_t offset = begin; offset < end; offset += pTileSize) {
+					const size_t count = std::min(pTileSize, end - offset);
+					std::copy(pSource.begin() + offset, pSource.begin() + offset + count, tile);
+					const size_t kept = fApply(tile, count);
+					std::copy(tile, tile + kept, out.begin() + written);
+					written += kept;
+				}
+				counts[chunk] = written - begin;
+			});
+
+			size_t total = 0;
+			for (size_t i = 0; i < counts.size(); ++i) {
+				const size_t begin = (pSource.size() * i) / counts.size();
+				if (begin != total)
+					std::copy(out.begin() + begin, out.begin() + begin + counts[i], out.begin() + total);
+				total += counts[i];
+			}
+			return total;
+		}
+	};
+}
@@ -0,0 +1,261 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-line.h"
+#include "num-plane.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+
+namespace num {
+	/*
+	*	Affine transformation described by a 3x3 matrix and a translation (3x4 matrix)
+	*	- the matrix is stored by its columns, which are the images of the x/y/z axis
+	*	- points (Line::o, Plane::o) are affected by the translation, directions (Line::d, Plane::a/b) are not
+	*	- normals are transformed by the cofactor matrix, which keeps them consistent with [num::Plane::normal]
+	*		of the transformed plane (i.e. they are scaled by the determinant and flipped for mirroring transformations)
+	*/
+	template <std::floating_point Type>
+	struct Transform {
+	public:
+		num::Vec<Type> x;
+		num::Vec<Type> y;
+		num::Vec<Type> z;
+		num::Vec<Type> t;
+
+	public:
+		constexpr Transform() : x{ num::Vec<Type>::AxisX() }, y{ num::Vec<Type>::AxisY() }, z{ num::Vec<Type>::AxisZ() } {}
+		constexpr Transform(const num::Vec<Type>& x, const num::Vec<Type>& y, const num::Vec<Type>& z) : x{ x }, y{ y }, z{ z } {}
+		constexpr Transform(const num::Vec<Type>& x, const num::Vec<Type>& y, const num::Vec<Type>& z, const num::Vec<Type>& t) : x{ x }, y{ y }, z{ z }, t{ t } {}
+
+	public:
+		/* compose the transformations such that [t] is applied first and [this] afterwards */
+		constexpr num::Transform<Type> operator*(const num::Transform<Type>& t) const {
+			return compose(t);
+		}
+		constexpr num::Transform<Type>& operator*=(const num::Transform<Type>& t) {
+			return (*this = compose(t));
+		}
+		constexpr bool operator==(const num::Transform<Type>& t) const {
+			return identical(t);
+		}
+		constexpr bool operator!=(const num::Transform<Type>& t) const {
+			return !(*this == t);
+		}
+
+	public:
+		/* create the identity transformation */
+		static constexpr num::Transform<Type> Identity() {
+			return num::Transform<Type>{};
+		}
+
+		/* create a transformation, which translates by [v] */
+		static constexpr num::Transform<Type> Translate(const num::Vec<Type>& v) {
+			return num::Transform<Type>{ num::Vec<Type>::AxisX(), num::Vec<Type>::AxisY(), num::Vec<Type>::AxisZ(), v };
+		}
+
+		/* create a transformation, which scales the separate axes by the components of [s] */
+		static constexpr num::Transform<Type> Scale(const num::Vec<Type>& s) {
+			return num::Transform<Type>{ num::Vec<Type>::AxisX(s.x), num::Vec<Type>::AxisY(s.y), num::Vec<Type>::AxisZ(s.z) };
+		}
+
+		/* create a transformation, which rotates by [a] degrees counterclockwise along the x axis when it points towards the observer (equivalent to Vec::rotateX) */
+		static constexpr num::Transform<Type> RotateX(Type a) {
+			a = num::ToRadian(a);
+			const Type sa = num::Sin(a);
+			const Type ca = num::Cos(a);
+			return num::Transform<Type>{ num::Vec<Type>::AxisX(), num::Vec<Type>{ 0, ca, sa }, num::Vec<Type>{ 0, -sa, ca } };
+		}
+
+		/* create a transformation, which rotates by [a] degrees counterclockwise along the y axis when it points towards the observer (equivalent to Vec::rotateY) */
+		static constexpr num::Transform<Type> RotateY(Type a) {
+			a = num::ToRadian(a);
+			const Type sa = num::Sin(a);
+			const Type ca = num::Cos(a);
+			return num::Transform<Type>{ num::Vec<Type>{ ca, 0, -sa }, num::Vec<Type>::AxisY(), num::Vec<Type>{ sa, 0, ca } };
+		}
+
+		/* create a transformation, which rotates by [a] degrees counterclockwise along the z axis when it points towards the observer (equivalent to Vec::rotateZ) */
+		static constexpr num::Transform<Type> RotateZ(Type a) {
+			a = num::ToRadian(a);
+			const Type sa = num::Sin(a);
+			const Type ca = num::Cos(a);
+			return num::Transform<Type>{ num::Vec<Type>{ ca, sa, 0 }, num::Vec<Type>{ -sa, ca, 0 }, num::Vec<Type>::AxisZ() };
+		}
+
+		/* create a transformation, which rotates by [a] degrees counterclockwise along the axis [v] when it points towards the observer */
+		static constexpr num::Transform<Type> Rotate(const num::Vec<Type>& v, Type a) {
+			/* rodrigues' rotation formula applied to the separate axes */
+			const num::Vec<Type> k = v.norm();
+			a = num::ToRadian(a);
+			const Type sa = num::Sin(a);
+			const Type ca = num::Cos(a);
+			const auto rotate = [&](const num::Vec<Type>& p) {
+				return p * ca + k.cross(p) * sa + k * (k.dot(p) * (1 - ca));
+			};
+			return num::Transform<Type>{ rotate(num::Vec<Type>::AxisX()), rotate(num::Vec<Type>::AxisY()), rotate(num::Vec<Type>::AxisZ()) };
+		}
+
+	public:
+		/* compute the determinant of the linear part of the transformation */
+		constexpr Type determinant() const {
+			return x.dot(y.cross(z));
+		}
+
+		/* compose the transformations such that [t] is applied first and [this] afterwards */
+		constexpr num::Transform<Type> compose(const num::Transform<Type>& t) const {
+			return num::Transform<Type>{ direction(t.x), direction(t.y), direction(t.z), point(t.t) };
+		}
+
+		/* compute the inverse transformation (invalid if the transformation is singular, i.e. the determinant is negligible relative to
+		*	the product of the lengths of the columns: returns the identity) */
+		constexpr num::Transform<Type> inverse(bool* invalid = 0, Type precision = num::Const<Type>::Precision) const {
+			/*
+			*	the rows of the inverse of the linear part are the cross products of the columns divided by the determinant
+			*	M^-1 = [(y x z), (z x x), (x x y)]^T / det
+			*	t^-1 = -(M^-1 * t)
+			*	the determinant is the volume spanned by the columns, which is compared against the volume of the box of their
+			*	lengths, thereby uniformly small transformations (e.g. scaling by 0.001) remain invertible
+			*/
+			const Type det = determinant();
+			if (num::Abs(det) <= precision * x.len() * y.len() * z.len()) {
+				if (invalid)
+					*invalid = true;
+				return num::Transform<Type>{};
+			}
+			else if (invalid)
+				*invalid = false;
+
+			const num::Vec<Type> r0 = y.cross(z) / det, r1 = z.cross(x) / det, r2 = x.cross(y) / det;
+			return num::Transform<Type>{
+				num::Vec<Type>{ r0.x, r1.x, r2.x },
+					num::Vec<Type>{ r0.y, r1.y, r2.y },
+					num::Vec<Type>{ r0.z, r1.z, r2.z },
+					-num::Vec<Type>{ r0.dot(t), r1.dot(t), r2.dot(t) }
+			};
+		}
+
+		/* compute the transformation, which transforms normals (cofactor matrix, translation is dropped) */
+		constexpr num::Transform<Type> cofactor() const {
+			const num::Vec<Type> c0 = y.cross(z), c1 = z.cross(x), c2 = x.cross(y);
+			return num::Transform<Type>{ c0, c1, c2 };
+		}
+
+		/* compute the angles in degrees [-180; 180] of a rotation, such that the transformation equals RotateZ(z) * RotateY(y) * RotateX(x),
+		*	or rotating a vector by rotateX(x), rotateY(y), and rotateZ(z) in that order (only valid for rotations, y is within [-90; 90]) */
+		constexpr num::Vec<Type> angles() const {
+			/* R = Rz * Ry * Rx -> R[2][0] = -sin(y), R[2][1] = cos(y) sin(x), R[2][2] = cos(y) cos(x), R[1][0] = sin(z) cos(y), R[0][0] = cos(z) cos(y) */
+			const Type cy = num::Sqrt(x.x * x.x + x.y * x.y);
+			const Type ay = num::Atan2(-x.z, cy);
+
+			/* gimbal lock: only the sum or difference of the x and z rotation is defined, select z as zero */
+			if (cy <= num::Const<Type>::Precision)
+				return num::Vec<Type>{ num::ToDegree(num::Atan2(-z.y, y.y)), num::ToDegree(ay), 0 };
+			return num::Vec<Type>{ num::ToDegree(num::Atan2(y.z, z.z)), num::ToDegree(ay), num::ToDegree(num::Atan2(x.y, x.x)) };
+		}
+
+		/* check if the transformation [t] and [this] are identical */
+		constexpr bool identical(const num::Transform<Type>& t, Type precision = num::Const<Type>::Precision) const {
+			return x.identical(t.x, precision) && y.identical(t.y, precision) && z.identical(t.z, precision) && this->t.identical(t.t, precision);
+		}
+
+	public:
+		/* transform the point [p] (affected by the translation) */
+		constexpr num::Vec<Type> point(const num::Vec<Type>& p) const {
+			return num::Vec<Type>{
+				x.x * p.x + y.x * p.y + z.x * p.z + t.x,
+					x.y * p.x + y.y * p.y + z.y * p.z + t.y,
+					x.z * p.x + y.z * p.y + z.z * p.z + t.z
+			};
+		}
+
+		/* transform the direction [d] (not affected by the translation) */
+		constexpr num::Vec<Type> direction(const num::Vec<Type>& d) const {
+			return num::Vec<Type>{
+				x.x * d.x + y.x * d.y + z.x * d.z,
+					x.y * d.x + y.y * d.y + z.y * d.z,
+					x.z * d.x + y.z * d.y + z.z * d.z
+			};
+		}
+
+		/* transform the normal [n] such that it is perpendicular to the transformed surface (scaled by the determinant) */
+		constexpr num::Vec<Type> normal(const num::Vec<Type>& n) const {
+			return y.cross(z) * n.x + z.cross(x) * n.y + x.cross(y) * n.z;
+		}
+
+		/* transform the line [l] */
+		constexpr num::Line<Type> line(const num::Line<Type>& l) const {
+			return num::Line<Type>{ point(l.o), direction(l.d) };
+		}
+
+		/* transform the plane [p] */
+		constexpr num::Plane<Type> plane(const num::Plane<Type>& p) const {
+			return num::Plane<Type>{ point(p.o), direction(p.a), direction(p.b) };
+		}
+
+	public:
+		/* transform all points of [in] into [out] (may be identical to [in]) */
+		void points(std::span<const num::Vec<Type>> in, std::span<num::Vec<Type>> out, size_t threads = 0) const {
+			const num::Transform<Type> m = *this;
+			num::ParallelDispatch(in.size(), threads, 65536, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					out[i] = m.point(in[i]);
+			});
+		}
+
+		/* transform all directions of [in] into [out] (may be identical to [in]) */
+		void directions(std::span<const num::Vec<Type>> in, std::span<num::Vec<Type>> out, size_t threads = 0) const {
+			const num::Transform<Type> m = *this;
+			num::ParallelDispatch(in.size(), threads, 65536, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					out[i] = m.direction(in[i]);
+			});
+		}
+
+		/* transform all normals of [in] into [out] (may be identical to [in]) */
+		void normals(std::span<const num::Vec<Type>> in, std::span<num::Vec<Type>> out, size_t threads = 0) const {
+			const num::Transform<Type> m = cofactor();
+			num::ParallelDispatch(in.size(), threads, 65536, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					out[i] = m.direction(in[i]);
+			});
+		}
+
+		/* transform all lines of [in] into [out] (may be identical to [in]) */
+		void lines(std::span<const num::Line<Type>> in, std::span<num::Line<Type>> out, size_t threads = 0) const {
+			const num::Transform<Type> m = *this;
+			num::ParallelDispatch(in.size(), threads, 32768, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					out[i] = num::Line<Type>{ m.point(in[i].o), m.direction(in[i].d) };
+			});
+		}
+
+		/* transform all planes of [in] into [out] (may be identical to [in]) */
+		void planes(std::span<const num::Plane<Type>> in, std::span<num::Plane<Type>> out, size_t threads = 0) const {
+			const num::Transform<Type> m = *this;
+			num::ParallelDispatch(in.size(), threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					out[i] = num::Plane<Type>{ m.point(in[i].o), m.direction(in[i].a), m.direction(in[i].b) };
+			});
+		}
+
+		/* transform all lines and planes of a scene in place within one pass over the memory of every array */
+		void scene(std::span<num::Line<Type>> lines, std::span<num::Plane<Type>> planes, size_t threads = 0) const {
+			/* distribute both arrays over the same chunks, such that every thread streams through its part of both arrays once */
+			const num::Transform<Type> m = *this;
+			const size_t total = lines.size() + planes.size();
+			num::ParallelDispatch(total, threads, 16384, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < std::min(end, lines.size()); ++i)
+					lines[i] = num::Line<Type>{ m.point(lines[i].o), m.direction(lines[i].d) };
+				for (size_t i = std::max(begin, lines.size()); i < end; ++i) {
+					num::Plane<Type>& p = planes[i - lines.size()];
+					p = num::Plane<Type>{ m.point(p.o), m.direction(p.a), m.direction(p.b) };
+				}
+			});
+		}
+	};
+}
@@ -32,6 +32,19 @@ namespace num {
 		constexpr Vec(Type f) : x{ f }, y{ f }, z{ f } {}
 		constexpr Vec(Type x, Type y, Type z) : x{ x }, y{ y }, z{ z } {}
 
+	public:
+		/* access the component [i] (unlike the union member [c], this can be evaluated at compile time) */
+		constexpr Type& operator[](size_t i) {
+			if (std::is_constant_evaluated())
+				return (i == 0 ? x : (i == 1 ? y : z));
+			return c[i];
+		}
+		constexpr const Type& operator[](size_t i) const {
+			if (std::is_constant_evaluated())
+				return (i == 0 ? x : (i == 1 ? y : z));
+			return c[i];
+		}
+
 	public:
 		constexpr num::Vec<Type> operator+(const num::Vec<Type>& v) const {
 			return num::Vec<Type>{ x + v.x, y + v.y, z + v.z };
@@ -104,7 +117,7 @@ namespace num {
 		/* compute the angle between the vector [this] and [v] [0; 180] */
 		constexpr Type angle(const num::Vec<Type>& v) const {
 			Type dotProd = dot(v);
-			Type lenProd = std::sqrt(lenSquared() * v.lenSquared());
+			Type lenProd = num::Sqrt(lenSquared() * v.lenSquared());
 			Type frac = dotProd / lenProd;
 
 			/* check if the angle reaches the degrees where the uncertainty of floats
@@ -113,7 +126,7 @@ namespace num {
 				return 0;
 			else if (frac <= -1)
 				return 180;
-			return num::ToDegree(std::acos(frac));
+			return num::ToDegree(num::Acos(frac));
 		}
 
 		/* compute the squared length of the vector */
@@ -123,7 +136,7 @@ namespace num {
 
 		/* compute the length of the vector */
 		constexpr Type len() const {
-			return std::sqrt(lenSquared());
+			return num::Sqrt(lenSquared());
 		}
 
 		/* compute the the cross product [this] x [v] */
@@ -176,7 +189,7 @@ namespace num {
 
 			/* iterate through the components and check if one is larger */
 			for (size_t i = 1; i < 3; i++) {
-				if (largest ? num::Abs(c[index]) < num::Abs(c[i]) : num::Abs(c[index]) > num::Abs(c[i]))
+				if (largest ? num::Abs((*this)[index]) < num::Abs((*this)[i]) : num::Abs((*this)[index]) > num::Abs((*this)[i]))
 					index = i;
 			}
 			return index;
@@ -185,8 +198,8 @@ namespace num {
 		/* compute the vector when rotating [this] by [a] degrees counterclockwise along the x axis when it points towards the observer */
 		constexpr num::Vec<Type> rotateX(Type a) const {
 			a = num::ToRadian(a);
-			const Type sa = std::sin(a);
-			const Type ca = std::cos(a);
+			const Type sa = num::Sin(a);
+			const Type ca = num::Cos(a);
 			return num::Vec<Type>{
 				x,
 					y* ca - z * sa,
@@ -197,8 +210,8 @@ namespace num {
 		/* compute the vector when rotating [this] by [a] degrees counterclockwise along the y axis when it points towards the observer */
 		constexpr num::Vec<Type> rotateY(Type a) const {
 			a = num::ToRadian(a);
-			const Type sa = std::sin(a);
-			const Type ca = std::cos(a);
+			const Type sa = num::Sin(a);
+			const Type ca = num::Cos(a);
 			return num::Vec<Type>{
 				x* ca + z * sa,
 					y,
@@ -209,8 +222,8 @@ namespace num {
 		/* compute the vector when rotating [this] by [a] degrees counterclockwise along the z axis when it points towards the observer */
 		constexpr num::Vec<Type> rotateZ(Type a) const {
 			a = num::ToRadian(a);
-			const Type sa = std::sin(a);
-			const Type ca = std::cos(a);
+			const Type sa = num::Sin(a);
+			const Type ca = num::Cos(a);
 			return num::Vec<Type>{
 				x* ca - y * sa,
 					x* sa + y * ca,
@@ -265,7 +278,7 @@ namespace num {
 
 		/* compute the factor which multiplied with [this] will result in a vector which is parallel to [this] but has length [l] */
 		constexpr Type rescalef(Type l) const {
-			return std::sqrt((l * l) / lenSquared());
+			return num::Sqrt((l * l) / lenSquared());
 		}
 
 		/* construct a vector which is parallel to [this] but has length [l] */
@@ -277,7 +290,7 @@ namespace num {
 		constexpr Type delta(const num::Vec<Type>& v) const {
 			/* extract the largest component and use it to compute the scaling factor */
 			size_t index = comp(true);
-			return v.c[index] / c[index];
+			return v[index] / (*this)[index];
 		}
 
 		/* construct a vector parallel to [this] but scaled by [f] */
@@ -289,13 +302,13 @@ namespace num {
 		constexpr bool parallel(const num::Vec<Type>& v, Type precision = num::Const<Type>::Precision) const {
 			/* extract the largest components and check if the vectors are considered zero */
 			const size_t largest[2] = { comp(true), v.comp(true) };
-			if (num::Abs(c[largest[0]]) <= precision)
-				return (num::Abs(v.c[largest[1]]) <= precision);
-			else if (num::Abs(v.c[largest[1]]) <= precision)
+			if (num::Abs((*this)[largest[0]]) <= precision)
+				return (num::Abs(v[largest[1]]) <= precision);
+			else if (num::Abs(v[largest[1]]) <= precision)
 				return false;
 
 			/* compute the factor with which to scale the other vector */
-			const Type f = c[largest[0]] / v.c[largest[1]];
+			const Type f = (*this)[largest[0]] / v[largest[1]];
 
 			/* check if the vectors are equal when scaled */
 			return match(v * f, precision);
@@ -305,13 +318,13 @@ namespace num {
 		constexpr bool sign(const num::Vec<Type>& v, Type precision = num::Const<Type>::Precision) const {
 			/* extract the largest components and check if the vectors are considered zero */
 			const size_t largest[2] = { comp(true), v.comp(true) };
-			if (num::Abs(c[largest[0]]) <= precision)
-				return (num::Abs(v.c[largest[1]]) <= precision);
-			else if (num::Abs(v.c[largest[1]]) <= precision)
+			if (num::Abs((*this)[largest[0]]) <= precision)
+				return (num::Abs(v[largest[1]]) <= precision);
+			else if (num::Abs(v[largest[1]]) <= precision)
 				return false;
 
 			/* compute the factor with which to scale the other vector and ensure that the factor is positive */
-			const Type f = c[largest[0]] / v.c[largest[1]];
+			const Type f = (*this)[largest[0]] / v[largest[1]];
 			if (f < 0)
 				return false;
 
@@ -418,7 +431,7 @@ namespace num {
 				return 1;
 
 			/* compute the factor required to let this vector reach v and return it if its greater than 1 */
-			return std::max(1, reachf(v));
+			return std::max<Type>(1, reachf(v));
 		}
 
 		/* construct the vector which parallel to [this] and will at least pass the vector [v] if it has not already been passed */
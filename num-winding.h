@@ -0,0 +1,224 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include <span>
+#include <algorithm>
+#include <memory_resource>
+
+#include "num-common.h"
+#include "num-vec.h"
+#include "num-plane.h"
+#include "num-reduce.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+#include "num-morton.h"
+
+namespace num {
+	/*
+	*	Generalized winding numbers of points with respect to triangle meshes of num::Plane triangles (Barill et al., Fast Winding Numbers)
+	*	- the winding number is the sum of the signed solid angles of all triangles divided by 4pi, which is one inside
+	*		and zero outside of closed meshes with outward facing normals, and degrades gracefully for open or broken meshes
+	*	- the triangles are ordered along the morton curve and grouped into a balanced binary tree, whose nodes store
+	*		a third order multipole expansion of their triangles around the area weighted center
+	*	- nodes, which are further than [beta] times their radius away from the query, are evaluated by the expansion instead
+	*		of their triangles, which makes the cost logarithmic in the number of triangles for points away from the surface
+	*	- points on the surface evaluate to roughly one half
+	*/
+	template <std::floating_point Type>
+	struct Winding {
+	private:
+		static constexpr size_t LeafSize = 8;
+		static constexpr size_t MaxDepth = 64;
+
+	private:
+		struct Node {
+			/*
+			*	area weighted center, radius around it, and the moments of the vector areas [n] over the offsets [d] to the center:
+			*	area = sum(n), moment[i] = sum(n[i] * d), and second[i] = sum(n[i] * d * d^T) (integrated over the triangles)
+			*/
+			num::Vec<Type> center;
+			num::Vec<Type> area;
+			num::Vec<Type> moment[3];
+			num::Symmetric<Type> second[3];
+			Type radius = 0;
+			Type weight = 0;
+			uint32_t begin = 0;
+			uint32_t end = 0;
+			uint32_t right = 0;
+		};
+
+	private:
+		std::pmr::vector<num::Plane<Type>> pTriangles;
+		std::pmr::vector<Node> pNodes;
+		num::SpatialOrder<Type> pOrder;
+
+	public:
+		explicit Winding(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : pTriangles{ resource }, pNodes{ resource }, pOrder{ resource } {}
+
+	private:
+		/* create the node over the triangles [begin; end) and its children (returns the index of the node) */
+		uint32_t fBuild(uint32_t begin, uint32_t end) {
+			const uint32_t index = uint32_t(pNodes.size());
+			pNodes.emplace_back();
+			Node node;
+			node.begin = begin;
+			node.end = end;
+
+			if (end - begin <= LeafSize) {
+				/* compute the expansion from the triangles (degenerate groups fall back to the unweighted center) */
+				num::Vec<Type> sum;
+				for (uint32_t i = begin; i < end; ++i) {
+					const Type area = pTriangles[i].area();
+					sum += pTriangles[i].center() * area;
+					node.weight += area;
+					node.area += pTriangles[i].normal() / 2;
+				}
+				if (node.weight > 0)
+					node.center = sum / node.weight;
+				else {
+					for (uint32_t i = begin; i < end; ++i)
+						node.center += pTriangles[i].center();
+					node.center /= Type(end - begin);
+				}
+
+				/* the second moment of a triangle around its centroid is the sum of the outer products of its centered vertices / 12 */
+				Type radius = 0;
+				for (uint32_t i = begin; i < end; ++i) {
+					const num::Plane<Type>& t = pTriangles[i];
+					const num::Vec<Type> offset = t.center() - node.center, area = t.normal() / 2;
+					const num::Vec<Type> w0 = t.o - t.center(), w1 = w0 + t.a, w2 = w0 + t.b;
+					const num::Symmetric<Type> spread = num::Symmetric<Type>::Outer(offset)
+						+ (num::Symmetric<Type>::Outer(w0) + num::Symmetric<Type>::Outer(w1) + num::Symmetric<Type>::Outer(w2)) / 12;
+					for (size_t j = 0; j < 3; ++j) {
+						node.moment[j] += offset * area[j];
+						node.second[j] = node.second[j] + spread * area[j];
+					}
+					radius = std::max({ radius, (t.o - node.center).lenSquared(), (t.o + t.a - node.center).lenSquared(), (t.o + t.b - node.center).lenSquared() });
+				}
+				node.radius = num::Sqrt(radius);
+				pNodes[index] = node;
+				return index;
+			}
+
+			/* split the range at the midpoint and combine the expansions of the children around the combined center */
+			const uint32_t mid = begin + (end - begin) / 2;
+			const uint32_t left = fBuild(begin, mid);
+			node.right = fBuild(mid, end);
+			const Node& l = pNodes[left], & r = pNodes[node.right];
+			node.weight = l.weight + r.weight;
+			node.area = l.area + r.area;
+			node.center = (node.weight > 0 ? (l.center * l.weight + r.center * r.weight) / node.weight : (l.center + r.center) / 2);
+			for (const Node* child : { &l, &r }) {
+				const num::Vec<Type> offset = child->center - node.center;
+				for (size_t j = 0; j < 3; ++j) {
+					node.moment[j] += child->moment[j] + offset * child->area[j];
+					node.second[j] = node.second[j] + child->second[j] + num::Symmetric<Type>::Outer(child->moment[j], offset) * 2
+						+ num::Symmetric<Type>::Outer(offset) * child->area[j];
+				}
+				node.radius = std::max(node.radius, child->radius + offset.len());
+			}
+			pNodes[index] = node;
+			return index;
+		}
+
+	public:
+		/* build the tree over the [triangles] (copied into the tree in morton order) */
+		void build(std::span<const num::Plane<Type>> triangles, size_t threads = 0) {
+			pTriangles.assign(triangles.begin(), triangles.end());
+			pNodes.clear();
+			if (pTriangles.empty())
+				return;
+			pOrder.compute(std::span<const num::Plane<Type>>{ pTriangles }, num::CurveMorton, threads);
+			pOrder.apply(std::span<num::Plane<Type>>{ pTriangles }, threads);
+			pNodes.reserve(4 * (pTriangles.size() / LeafSize + 1));
+			fBuild(0, uint32_t(pTriangles.size()));
+		}
+
+		/* triangles of the tree in morton order */
+		std::span<const num::Plane<Type>> triangles() const {
+			return pTriangles;
+		}
+
+	public:
+		/* compute the winding number of [p] by the exact sum over all triangles */
+		Type exact(const num::Vec<Type>& p) const {
+			Type sum = 0;
+			for (const num::Plane<Type>& t : pTriangles)
+				sum += t.solidAngle(p);
+			return sum / (4 * num::Const<Type>::Pi);
+		}
+
+		/* compute the winding number of [p] by evaluating the nodes further than [beta] times their radius away by their expansion */
+		Type number(const num::Vec<Type>& p, Type beta = 2) const {
+			if (pNodes.empty())
+				return 0;
+
+			Type sum = 0;
+			uint32_t stack[MaxDepth];
+			size_t size = 0;
+			stack[size++] = 0;
+			while (size > 0) {
+				const Node& node = pNodes[stack[--size]];
+				const num::Vec<Type> r = node.center - p;
+				const Type d2 = r.lenSquared();
+
+				/*
+				*	far field: taylor expansion of the dipole kernel g(r) = r / |r|^3 around the center up to the second derivative
+				*	first: J(r) : moment with J(r) = I / |r|^3 - 3 r r^T / |r|^5
+				*	second: H(r) : second / 2 with H(r)[i, j, k] = 15 r[i] r[j] r[k] / |r|^7 - 3 (d[i, j] r[k] + d[i, k] r[j] + d[j, k] r[i]) / |r|^5
+				*/
+				if (d2 > beta * beta * node.radius * node.radius) {
+					const Type inv2 = 1 / d2, inv3 = inv2 / num::Sqrt(d2);
+					const Type trace = node.moment[0].x + node.moment[1].y + node.moment[2].z;
+					const Type quad = r.x * node.moment[0].dot(r) + r.y * node.moment[1].dot(r) + r.z * node.moment[2].dot(r);
+
+					const num::Symmetric<Type>* c = node.second;
+					const num::Vec<Type> u{ c[0].xx + c[1].xy + c[2].xz, c[0].xy + c[1].yy + c[2].yz, c[0].xz + c[1].yz + c[2].zz };
+					const num::Vec<Type> v{ c[0].trace(), c[1].trace(), c[2].trace() };
+					const Type cube = r.x * r.dot(c[0] * r) + r.y * r.dot(c[1] * r) + r.z * r.dot(c[2] * r);
+
+					sum += (node.area.dot(r) + trace - 3 * quad * inv2 + (Type(7.5) * cube * inv2 - Type(1.5) * (u * 2 + v).dot(r)) * inv2) * inv3;
+					continue;
+				}
+
+				/* near field */
+				if (node.right == 0) {
+					for (uint32_t i = node.begin; i < node.end; ++i)
+						sum += pTriangles[i].solidAngle(p);
+					continue;
+				}
+				stack[size++] = node.right;
+				stack[size++] = uint32_t(&node - pNodes.data()) + 1;
+			}
+			return sum / (4 * num::Const<Type>::Pi);
+		}
+
+		/* check if [p] lies within the mesh (winding number of at least one half) */
+		bool inside(const num::Vec<Type>& p, Type beta = 2) const {
+			return number(p, beta) >= Type(0.5);
+		}
+
+	public:
+		/* compute the winding numbers of all [points] into [numbers] (must be at least as large as [points]) */
+		void numbers(std::span<const num::Vec<Type>> points, std::span<Type> numbers, size_t threads = 0, Type beta = 2) const {
+			num::ParallelDispatch(points.size(), threads, 1024, [&](size_t begin, size_t end) NUM_KERNEL {
+				for (size_t i = begin; i < end; ++i)
+					numbers[i] = number(points[i], beta);
+			});
+		}
+
+		/* test all [points] for lying within the mesh and write the flags to [hits] (returns the number of inside points) */
+		size_t inside(std::span<const num::Vec<Type>> points, std::span<uint8_t> hits, size_t threads = 0, Type beta = 2) const {
+			return detail::CountHits(points.size(), threads, 1024, [&](size_t begin, size_t end) NUM_KERNEL {
+				size_t count = 0;
+				for (size_t i = begin; i < end; ++i) {
+					const bool hit = inside(points[i], beta);
+					hits[i] = uint8_t(hit);
+					count += size_t(hit);
+				}
+				return count;
+			});
+		}
+	};
+}
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Benchmark of the aligned layout (num::AlignedVec, num::AlignedLine, num::AlignedPlane) against the packed layout
+*	- every workload runs the same operation over arrays of both layouts in float and double, and reports the best
+*		time per element of each layout and the speedup of the aligned layout
+*	- the results of both layouts must be bit-identical, which fails the run otherwise (the timings are informative)
+*/
+
+namespace {
+	constexpr size_t Items = 1 << 16;
+	constexpr size_t Repeats = 7;
+	size_t Failed = 0;
+
+	/* compare the components of the packed and aligned results bitwise */
+	template <std::floating_point Type>
+	bool Same(Type a, Type b) {
+		return std::memcmp(&a, &b, sizeof(Type)) == 0;
+	}
+	template <std::floating_point Type>
+	bool Same(const num::Vec<Type>& a, const num::AlignedVec<Type>& b) {
+		return Same(a.x, b.x) && Same(a.y, b.y) && Same(a.z, b.z);
+	}
+	template <std::floating_point Type>
+	bool Same(const num::Linear<Type>& a, const num::Linear<Type>& b) {
+		return Same(a.s, b.s) && Same(a.t, b.t);
+	}
+	inline bool Same(bool a, bool b) {
+		return a == b;
+	}
+
+	/* measure the best time per element in nanoseconds of [fn(i)] over all items writing to [out] */
+	template <class Result, class Fn>
+	double Time(std::vector<Result>& out, const Fn& fn) {
+		double best = std::numeric_limits<double>::infinity();
+		for (size_t r = 0; r < Repeats; ++r) {
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < Items; ++i)
+				out[i] = fn(i);
+			const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			best = std::min(best, elapsed * 1e9 / double(Items));
+		}
+		return best;
+	}
+
+	template <std::floating_point Type>
+	struct Data {
+		std::vector<num::Vec<Type>> a, b;
+		std::vector<num::Line<Type>> lines;
+		std::vector<num::Plane<Type>> planes;
+		std::vector<num::AlignedVec<Type>> aa, ab;
+		std::vector<num::AlignedLine<Type>> alines;
+		std::vector<num::AlignedPlane<Type>> aplanes;
+
+		Data() {
+			std::mt19937_64 engine{ 0xa1 + sizeof(Type) };
+			const auto unit = [&]() { return Type(double(engine() >> 11) * 0x1.0p-53 * 2 - 1); };
+			const auto vec = [&]() { return num::Vec<Type>{ unit(), unit(), unit() }; };
+			for (size_t i = 0; i < Items; ++i) {
+				a.push_back(vec());
+				b.push_back(vec());
+				lines.push_back(num::Line<Type>{ vec(), vec() });
+				planes.push_back(num::Plane<Type>{ vec(), vec(), vec() });
+			}
+			aa.assign(a.begin(), a.end());
+			ab.assign(b.begin(), b.end());
+			alines.assign(lines.begin(), lines.end());
+			aplanes.assign(planes.begin(), planes.end());
+		}
+	};
+
+	/* run the workload [packed(i)] and [aligned(i)] and compare their timings and results */
+	template <class Packed, class Aligned>
+	void Run(const char* name, const char* type, const Packed& packed, const Aligned& aligned) {
+		using PackedResult = decltype(packed(size_t(0)));
+		using AlignedResult = decltype(aligned(size_t(0)));
+		std::vector<PackedResult> p(Items);
+		std::vector<AlignedResult> a(Items);
+		const double tp = Time(p, packed), ta = Time(a, aligned);
+
+		size_t differ = 0;
+		for (size_t i = 0; i < Items; ++i)
+			differ += (Same(p[i], a[i]) ? 0 : 1);
+		Failed += (differ > 0 ? 1 : 0);
+		std::printf("%-20s %-7s %10.3f %10.3f %8.2fx %s\n", name, type, tp, ta, tp / ta, (differ == 0 ? "identical" : "differs"));
+	}
+
+	template <std::floating_point Type>
+	void Workloads(const char* type) {
+		const Data<Type> d;
+		Run("add", type, [&](size_t i) { return d.a[i] + d.b[i]; }, [&](size_t i) { return d.aa[i] + d.ab[i]; });
+		Run("scale-add", type, [&](size_t i) { return d.a[i] * Type(0.5) + d.b[i]; }, [&](size_t i) { return d.aa[i] * Type(0.5) + d.ab[i]; });
+		Run("dot", type, [&](size_t i) { return d.a[i].dot(d.b[i]); }, [&](size_t i) { return d.aa[i].dot(d.ab[i]); });
+		Run("cross", type, [&](size_t i) { return d.a[i].cross(d.b[i]); }, [&](size_t i) { return d.aa[i].cross(d.ab[i]); });
+		Run("norm", type, [&](size_t i) { return d.a[i].norm(); }, [&](size_t i) { return d.aa[i].norm(); });
+		Run("line.closest", type, [&](size_t i) { return d.lines[i].closest(d.a[i]); }, [&](size_t i) { return d.alines[i].closest(d.aa[i]); });
+		Run("plane.closest", type, [&](size_t i) { return d.planes[i].closest(d.a[i]); }, [&](size_t i) { return d.aplanes[i].closest(d.aa[i]); });
+		Run("plane.intersect", type, [&](size_t i) { return d.planes[i].intersect(d.lines[i]); }, [&](size_t i) { return d.aplanes[i].intersect(d.alines[i]); });
+		Run("plane.inTriangle", type, [&](size_t i) { return d.planes[i].inTriangle(d.a[i]); }, [&](size_t i) { return d.aplanes[i].inTriangle(d.aa[i]); });
+		Run("plane.touch", type, [&](size_t i) { return d.planes[i].touch(d.a[i]); }, [&](size_t i) { return d.aplanes[i].touch(d.aa[i]); });
+		Run("plane.linear", type, [&](size_t i) { return d.planes[i].linear(d.a[i]); }, [&](size_t i) { return d.aplanes[i].linear(d.aa[i]); });
+	}
+}
+
+int main() {
+	std::printf("%-20s %-7s %10s %10s %9s\n", "workload", "type", "packed", "aligned", "speedup");
+	Workloads<float>("float");
+	Workloads<double>("double");
+	return (Failed > 0 ? 1 : 0);
+}
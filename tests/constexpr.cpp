@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#include "../vec.h"
+
+/*
+*	Check of the compile-time evaluation of the geometry
+*	- len, norm, angle, rotateX/Y/Z, num::ToAngle, num::Cmp, the closest points of num::Line, and num::AlignedVec::comp
+*		must be constant expressions, which is checked by static_assert (failures already break the build)
+*	- the constant-evaluated results must match the runtime results within a few units in the last place, as the
+*		compile-time square root and trigonometry are series of their own and not the functions of the standard library
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	template <std::floating_point Type>
+	constexpr bool Near(Type a, Type b, Type eps) {
+		return num::Abs(a - b) <= eps;
+	}
+	template <std::floating_point Type>
+	constexpr bool Near(const num::Vec<Type>& a, const num::Vec<Type>& b, Type eps) {
+		return Near(a.x, b.x, eps) && Near(a.y, b.y, eps) && Near(a.z, b.z, eps);
+	}
+
+	constexpr num::Vec<double> A{ 3, 4, 12 };
+	constexpr num::Vec<double> B{ -2, 1, 0.5 };
+	constexpr num::Line<double> L{ num::Vec<double>{ 1, 2, 3 }, num::Vec<double>{ 2, 0, 0 } };
+	constexpr num::Line<double> M{ num::Vec<double>{ 0, 5, -1 }, num::Vec<double>{ 0, 0, 4 } };
+
+	/* lengths and normalization */
+	static_assert(A.len() == 13);
+	static_assert(num::Vec<float>{ 0, 3, 4 }.len() == 5);
+	static_assert(Near(A.norm(), num::Vec<double>{ 3.0 / 13, 4.0 / 13, 12.0 / 13 }, 1e-15));
+	static_assert(Near(B.norm().len(), 1.0, 1e-15));
+
+	/* angles */
+	static_assert(Near(num::Vec<double>::AxisX().angle(num::Vec<double>::AxisY()), 90.0, 1e-12));
+	static_assert(Near(num::Vec<double>{ 1, 1, 0 }.angle(num::Vec<double>::AxisX()), 45.0, 1e-12));
+	static_assert(Near(num::Vec<float>{ 1, 0, 0 }.angle(num::Vec<float>{ -1, 0, 0 }), 180.0f, 1e-4f));
+	static_assert(Near(num::ToAngle(1.0, 1.0), 45.0, 1e-12));
+	static_assert(Near(num::ToAngle(0.0, -1.0), 180.0, 1e-12));
+
+	/* rotations */
+	static_assert(Near(num::Vec<double>::AxisY().rotateX(90), num::Vec<double>::AxisZ(), 1e-15));
+	static_assert(Near(num::Vec<double>::AxisZ().rotateY(90), num::Vec<double>::AxisX(), 1e-15));
+	static_assert(Near(num::Vec<double>::AxisX().rotateZ(-90), num::Vec<double>{ 0, -1, 0 }, 1e-15));
+	static_assert(Near(A.rotateX(720).len(), 13.0, 1e-12));
+
+	/* comparisons */
+	static_assert(num::Cmp(1.0, 1.0 + 1e-10));
+	static_assert(!num::Cmp(1.0, 1.001));
+	static_assert(num::Cmp(0.0, 1e-12));
+	static_assert(!num::Cmp(std::numeric_limits<double>::quiet_NaN(), 1.0));
+	static_assert(A.identical(A * 1.0));
+
+	/* closest points */
+	static_assert(L.closest(num::Vec<double>{ 4, -1, 7 }) == num::Vec<double>{ 0, 3, -4 });
+	static_assert(L.closestf(num::Vec<double>{ 4, -1, 7 }) == 1.5);
+	static_assert(L.closest(M).o == num::Vec<double>{ 0, 2, 3 });
+	static_assert(L.closest(M).d == num::Vec<double>{ 0, 3, 0 });
+
+	/* component selection of the aligned layout, which must not read the union member */
+	static_assert(num::AlignedVec<double>{ 1, -5, 2 }.comp(true) == 1);
+	static_assert(num::AlignedVec<float>{ 3, -5, 0.5f }.comp(false) == 2);
+
+	/* constant table, as baked by fixed geometry */
+	constexpr num::Vec<double> Table[] = { A.norm(), B.norm(), A.rotateZ(30), B.rotateY(-45) };
+}
+
+int main() {
+	/* the values of the constant table against the same expressions evaluated at runtime */
+	volatile double angle = 30;
+	const num::Vec<double> a = A, b = B;
+	const num::Vec<double> runtime[] = { a.norm(), b.norm(), a.rotateZ(angle), b.rotateY(-angle * 1.5) };
+	double error = 0;
+	for (size_t i = 0; i < std::size(Table); ++i)
+		error = std::max(error, (Table[i] - runtime[i]).len() / runtime[i].len());
+	Check(error <= 4 * std::numeric_limits<double>::epsilon(), "table against runtime (relative)", error);
+
+	const double len = A.len(), ang = B.angle(A);
+	volatile double lenRuntime = a.len(), angRuntime = b.angle(a);
+	Check(len == lenRuntime, "len against runtime", len - lenRuntime);
+	Check(Near(ang, double(angRuntime), 1e-12), "angle against runtime", ang - angRuntime);
+	return (Failed > 0 ? 1 : 0);
+}
@@ -0,0 +1,176 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Check of num::Delaunay on random, grid, co-circular, duplicate, and collinear points with 1 and N threads
+*	- the half-edges must be symmetric (every opposite links back and connects the same vertices in reverse)
+*	- all faces must be counterclockwise and every interior edge must be locally Delaunay (num::detail::InCircle)
+*	- every distinct projection must be used and the number of triangles must be 2n - 2 - h for n distinct points
+*		and h points on the hull
+*	- without co-circular points the triangulation is unique, thereby both thread counts must produce the same triangles
+*	- collinear points must be rejected without triangles
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	/* number of threads of the concurrent builds (the inputs of more than 2 * 65536 points are split into strips) */
+	constexpr size_t Threads = 4;
+
+	const num::Plane<double> Frame{ num::Vec<double>{ 0, 0, 0 }, num::Vec<double>{ 1, 0, 0 }, num::Vec<double>{ 0, 1, 0 } };
+
+	/* triangles of the last build as sorted vertex triples (for the comparison of builds with different face orders) */
+	std::vector<std::tuple<size_t, size_t, size_t>> Triangles(const num::Delaunay<double>& delaunay) {
+		const auto& idx = delaunay.indices();
+		std::vector<std::tuple<size_t, size_t, size_t>> out;
+		for (size_t f = 0; f < idx.size(); f += 3) {
+			size_t v[3] = { idx[f], idx[f + 1], idx[f + 2] };
+			std::sort(v, v + 3);
+			out.emplace_back(v[0], v[1], v[2]);
+		}
+		std::sort(out.begin(), out.end());
+		return out;
+	}
+
+	/* validate the last build and return the number of violations */
+	size_t Validate(const num::Delaunay<double>& delaunay) {
+		const auto& idx = delaunay.indices();
+		const auto& opp = delaunay.opposite();
+		const std::span<const num::Linear<double>> c = delaunay.coordinates();
+		size_t bad = (opp.size() == idx.size() ? 0 : 1);
+
+		/* counterclockwise faces */
+		for (size_t f = 0; f < idx.size(); f += 3)
+			bad += (num::detail::Orient2d(c[idx[f]], c[idx[f + 1]], c[idx[f + 2]]) > 0 ? 0 : 1);
+
+		/* symmetric half-edges and local delaunay property */
+		size_t border = 0;
+		for (size_t h = 0; h < idx.size() && bad == 0; ++h) {
+			const size_t o = opp[h];
+			if (o == size_t(-1)) {
+				++border;
+				continue;
+			}
+			const size_t hNext = h - h % 3 + (h + 1) % 3, oNext = o - o % 3 + (o + 1) % 3, oFar = o - o % 3 + (o + 2) % 3;
+			bad += (opp[o] == h && idx[h] == idx[oNext] && idx[hNext] == idx[o] ? 0 : 1);
+			const size_t f = h - h % 3;
+			bad += (num::detail::InCircle(c[idx[f]], c[idx[f + 1]], c[idx[f + 2]], c[idx[oFar]]) > 0 ? 1 : 0);
+		}
+
+		/* coverage of all distinct projections and the number of triangles */
+		std::vector<std::pair<double, double>> all, used;
+		std::vector<bool> referenced(c.size(), false);
+		for (size_t i : idx)
+			referenced[i] = true;
+		for (size_t i = 0; i < c.size(); ++i) {
+			all.emplace_back(c[i].s, c[i].t);
+			if (referenced[i])
+				used.emplace_back(c[i].s, c[i].t);
+		}
+		std::sort(all.begin(), all.end());
+		std::sort(used.begin(), used.end());
+		const size_t n = size_t(std::unique(all.begin(), all.end()) - all.begin());
+		bad += (size_t(std::unique(used.begin(), used.end()) - used.begin()) == n ? 0 : 1);
+		const size_t h = delaunay.hull().size();
+		bad += (h == border && idx.size() / 3 == 2 * n - 2 - h ? 0 : 1);
+		return bad;
+	}
+
+	/* build [points] with 1 and N threads and validate both triangulations */
+	void Run(const char* name, const std::vector<num::Vec<double>>& points, bool unique) {
+		num::Delaunay<double> delaunay;
+		char what[64] = { 0 };
+		std::vector<std::tuple<size_t, size_t, size_t>> single;
+		size_t faces = 0;
+
+		for (size_t threads : { size_t(1), Threads }) {
+			const bool built = delaunay.build(points, Frame, threads);
+			const size_t bad = (built ? Validate(delaunay) : 1);
+			std::snprintf(what, sizeof(what), "%s: violations (%zu threads)", name, threads);
+			Check(bad == 0, what, double(bad));
+			faces = delaunay.indices().size() / 3;
+			if (threads == 1)
+				single = Triangles(delaunay);
+			else if (unique) {
+				std::snprintf(what, sizeof(what), "%s: threads produce the same triangles", name);
+				Check(Triangles(delaunay) == single, what, double(faces));
+			}
+		}
+	}
+
+	void Random() {
+		std::mt19937_64 engine{ 0xde1a };
+		const auto unit = [&]() { return double(engine() >> 11) * 0x1.0p-53 * 2 - 1; };
+		std::vector<num::Vec<double>> points(150000);
+		for (num::Vec<double>& p : points)
+			p = num::Vec<double>{ unit(), unit(), unit() * 0.1 };
+		Run("random", points, true);
+
+		/* duplicates of every point, which are only triangulated once */
+		std::vector<num::Vec<double>> duplicates;
+		for (size_t i = 0; i < 70000; ++i) {
+			duplicates.push_back(points[i]);
+			duplicates.push_back(num::Vec<double>{ points[i].x, points[i].y, points[i].z + 1 });
+		}
+		std::shuffle(duplicates.begin(), duplicates.end(), engine);
+		Run("duplicate", duplicates, false);
+	}
+
+	void Grid() {
+		std::vector<num::Vec<double>> points;
+		for (int y = 0; y < 400; ++y) {
+			for (int x = 0; x < 400; ++x)
+				points.push_back(num::Vec<double>{ double(x), double(y), double((x * 7 + y * 3) % 5) });
+		}
+		Run("grid", points, false);
+	}
+
+	void Circle() {
+		/* concentric circles, whose points are co-circular up to the rounding of the sine and cosine */
+		std::vector<num::Vec<double>> points;
+		for (size_t i = 0; i < 2000; ++i) {
+			const double a = double(i) * (2 * num::Const<double>::Pi / 1000), r = (i < 1000 ? 1.0 : 0.5);
+			points.push_back(num::Vec<double>{ r * std::cos(a), r * std::sin(a), 0 });
+		}
+		Run("co-circular", points, false);
+	}
+
+	void Collinear() {
+		num::Delaunay<double> delaunay;
+		std::vector<num::Vec<double>> points;
+		for (size_t i = 0; i < 1000; ++i)
+			points.push_back(num::Vec<double>{ double(i) * 0.25, double(i) * 0.5, 0 });
+
+		size_t built = 0;
+		for (size_t threads : { size_t(1), Threads })
+			built += (delaunay.build(points, Frame, threads) || !delaunay.indices().empty() ? 1 : 0);
+		Check(built == 0, "collinear: rejected", double(built));
+
+		/* a single point off the line forms a fan with all points on the hull */
+		points.push_back(num::Vec<double>{ 10, -3, 0 });
+		Run("fan", points, true);
+	}
+}
+
+int main() {
+	Random();
+	Grid();
+	Circle();
+	Collinear();
+	return (Failed > 0 ? 1 : 0);
+}
@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Check of the fixed-point geometry against the floating point geometry
+*	- lengths, line intersections and triangle tests must hold for values, whose intermediate products exceed the range
+*		of the type (e.g. a Q16 plane spanned by vectors of 100 units, whose normal has a length of 10000)
+*	- random intersections must follow num::Plane::intersect within the resolution scaled by the line direction, and
+*		random triangle tests must match num::Plane::inTriangle away from the edges
+*	- the bulk dot products and plane sides must be bit-identical to the scalar operations
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	/* largest absolute component of [v] */
+	double Largest(const num::Vec<double>& v) {
+		return std::max({ num::Abs(v.x), num::Abs(v.y), num::Abs(v.z) });
+	}
+
+	template <num::FixedPoint Type>
+	struct Random {
+		std::mt19937_64 engine{ 0xf1 + Type::Bits };
+
+		/* uniform value within [-range; range] on a grid of 2^-12, which both the fixed-point and the double representation hold exactly */
+		double value(double range) {
+			return std::round((double(engine() >> 11) * 0x1.0p-53 * 2 - 1) * range * 4096) / 4096;
+		}
+		num::Vec<double> vec(double range) {
+			return num::Vec<double>{ value(range), value(range), value(range) };
+		}
+	};
+
+	template <num::FixedPoint Type>
+	void Fixed(const char* name, double range, double span) {
+		using Vec = num::FixedVec<Type>;
+		const double resolution = 1.0 / double(uint64_t(1) << Type::Bits);
+		char what[64] = { 0 };
+
+		/* lengths and intersections beyond the square root of the range */
+		const double length = Vec{ Type{ 200 }, Type{ 0 }, Type{ 0 } }.len().template to<double>();
+		std::snprintf(what, sizeof(what), "%s: length of (200, 0, 0)", name);
+		Check(length == 200, what, length);
+
+		bool invalid = true;
+		const num::FixedPlane<Type> plane{ Vec{ Type{ 0 }, Type{ 0 }, Type{ 10 } }, Vec{ Type{ 100 }, Type{ 0 }, Type{ 0 } }, Vec{ Type{ 0 }, Type{ 100 }, Type{ 0 } } };
+		const num::FixedLine<Type> line{ Vec{ Type{ 20 }, Type{ 30 }, Type{ 50 } }, Vec{ Type{ 0 }, Type{ 0 }, Type{ -1 } } };
+		const Vec hit = plane.intersect(line, &invalid);
+		std::snprintf(what, sizeof(what), "%s: vertical intersection (z)", name);
+		Check(!invalid && hit == Vec{ Type{ 20 }, Type{ 30 }, Type{ 10 } }, what, hit.z.template to<double>());
+		std::snprintf(what, sizeof(what), "%s: triangle of 100 units", name);
+		Check(plane.inTriangle(Vec{ Type{ 20 }, Type{ 30 }, Type{ 10 } }) && !plane.inTriangle(Vec{ Type{ 60 }, Type{ 50 }, Type{ 10 } }), what, 0);
+
+		/* random intersections against the double geometry */
+		Random<Type> random;
+		double error = 0;
+		size_t wrong = 0, tested = 0;
+		for (size_t i = 0; i < 20000; ++i) {
+			const num::Plane<double> p{ random.vec(range), random.vec(span), random.vec(span) };
+			const num::Line<double> l{ random.vec(range), random.vec(span) };
+			const num::FixedPlane<Type> fp{ Vec{ p.o }, Vec{ p.a }, Vec{ p.b } };
+			const num::FixedLine<Type> fl{ Vec{ l.o }, Vec{ l.d } };
+
+			/* skip nearly parallel lines, whose intersections lie outside of the range */
+			bool parallel = false, fparallel = false;
+			const num::Vec<double> expected = p.intersect(l, &parallel);
+			if (parallel || num::Abs(l.d.norm().dot(p.normal().norm())) < 0.05 || Largest(expected) > range * 4)
+				continue;
+			const num::Vec<double> actual = fp.intersect(fl, &fparallel).template to<double>();
+			wrong += (fparallel ? 1 : 0);
+			error = std::max(error, Largest(actual - expected) / (l.d.len() * 20 + 4));
+			++tested;
+
+			/* points within the triangle span, which are tested away from the edges */
+			const double s = random.value(1) + 0.5, t = random.value(1) + 0.5;
+			if (std::min({ num::Abs(s), num::Abs(t), num::Abs(1 - s - t) }) < 1e-3)
+				continue;
+			const Vec point{ p.point(s, t) };
+			wrong += (fp.inTriangle(point) != p.inTriangle(point.template to<double>()) ? 1 : 0);
+		}
+		std::snprintf(what, sizeof(what), "%s: intersections tested", name);
+		Check(tested > 10000, what, double(tested));
+		std::snprintf(what, sizeof(what), "%s: wrong parallel or triangle tests", name);
+		Check(wrong == 0, what, double(wrong));
+		std::snprintf(what, sizeof(what), "%s: max intersection error (resolution)", name);
+		Check(error <= resolution, what, error / resolution);
+
+		/* bulk operations against the scalar operations */
+		std::vector<Vec> a, b;
+		for (size_t i = 0; i < 50000; ++i) {
+			a.push_back(Vec{ random.vec(span) });
+			b.push_back(Vec{ random.vec(span) });
+		}
+		std::vector<Type> dots(a.size()), sides(a.size());
+		Vec::Dots(a, b, dots, 4);
+		plane.sides(a, sides, 4);
+		size_t differ = 0;
+		for (size_t i = 0; i < a.size(); ++i)
+			differ += (dots[i] == a[i].dot(b[i]) && sides[i] == (a[i] - plane.o).dot(plane.normal()) ? 0 : 1);
+		std::snprintf(what, sizeof(what), "%s: bulk results differing from scalar", name);
+		Check(differ == 0, what, double(differ));
+	}
+}
+
+int main() {
+	Fixed<num::Q16>("q16", 1000, 150);
+	Fixed<num::Q32>("q32", 1e6, 2e4);
+	return (Failed > 0 ? 1 : 0);
+}
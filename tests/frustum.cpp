@@ -0,0 +1,151 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Check of the bulk and hierarchical culling of num::Frustum against the per-object tests
+*	- num::Frustum::cull of boxes and spheres must collect exactly the objects, which pass num::Frustum::visible (or
+*		num::Frustum::test for partial masks), for every number of threads
+*	- num::Frustum::collect, which tests children only against the planes their parent straddles, must collect the
+*		same nodes as num::Octree::frustum, with and without plane coherency hints kept across calls
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	template <std::floating_point Type>
+	struct Random {
+		std::mt19937_64 engine{ 0xf405 + sizeof(Type) };
+
+		Type unit() {
+			return Type(double(engine() >> 11) * 0x1.0p-53 * 2 - 1);
+		}
+		num::Vec<Type> vec() {
+			return num::Vec<Type>{ unit(), unit(), unit() };
+		}
+
+		/* view frustum of a camera at [eye] looking along [dir] (near, far, and four side planes, normals pointing outwards) */
+		std::vector<num::Plane<Type>> frustum(const num::Vec<Type>& eye, const num::Vec<Type>& dir, Type near, Type far, Type spread) {
+			const num::Vec<Type> f = dir.norm();
+			const num::Vec<Type> r = f.cross(num::Abs(f.z) < Type(0.9) ? num::Vec<Type>::AxisZ() : num::Vec<Type>::AxisX()).norm();
+			const num::Vec<Type> u = r.cross(f);
+			std::vector<num::Plane<Type>> planes;
+			planes.push_back(num::Plane<Type>{ eye + f * near, r, u });
+			planes.push_back(num::Plane<Type>{ eye + f * far, u, r });
+			for (const num::Vec<Type>& side : { r, -r, u, -u }) {
+				/* plane through the eye containing the direction [f + side * spread] and the perpendicular of both */
+				const num::Vec<Type> edge = f + side * spread, across = f.cross(side);
+				planes.push_back(edge.cross(across).dot(side) > 0 ? num::Plane<Type>{ eye, edge, across } : num::Plane<Type>{ eye, across, edge });
+			}
+			return planes;
+		}
+	};
+
+	template <std::floating_point Type>
+	void Bulk(const char* name) {
+		Random<Type> random;
+		char what[64] = { 0 };
+
+		/* boxes and spheres of mixed sizes around the frustum */
+		num::BoxSet<Type> boxes;
+		num::SphereSet<Type> spheres;
+		std::vector<num::Box<Type>> boxList;
+		std::vector<num::Sphere<Type>> sphereList;
+		for (size_t i = 0; i < 100000; ++i) {
+			const num::Vec<Type> c = random.vec() * Type(4), h = (random.vec() + num::Vec<Type>{ 1 }) * Type(0.05);
+			boxList.push_back(num::Box<Type>{ c - h, c + h });
+			boxes.push(boxList.back());
+			sphereList.push_back(num::Sphere<Type>{ c, h.x });
+			spheres.push(sphereList.back());
+		}
+
+		size_t differ = 0, visible = 0;
+		num::CullBuffer buffer;
+		for (size_t q = 0; q < 8; ++q) {
+			const std::vector<num::Plane<Type>> planes = random.frustum(random.vec(), random.vec(), Type(0.1), Type(4), Type(0.3) + Type(0.3) * random.unit());
+			const num::Frustum<Type> frustum{ planes };
+
+			/* full mask and a partial mask, which skips the near and one side plane */
+			for (uint32_t mask : { frustum.all(), frustum.all() & ~uint32_t(0b100001) }) {
+				for (size_t threads : { 1, 4 }) {
+					std::vector<uint32_t> expected;
+					for (size_t i = 0; i < boxList.size(); ++i) {
+						uint32_t m = mask;
+						if (mask == frustum.all() ? frustum.visible(boxList[i]) : frustum.test(boxList[i], m))
+							expected.push_back(uint32_t(i));
+					}
+					const size_t count = frustum.cull(boxes, buffer, mask, threads);
+					differ += (count == expected.size() && std::equal(expected.begin(), expected.end(), buffer.visible().begin(), buffer.visible().end()) ? 0 : 1);
+					visible += count;
+
+					expected.clear();
+					for (size_t i = 0; i < sphereList.size(); ++i) {
+						uint32_t m = mask;
+						if (mask == frustum.all() ? frustum.visible(sphereList[i]) : frustum.test(sphereList[i], m))
+							expected.push_back(uint32_t(i));
+					}
+					const size_t spheresVisible = frustum.cull(spheres, buffer, mask, threads);
+					differ += (spheresVisible == expected.size() && std::equal(expected.begin(), expected.end(), buffer.visible().begin(), buffer.visible().end()) ? 0 : 1);
+				}
+			}
+		}
+		std::snprintf(what, sizeof(what), "%s: bulk differing from visible", name);
+		Check(differ == 0, what, double(differ));
+		std::snprintf(what, sizeof(what), "%s: fraction of visible boxes", name);
+		Check(visible > 0 && visible < 32 * boxList.size() / 2, what, double(visible) / double(32 * boxList.size()));
+	}
+
+	template <std::floating_point Type>
+	void Hierarchy(const char* name) {
+		Random<Type> random;
+		char what[64] = { 0 };
+
+		std::vector<num::Vec<Type>> points;
+		for (size_t i = 0; i < 50000; ++i)
+			points.push_back(i % 3 == 0 ? random.vec() * Type(4) : random.vec() * Type(0.3) + num::Vec<Type>{ Type(1), Type(-0.5), Type(0.25) });
+		num::Octree<Type> octree;
+		octree.build(points, 8);
+
+		std::vector<size_t> expected, found;
+		std::vector<uint8_t> hints(octree.nodes().size(), 0);
+		size_t differ = 0, collected = 0, total = 0;
+		for (size_t q = 0; q < 40; ++q) {
+			const std::vector<num::Plane<Type>> planes = random.frustum(random.vec() * Type(3), random.vec(), Type(0.1), Type(5), Type(0.2) + Type(0.4) * (random.unit() + 1));
+			const num::Frustum<Type> frustum{ planes };
+			const uint32_t level = uint32_t(q % (octree.depth() + 2));
+
+			octree.frustum(planes, level, expected);
+			std::sort(expected.begin(), expected.end());
+
+			/* without hints and twice with the hints kept across calls */
+			for (size_t pass = 0; pass < 3; ++pass) {
+				frustum.collect(octree, level, found, (pass == 0 ? std::span<uint8_t>{} : std::span<uint8_t>{ hints }));
+				std::sort(found.begin(), found.end());
+				differ += (found == expected ? 0 : 1);
+			}
+			collected += expected.size();
+			total += octree.nodes().size();
+		}
+		std::snprintf(what, sizeof(what), "%s: collect differing from the octree", name);
+		Check(differ == 0 && collected > 0 && collected < total, what, double(differ));
+	}
+}
+
+int main() {
+	Bulk<float>("float");
+	Bulk<double>("double");
+	Hierarchy<float>("float");
+	Hierarchy<double>("double");
+	return (Failed > 0 ? 1 : 0);
+}
@@ -0,0 +1,496 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Accuracy and timing harness of the public functions of num::Vec, num::Line, num::Plane, and num::fast
+*	- every case evaluates a function in float and double on the same (float representable) random and adversarial
+*		inputs, and measures the drift (num::Drift) of both against the long double evaluation as reference
+*	- every case is timed in float and double, relative to a fixed calibration loop to factor out the clock rate
+*	- the results are compared against a baseline file, and any drift beyond [tolerance] times the baseline or any
+*		slowdown beyond [slowdown] times the baseline fails the run (--update rewrites the baseline instead)
+*	- samples, for which any evaluation reports an invalid result (nan or infinity), are skipped and counted
+*	- not covered are the predicates (e.g. num::Plane::inTriangle, num::Plane::touch, num::Vec::parallel), as they have
+*		no drift and only threshold the values of covered cases (num::Plane::linear, num::Vec::cross), the exact
+*		constructors and component selections (e.g. Axis*, plane*, point, scale, comp), the variants of the other axes
+*		of the covered X functions (Y and Z only permute the components, except for the covered steepest* and rotate*),
+*		num::Vec::delta, which is only defined for parallel vectors, and the functions composed of covered cases
+*		(e.g. rescalef, projectf, reachf, passPointf, intersectf)
+*
+*	usage: num-harness [--accuracy] [--timing] [--baseline file] [--update] [--tolerance x] [--slowdown x] [--samples n]
+*/
+
+namespace {
+	/*
+	*	deterministic source of inputs (the std distributions are implementation defined, the raw engine is not)
+	*	- regular inputs are uniform within [-1; 1], adversarial inputs mix in zeros, small integers, a wide exponent
+	*		range, and nearly parallel vectors, which expose the ill-conditioned paths of the functions
+	*/
+	struct Inputs {
+	private:
+		std::mt19937_64 pEngine;
+		bool pAdversarial = false;
+
+	public:
+		Inputs(uint64_t seed, bool adversarial) : pEngine{ seed }, pAdversarial{ adversarial } {}
+
+	public:
+		/* uniform value within [0; 1) */
+		double unit() {
+			return double(pEngine() >> 11) * 0x1.0p-53;
+		}
+
+		/* uniform index within [0; count) */
+		size_t pick(size_t count) {
+			return size_t(pEngine() % count);
+		}
+
+		/* scalar of mixed magnitudes, including zeros, small integers, and a wide exponent range */
+		float scalar() {
+			if (!pAdversarial)
+				return float(unit() * 2 - 1);
+			switch (pick(8)) {
+			case 0:
+				return 0.0f;
+			case 1:
+				return float(int(pick(9)) - 4);
+			case 2:
+			case 3:
+				return float((pick(2) ? -1 : 1) * std::ldexp(1 + unit(), int(pick(33)) - 16));
+			default:
+				return float(unit() * 2 - 1);
+			}
+		}
+
+		/* vector of mixed magnitudes */
+		num::Vec<float> vec() {
+			return num::Vec<float>{ scalar(), scalar(), scalar() };
+		}
+
+		/* vector nearly parallel to [v] */
+		num::Vec<float> near(const num::Vec<float>& v) {
+			const num::Vec<float> noise{ float(unit() - 0.5), float(unit() - 0.5), float(unit() - 0.5) };
+			return v * float(unit() * 4 - 2) + noise * 1e-4f;
+		}
+
+		/* vector, which is nearly parallel to [v] for a quarter of the adversarial calls */
+		num::Vec<float> other(const num::Vec<float>& v) {
+			return (pAdversarial && pick(4) == 0 ? near(v) : vec());
+		}
+
+		/* angle in degrees, including multiples of the right angle for adversarial calls */
+		float angle() {
+			return (pAdversarial && pick(4) == 0 ? float(90 * int(pick(8))) : float(unit() * 720 - 360));
+		}
+
+		/* line with a direction of mixed magnitude */
+		num::Line<float> line() {
+			return num::Line<float>{ vec(), vec() };
+		}
+
+		/* plane, which is nearly degenerate for a quarter of the adversarial calls */
+		num::Plane<float> plane() {
+			const num::Vec<float> a = vec();
+			return num::Plane<float>{ vec(), a, other(a) };
+		}
+
+		/* line, which is nearly parallel to the plane [p] for a quarter of the adversarial calls */
+		num::Line<float> crossing(const num::Plane<float>& p) {
+			const num::Vec<float> d = (pAdversarial && pick(4) == 0 ? near(p.a) + near(p.b) : vec());
+			return num::Line<float>{ vec(), d };
+		}
+	};
+
+	/* lift the float inputs to the evaluated type */
+	template <class Type>
+	Type Lift(float v) {
+		return Type(v);
+	}
+	template <class Type, class Obj>
+	auto Lift(const Obj& o) {
+		return num::Convert<Type>(o);
+	}
+	template <class Type, class... Args>
+	auto LiftAll(const std::tuple<Args...>& args) {
+		return std::apply([](const Args&... a) { return std::tuple{ Lift<Type>(a)... }; }, args);
+	}
+
+	/* check if the result is finite in all components */
+	template <std::floating_point Type>
+	bool Finite(Type v) {
+		return std::isfinite(v);
+	}
+	template <std::floating_point Type>
+	bool Finite(const num::Vec<Type>& v) {
+		return Finite(v.x) && Finite(v.y) && Finite(v.z);
+	}
+	template <std::floating_point Type>
+	bool Finite(const num::Line<Type>& l) {
+		return Finite(l.o) && Finite(l.d);
+	}
+	template <std::floating_point Type>
+	bool Finite(const num::Plane<Type>& p) {
+		return Finite(p.o) && Finite(p.a) && Finite(p.b);
+	}
+
+	/* measured state of a single case */
+	struct Entry {
+		num::Drift<float> f;
+		num::Drift<double> d;
+		double timeF = 0;
+		double timeD = 0;
+		size_t skipped = 0;
+	};
+
+	struct Case {
+		std::string name;
+		std::function<void(Inputs&, size_t, Entry&)> accuracy;
+		std::function<void(Inputs&, Entry&)> timing;
+	};
+
+	/* size of the input arrays of the timing runs and duration of a single timed run */
+	constexpr size_t TimingItems = 1024;
+	constexpr double TimingRun = 1e-3;
+	constexpr size_t TimingRepeats = 5;
+
+	/* sink, which keeps the timed results alive */
+	volatile float Sink = 0;
+
+	/* measure the best time per call in nanoseconds of [fn] over [items] pre-generated inputs */
+	template <class Type, class Gen, class Fn>
+	double Time(Inputs& in, const Gen& gen, const Fn& fn) {
+		using Args = decltype(LiftAll<Type>(gen(in)));
+		using Result = decltype(std::apply(fn, std::declval<Args>()));
+		std::vector<Args> args;
+		for (size_t i = 0; i < TimingItems; ++i)
+			args.push_back(LiftAll<Type>(gen(in)));
+		std::vector<Result> out(TimingItems);
+
+		double best = std::numeric_limits<double>::infinity();
+		for (size_t r = 0; r < TimingRepeats; ++r) {
+			size_t calls = 0;
+			const auto start = std::chrono::steady_clock::now();
+			double elapsed = 0;
+			do {
+				for (size_t i = 0; i < TimingItems; ++i)
+					out[i] = std::apply(fn, args[i]);
+				calls += TimingItems;
+				elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			} while (elapsed < TimingRun);
+			best = std::min(best, elapsed * 1e9 / double(calls));
+		}
+		Sink = Sink + float(Finite(out[TimingItems / 2]));
+		return best;
+	}
+
+	/* create the case of the function [fn] over the inputs of [gen] with the long double reference [ref] */
+	template <class Gen, class Fn, class Ref>
+	Case Make(const char* name, Gen gen, Fn fn, Ref ref) {
+		Case c;
+		c.name = name;
+		c.accuracy = [=](Inputs& in, size_t samples, Entry& e) {
+			for (size_t i = 0; i < samples; ++i) {
+				const auto args = gen(in);
+				const auto f = std::apply(fn, LiftAll<float>(args));
+				const auto d = std::apply(fn, LiftAll<double>(args));
+				const auto l = std::apply(ref, LiftAll<long double>(args));
+				if (!Finite(f) || !Finite(d) || !Finite(l)) {
+					++e.skipped;
+					continue;
+				}
+				e.f.add(f, l);
+				e.d.add(d, l);
+			}
+		};
+		c.timing = [=](Inputs& in, Entry& e) {
+			e.timeF = Time<float>(in, gen, fn);
+			e.timeD = Time<double>(in, gen, fn);
+		};
+		return c;
+	}
+	template <class Gen, class Fn>
+	Case Make(const char* name, Gen gen, Fn fn) {
+		return Make(name, gen, fn, fn);
+	}
+
+	/* value, which marks an invalid result to be skipped */
+	template <std::floating_point Type>
+	num::Vec<Type> Invalid(bool invalid, const num::Vec<Type>& v) {
+		return (invalid ? num::Vec<Type>{ std::numeric_limits<Type>::quiet_NaN() } : v);
+	}
+	template <std::floating_point Type>
+	num::Line<Type> Invalid(bool invalid, const num::Line<Type>& l) {
+		return (invalid ? num::Line<Type>{ Invalid(true, l.o), l.d } : l);
+	}
+
+	std::vector<Case> Cases() {
+		const auto vec = [](Inputs& in) { return std::tuple{ in.vec() }; };
+		const auto vecs = [](Inputs& in) { const num::Vec<float> a = in.vec(); return std::tuple{ a, in.other(a) }; };
+		const auto vecAngle = [](Inputs& in) { return std::tuple{ in.vec(), in.angle() }; };
+		const auto vecScalar = [](Inputs& in) { return std::tuple{ in.vec(), in.scalar() }; };
+		const auto linePoint = [](Inputs& in) { return std::tuple{ in.line(), in.vec() }; };
+		const auto lines = [](Inputs& in) { const num::Line<float> l = in.line(); return std::tuple{ l, num::Line<float>{ in.vec(), in.other(l.d) } }; };
+		const auto plane = [](Inputs& in) { return std::tuple{ in.plane() }; };
+		const auto planePoint = [](Inputs& in) { return std::tuple{ in.plane(), in.vec() }; };
+		const auto planeLine = [](Inputs& in) { const num::Plane<float> p = in.plane(); return std::tuple{ p, in.crossing(p) }; };
+		const auto planes = [](Inputs& in) { const num::Plane<float> p = in.plane(); return std::tuple{ p, num::Plane<float>{ in.vec(), in.other(p.a), in.other(p.b) } }; };
+		const auto ratio = [](Inputs& in) { return std::tuple{ in.scalar(), in.scalar() }; };
+		const auto cosine = [](Inputs& in) { return std::tuple{ float(in.unit() * 2 - 1) }; };
+		const auto vecsScalar = [](Inputs& in) { const num::Vec<float> a = in.vec(); return std::tuple{ a, in.other(a), in.scalar() }; };
+		const auto lineScalar = [](Inputs& in) { return std::tuple{ in.line(), in.scalar() }; };
+		const auto lineOn = [](Inputs& in) { const num::Line<float> l = in.line(); return std::tuple{ l, l.point(in.scalar()) }; };
+		const auto planeScalar = [](Inputs& in) { return std::tuple{ in.plane(), in.scalar() }; };
+		const auto meeting = [](Inputs& in) {
+			/* lines through a common point, whose points lie on a grid of 2^-12, such that the directions are exact in float */
+			const auto snap = [](const num::Vec<float>& v) { return num::Vec<float>{ std::round(v.x * 4096) / 4096, std::round(v.y * 4096) / 4096, std::round(v.z * 4096) / 4096 }; };
+			const num::Vec<float> p = snap(in.vec()), a = snap(in.vec()), b = snap(p + in.other(p - a));
+			return std::tuple{ num::Line<float>{ a, p - a }, num::Line<float>{ b, p - b } };
+		};
+
+		return {
+			Make("vec.dot", vecs, [](const auto& a, const auto& b) { return a.dot(b); }),
+			Make("vec.cross", vecs, [](const auto& a, const auto& b) { return a.cross(b); }),
+			Make("vec.len", vec, [](const auto& a) { return a.len(); }),
+			Make("vec.norm", vec, [](const auto& a) { return a.norm(); }),
+			Make("vec.angle", vecs, [](const auto& a, const auto& b) { return a.angle(b); }),
+			Make("vec.rotateX", vecAngle, [](const auto& a, auto t) { return a.rotateX(t); }),
+			Make("vec.rotateZ", vecAngle, [](const auto& a, auto t) { return a.rotateZ(t); }),
+			Make("vec.rescale", vecScalar, [](const auto& a, auto l) { return a.rescale(l); }),
+			Make("vec.project", vecs, [](const auto& a, const auto& b) { return a.project(b); }),
+			Make("vec.perpendicular", vecs, [](const auto& a, const auto& b) { return a.perpendicular(b); }),
+			Make("vec.passPoint", vecs, [](const auto& a, const auto& b) { return a.passPoint(b); }),
+			Make("line.closestf", linePoint, [](const auto& l, const auto& p) { return l.closestf(p); }),
+			Make("line.closest", linePoint, [](const auto& l, const auto& p) { return l.closest(p); }),
+			Make("line.closestLine", lines, [](const auto& a, const auto& b) { return a.closest(b); }),
+			Make("line.norm", linePoint, [](const auto& l, const auto&) { return l.norm(); }),
+			Make("plane.normal", plane, [](const auto& p) { return p.normal(); }),
+			Make("plane.area", plane, [](const auto& p) { return p.area(); }),
+			Make("plane.norm", plane, [](const auto& p) { return p.norm(); }),
+			Make("plane.closest", planePoint, [](const auto& p, const auto& v) { return p.closest(v); }),
+			Make("plane.closestTriangle", planePoint, [](const auto& p, const auto& v) { return p.closestTriangle(v); }),
+			Make("plane.project", planePoint, [](const auto& p, const auto& v) { return p.project(v); }),
+			Make("plane.solidAngle", planePoint, [](const auto& p, const auto& v) { return p.solidAngle(v); }),
+			Make("plane.linear", planePoint, [](const auto& p, const auto& v) {
+				bool touching = false;
+				const auto lin = p.linear(v, &touching);
+				return decltype(v){ lin.s, lin.t, 0 };
+			}),
+			Make("plane.intersectLine", planeLine, [](const auto& p, const auto& l) {
+				bool invalid = false;
+				const auto v = p.intersect(l, &invalid);
+				return Invalid(invalid, v);
+			}),
+			Make("plane.intersectPlane", planes, [](const auto& a, const auto& b) {
+				bool invalid = false;
+				const auto l = a.intersect(b, &invalid);
+				return Invalid(invalid, l);
+			}),
+			Make("fast.len", vec, [](const auto& a) { return num::fast::Len(a); }, [](const auto& a) { return a.len(); }),
+			Make("fast.norm", vec, [](const auto& a) { return num::fast::Norm(a); }, [](const auto& a) { return a.norm(); }),
+			Make("fast.angle", vecs, [](const auto& a, const auto& b) { return num::fast::Angle(a, b); }, [](const auto& a, const auto& b) { return a.angle(b); }),
+			Make("fast.acos", cosine, [](auto v) { return num::fast::Acos(v); }, [](auto v) { return num::Acos(v); }),
+			Make("fast.atan2", ratio, [](auto y, auto x) { return num::fast::Atan2(y, x); }, [](auto y, auto x) { return num::Atan2(y, x); }),
+
+			/* appended after the initial cases, as the seeds of the inputs are derived from the position of the case */
+			Make("vec.rotateY", vecAngle, [](const auto& a, auto t) { return a.rotateY(t); }),
+			Make("vec.angleX", vecs, [](const auto& a, const auto& b) { return a.angleX(b); }),
+			Make("vec.angleY", vecs, [](const auto& a, const auto& b) { return a.angleY(b); }),
+			Make("vec.angleZ", vecs, [](const auto& a, const auto& b) { return a.angleZ(b); }),
+			Make("vec.interpolate", vecsScalar, [](const auto& a, const auto& b, auto t) { return a.interpolate(b, t); }),
+			Make("vec.reach", vecs, [](const auto& a, const auto& b) { return a.reach(b); }),
+			Make("vec.passing", vecs, [](const auto& a, const auto& b) { return a.passing(b); }),
+			Make("line.find", lineOn, [](const auto& l, const auto& p) { return l.find(p); }),
+			Make("line.intersect", meeting, [](const auto& a, const auto& b) {
+				bool invalid = false;
+				const auto v = a.intersect(b, &invalid);
+				return Invalid(invalid, v);
+			}),
+			Make("line.intersectX", lines, [](const auto& a, const auto& b) {
+				bool invalid = false;
+				const auto v = a.intersectX(b, &invalid);
+				return Invalid(invalid, v);
+			}),
+			Make("line.intersectPlaneX", lineScalar, [](const auto& l, auto x) {
+				bool invalid = false;
+				const auto v = l.intersectPlaneX(x, &invalid);
+				return Invalid(invalid, v);
+			}),
+			Make("plane.center", plane, [](const auto& p) { return p.center(); }),
+			Make("plane.projectX", planePoint, [](const auto& p, const auto& v) { return p.projectX(v); }),
+			Make("plane.linearX", planePoint, [](const auto& p, const auto& v) {
+				const auto lin = p.linearX(v);
+				return decltype(v){ lin.s, lin.t, 0 };
+			}),
+			Make("plane.steepestX", plane, [](const auto& p) { return p.steepestX(); }),
+			Make("plane.steepestY", plane, [](const auto& p) { return p.steepestY(); }),
+			Make("plane.steepestZ", plane, [](const auto& p) { return p.steepestZ(); }),
+			Make("plane.intersectPlaneX", planeScalar, [](const auto& p, auto x) {
+				bool invalid = false;
+				const auto l = p.intersectPlaneX(x, &invalid);
+				return Invalid(invalid, l);
+			}),
+			Make("fast.rescale", vecScalar, [](const auto& a, auto l) { return num::fast::Rescale(a, l); }, [](const auto& a, auto l) { return a.rescale(l); }),
+			Make("fast.toAngle", ratio, [](auto x, auto y) { return num::fast::ToAngle(x, y); }, [](auto x, auto y) { return num::ToAngle(x, y); })
+		};
+	}
+
+	/* measure the clock rate by a dependent chain of multiplications and additions (nanoseconds per step) */
+	double Calibrate() {
+		double best = std::numeric_limits<double>::infinity();
+		for (size_t r = 0; r < TimingRepeats; ++r) {
+			volatile double seed = 0.999999;
+			double x = 1, f = seed;
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < (1 << 20); ++i)
+				x = x * f + 1e-9;
+			const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			Sink = Sink + float(x);
+			best = std::min(best, elapsed * 1e9 / double(1 << 20));
+		}
+		return best;
+	}
+
+	std::map<std::string, Entry> Load(const std::string& path, bool& found) {
+		std::map<std::string, Entry> out;
+		std::ifstream file{ path };
+		found = file.is_open();
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.empty() || line[0] == '#')
+				continue;
+			std::istringstream s{ line };
+			std::string name;
+			Entry e;
+			s >> name >> e.f.maxUlps >> e.f.maxError >> e.d.maxUlps >> e.d.maxError >> e.timeF >> e.timeD;
+			if (s)
+				out[name] = e;
+		}
+		return out;
+	}
+
+	bool Store(const std::string& path, const std::vector<std::pair<std::string, Entry>>& rows) {
+		std::ofstream file{ path };
+		if (!file.is_open())
+			return false;
+		file << "# case float-ulps float-error double-ulps double-error float-time double-time (times relative to the calibration loop)\n";
+		char buffer[512] = { 0 };
+		for (const auto& [name, e] : rows) {
+			std::snprintf(buffer, sizeof(buffer), "%s %llu %.9g %llu %.17g %.4f %.4f\n", name.c_str(), (unsigned long long)e.f.maxUlps,
+				double(e.f.maxError), (unsigned long long)e.d.maxUlps, e.d.maxError, e.timeF, e.timeD);
+			file << buffer;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv) {
+	bool accuracy = false, timing = false, update = false;
+	std::string baseline;
+	double tolerance = 1, slowdown = 2;
+	size_t samples = 200000;
+	for (int i = 1; i < argc; ++i) {
+		const bool more = (i + 1 < argc);
+		if (std::strcmp(argv[i], "--accuracy") == 0)
+			accuracy = true;
+		else if (std::strcmp(argv[i], "--timing") == 0)
+			timing = true;
+		else if (std::strcmp(argv[i], "--update") == 0)
+			update = true;
+		else if (std::strcmp(argv[i], "--baseline") == 0 && more)
+			baseline = argv[++i];
+		else if (std::strcmp(argv[i], "--tolerance") == 0 && more)
+			tolerance = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--slowdown") == 0 && more)
+			slowdown = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--samples") == 0 && more)
+			samples = size_t(std::atoll(argv[++i]));
+		else {
+			std::fprintf(stderr, "usage: %s [--accuracy] [--timing] [--baseline file] [--update] [--tolerance x] [--slowdown x] [--samples n]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (update && baseline.empty()) {
+		std::fprintf(stderr, "--update requires a --baseline file\n");
+		return 2;
+	}
+	if (update || (!accuracy && !timing))
+		accuracy = timing = true;
+
+	bool found = false;
+	const std::map<std::string, Entry> reference = (baseline.empty() ? std::map<std::string, Entry>{} : Load(baseline, found));
+	if (!baseline.empty() && !found && !update) {
+		std::fprintf(stderr, "baseline [%s] could not be read\n", baseline.c_str());
+		return 2;
+	}
+
+	/* evaluate every case on regular inputs (accuracy and timing) and on adversarial inputs (accuracy only) */
+	const std::vector<Case> cases = Cases();
+	const double clock = (timing ? Calibrate() : 1);
+	std::vector<std::pair<std::string, Entry>> rows;
+	size_t failed = 0;
+
+	std::printf("%-34s %10s %10s %10s %10s %8s %8s %8s\n", "case", "f-ulps", "f-error", "d-ulps", "d-error", "f-time", "d-time", "skipped");
+	for (size_t i = 0; i < 2 * cases.size(); ++i) {
+		const Case& c = cases[i / 2];
+		const bool adversarial = (i % 2 == 1);
+		const std::string name = (adversarial ? c.name + "/adversarial" : c.name);
+		Entry e;
+		if (accuracy) {
+			Inputs in{ 0x5eed0000u + i, adversarial };
+			c.accuracy(in, samples, e);
+		}
+		if (timing && !adversarial) {
+			Inputs in{ 0x7111e000u + i, false };
+			c.timing(in, e);
+			e.timeF /= clock;
+			e.timeD /= clock;
+		}
+
+		/* compare the measurements against the baseline */
+		std::string status;
+		auto it = reference.find(name);
+		if (update)
+			status = "updated";
+		else if (baseline.empty())
+			status = "";
+		else if (it == reference.end())
+			status = "no baseline";
+		else {
+			if (accuracy && (e.f.regressed(it->second.f, float(tolerance)) || e.d.regressed(it->second.d, tolerance)))
+				status += "accuracy regressed ";
+			if (timing && !adversarial && (e.timeF > it->second.timeF * slowdown || e.timeD > it->second.timeD * slowdown))
+				status += "slowdown ";
+		}
+		if (!update && !status.empty())
+			++failed;
+
+		std::printf("%-34s %10llu %10.3g %10llu %10.3g %8.3f %8.3f %8zu %s\n", name.c_str(), (unsigned long long)e.f.maxUlps, double(e.f.maxError),
+			(unsigned long long)e.d.maxUlps, e.d.maxError, e.timeF, e.timeD, e.skipped, status.c_str());
+		rows.emplace_back(name, e);
+	}
+
+	if (update) {
+		if (!Store(baseline, rows)) {
+			std::fprintf(stderr, "baseline [%s] could not be written\n", baseline.c_str());
+			return 2;
+		}
+		std::printf("baseline [%s] updated\n", baseline.c_str());
+		return 0;
+	}
+	std::printf("calibration: %.3f ns per step, %zu of %zu cases failed\n", clock, failed, rows.size());
+	return (failed > 0 ? 1 : 0);
+}
@@ -0,0 +1,235 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Check of the queries of num::Octree against brute-force searches over the points and nodes
+*	- nearest and k-nearest must return the closest points (ties resolved by the index)
+*	- frustum and ray queries must return exactly the nodes at the level (or leaves above it), whose bounds are not
+*		outside of the planes or are hit by the line, and the frustum nodes must contain all points inside of the planes
+*	- a saved image must load into an identical octree, which answers the same queries, whereas truncated or
+*		corrupted images must be rejected and leave the octree empty
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	using Octree = num::Octree<double>;
+
+	std::mt19937_64 Engine{ 0x0c7e };
+
+	double Unit() {
+		return double(Engine() >> 11) * 0x1.0p-53 * 2 - 1;
+	}
+	num::Vec<double> Random() {
+		return num::Vec<double>{ Unit(), Unit(), Unit() };
+	}
+
+	/* plane through [q] with the outward normal [n] (the extent vectors are perpendicular to the normal and [a] x [b] points along it) */
+	num::Plane<double> Facing(const num::Vec<double>& q, const num::Vec<double>& n) {
+		const num::Vec<double> a = n.cross(num::Abs(n.x) < 0.5 ? num::Vec<double>::AxisX() : num::Vec<double>::AxisY());
+		return num::Plane<double>{ q, a, n.cross(a) };
+	}
+
+	/* all nodes at the [level] or leaves above it */
+	std::vector<size_t> Targets(const Octree& octree, uint32_t level) {
+		std::vector<size_t> out;
+		const std::span<const Octree::Node> nodes = octree.nodes();
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			if (nodes[i].level == level || (nodes[i].leaf() && nodes[i].level < level))
+				out.push_back(i);
+		}
+		return out;
+	}
+
+	std::vector<size_t> Sorted(std::vector<size_t> v) {
+		std::sort(v.begin(), v.end());
+		return v;
+	}
+
+	void Nearest(const Octree& octree, const std::vector<num::Vec<double>>& points) {
+		std::vector<size_t> found;
+		std::vector<std::pair<double, size_t>> brute(points.size());
+		size_t wrong = 0, wrongK = 0;
+		for (size_t q = 0; q < 200; ++q) {
+			const num::Vec<double> p = Random() * 1.2;
+			for (size_t i = 0; i < points.size(); ++i)
+				brute[i] = { (points[i] - p).lenSquared(), i };
+			const size_t k = 1 + q % 40;
+			std::partial_sort(brute.begin(), brute.begin() + k, brute.end());
+
+			double distance = 0;
+			const size_t nearest = octree.nearest(points, p, &distance);
+			wrong += (nearest == brute[0].second && distance == num::Sqrt(brute[0].first) ? 0 : 1);
+
+			octree.nearest(points, p, k, found);
+			bool same = (found.size() == k);
+			for (size_t i = 0; i < k && same; ++i)
+				same = (found[i] == brute[i].second);
+			wrongK += (same ? 0 : 1);
+		}
+		Check(wrong == 0, "nearest: differing from brute-force", double(wrong));
+		Check(wrongK == 0, "k-nearest: differing from brute-force", double(wrongK));
+
+		std::vector<num::Vec<double>> none;
+		Octree empty;
+		empty.build(none);
+		empty.nearest(none, num::Vec<double>{}, 3, found);
+		Check(empty.nearest(none, num::Vec<double>{}) == 0 && found.empty(), "nearest: empty octree", 0);
+	}
+
+	void Frustum(const Octree& octree, const std::vector<num::Vec<double>>& points) {
+		std::vector<size_t> found;
+		size_t differ = 0, missing = 0, tested = 0;
+		for (size_t q = 0; q < 100; ++q) {
+			/* random convex region of up to six planes around a point near the cloud */
+			const num::Vec<double> center = Random() * 0.8;
+			std::vector<num::Plane<double>> planes;
+			for (size_t i = 0; i < 3 + q % 4; ++i) {
+				const num::Vec<double> n = Random().norm();
+				planes.push_back(Facing(center + n * (0.05 + 0.5 * (Unit() + 1)), n));
+			}
+
+			const uint32_t level = uint32_t(q % (octree.depth() + 2));
+			octree.frustum(planes, level, found);
+			std::vector<size_t> expected;
+			for (size_t index : Targets(octree, level)) {
+				const num::Box<double>& box = octree.nodes()[index].bounds;
+				bool outside = false;
+				for (const num::Plane<double>& p : planes) {
+					const num::Vec<double> n = p.normal();
+					outside = outside || (box.support(-n) - p.o).dot(n) > 0;
+				}
+				if (!outside)
+					expected.push_back(index);
+			}
+			differ += (Sorted(found) == expected ? 0 : 1);
+
+			/* every point inside of all planes must lie within a collected node */
+			std::vector<bool> covered(points.size(), false);
+			for (size_t index : found) {
+				for (size_t i : octree.points(octree.nodes()[index]))
+					covered[i] = true;
+			}
+			for (size_t i = 0; i < points.size(); ++i) {
+				bool inside = true;
+				for (const num::Plane<double>& p : planes)
+					inside = inside && (points[i] - p.o).dot(p.normal()) <= 0;
+				tested += (inside ? 1 : 0);
+				missing += (inside && !covered[i] ? 1 : 0);
+			}
+		}
+		Check(differ == 0, "frustum: nodes differing from brute-force", double(differ));
+		Check(missing == 0 && tested > 0, "frustum: points inside but not collected", double(missing));
+	}
+
+	void Ray(const Octree& octree) {
+		std::vector<size_t> found;
+		size_t differ = 0, unordered = 0, hits = 0;
+		for (size_t q = 0; q < 300; ++q) {
+			const num::Vec<double> o = Random() * 1.5, d = Random();
+			const uint32_t level = uint32_t(q % (octree.depth() + 2));
+
+			/* lines are hit along their full extent, segments only within [0; 1] */
+			const bool segment = (q % 2 == 1);
+			const double lo = (segment ? 0 : -std::numeric_limits<double>::infinity()), hi = (segment ? 1 : std::numeric_limits<double>::infinity());
+			if (segment)
+				octree.ray(num::Segment<double>{ o, d }, level, found);
+			else
+				octree.ray(num::Line<double>{ o, d }, level, found);
+
+			std::vector<size_t> expected;
+			for (size_t index : Targets(octree, level)) {
+				double t0 = lo, t1 = hi;
+				if (octree.nodes()[index].bounds.clip(o, d, t0, t1))
+					expected.push_back(index);
+			}
+			differ += (Sorted(found) == expected ? 0 : 1);
+			hits += found.size();
+
+			/* the nodes must be sorted by their entry factor */
+			double last = -std::numeric_limits<double>::infinity();
+			for (size_t index : found) {
+				double t0 = lo, t1 = hi;
+				octree.nodes()[index].bounds.clip(o, d, t0, t1);
+				unordered += (t0 < last ? 1 : 0);
+				last = t0;
+			}
+		}
+		Check(differ == 0 && hits > 0, "ray: nodes differing from brute-force", double(differ));
+		Check(unordered == 0, "ray: nodes out of entry order", double(unordered));
+	}
+
+	void Image(const Octree& octree, const std::vector<num::Vec<double>>& points) {
+		std::stringstream stream;
+		octree.save(stream);
+		const std::string image = stream.str();
+
+		/* round-trip into an identical octree */
+		Octree loaded;
+		bool invalid = true;
+		std::istringstream in{ image };
+		loaded.load(in, &invalid);
+		bool same = (!invalid && loaded.depth() == octree.depth() && loaded.nodes().size() == octree.nodes().size() && loaded.order().size() == octree.order().size());
+		same = same && std::memcmp(loaded.nodes().data(), octree.nodes().data(), octree.nodes().size() * sizeof(Octree::Node)) == 0;
+		same = same && std::equal(loaded.order().begin(), loaded.order().end(), octree.order().begin());
+		std::vector<size_t> a, b;
+		for (size_t q = 0; q < 50 && same; ++q) {
+			const num::Vec<double> p = Random(), d = Random();
+			octree.nearest(points, p, 5, a);
+			loaded.nearest(points, p, 5, b);
+			same = (a == b);
+			octree.ray(num::Line<double>{ p, d }, 4, a);
+			loaded.ray(num::Line<double>{ p, d }, 4, b);
+			same = same && (a == b);
+		}
+		Check(same, "image: round-trip identical", double(image.size()));
+
+		/* truncated images at various lengths and a corrupted point index */
+		size_t accepted = 0;
+		for (size_t length : { size_t(0), size_t(16), image.size() / 3, image.size() / 2, image.size() - 1 }) {
+			std::istringstream cut{ image.substr(0, length) };
+			loaded.load(cut, &invalid);
+			accepted += (!invalid || !loaded.nodes().empty() ? 1 : 0);
+		}
+		std::string corrupt = image;
+		const size_t badIndex = points.size() + 7;
+		std::memcpy(corrupt.data() + corrupt.size() - sizeof(size_t), &badIndex, sizeof(size_t));
+		std::istringstream broken{ corrupt };
+		loaded.load(broken, &invalid);
+		accepted += (!invalid || !loaded.nodes().empty() ? 1 : 0);
+		Check(accepted == 0, "image: truncated or corrupt accepted", double(accepted));
+	}
+}
+
+int main() {
+	/* clustered cloud with duplicates, such that the leaves differ in depth and count */
+	std::vector<num::Vec<double>> points;
+	for (size_t i = 0; i < 20000; ++i)
+		points.push_back(i % 4 == 0 ? Random() : Random() * 0.05 + num::Vec<double>{ 0.3, -0.2, 0.1 });
+	for (size_t i = 0; i < 500; ++i)
+		points.push_back(points[i * 7]);
+
+	Octree octree;
+	octree.build(points, 7, 4);
+	Nearest(octree, points);
+	Frustum(octree, points);
+	Ray(octree);
+	Image(octree, points);
+	return (Failed > 0 ? 1 : 0);
+}
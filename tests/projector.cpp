@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Check of num::Projector::raster against brute-force binning
+*	- an empty input must mark every cell as empty and report no points
+*	- the min, max, and mean bins of random points must match a sequential binning of the projections for every
+*		number of threads (the means within rounding, as the chunks sum in a different order)
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	const num::Plane<double> Frame{ num::Vec<double>{ 1, 2, 3 }, num::Vec<double>{ 2, 0, 1 }, num::Vec<double>{ 0, 3, -1 } };
+	constexpr size_t Width = 17, Height = 11;
+	const num::Linear<double> Min{ -1, -2 }, Max{ 3, 2 };
+
+	void Empty() {
+		num::Projector<double> projector{ Frame };
+		std::vector<double> grid(Width * Height, 0);
+		size_t inside = 0, marked = 0;
+		for (size_t threads : { 1, 4 }) {
+			std::fill(grid.begin(), grid.end(), 0.0);
+			inside += projector.raster({}, grid, Width, Height, Min, Max, num::BinMean, threads, -1.0);
+			marked += size_t(std::count(grid.begin(), grid.end(), -1.0));
+		}
+		Check(inside == 0, "empty: points inside", double(inside));
+		Check(marked == 2 * Width * Height, "empty: cells marked as empty", double(marked));
+	}
+
+	void Random() {
+		std::mt19937_64 engine{ 0x9e0 };
+		const auto unit = [&]() { return double(engine() >> 11) * 0x1.0p-53 * 8 - 4; };
+		std::vector<num::Vec<double>> points(300000);
+		for (num::Vec<double>& p : points)
+			p = num::Vec<double>{ unit(), unit(), unit() };
+
+		/* sequential binning of the projections */
+		num::Projector<double> projector{ Frame };
+		std::vector<num::Vec<double>> projected(points.size());
+		projector.project(points, projected, 1);
+		std::vector<double> lo(Width * Height, std::numeric_limits<double>::infinity()), hi(lo.size(), -lo[0]), sum(lo.size(), 0);
+		std::vector<size_t> count(lo.size(), 0);
+		size_t expected = 0;
+		for (const num::Vec<double>& p : projected) {
+			const double cs = (p.x - Min.s) * (double(Width) / (Max.s - Min.s)), ct = (p.y - Min.t) * (double(Height) / (Max.t - Min.t));
+			if (!(cs >= 0 && cs < double(Width) && ct >= 0 && ct < double(Height)))
+				continue;
+			const size_t c = size_t(ct) * Width + size_t(cs);
+			lo[c] = std::min(lo[c], p.z);
+			hi[c] = std::max(hi[c], p.z);
+			sum[c] += p.z;
+			++count[c];
+			++expected;
+		}
+
+		size_t differ = 0, wrong = 0;
+		double error = 0;
+		for (size_t threads : { 1, 3, 8 }) {
+			for (num::Bin bin : { num::BinMin, num::BinMax, num::BinMean }) {
+				std::vector<double> grid(Width * Height);
+				wrong += (projector.raster(points, grid, Width, Height, Min, Max, bin, threads) == expected ? 0 : 1);
+				for (size_t c = 0; c < grid.size(); ++c) {
+					if (count[c] == 0)
+						differ += (std::isnan(grid[c]) ? 0 : 1);
+					else if (bin == num::BinMean)
+						error = std::max(error, num::Abs(grid[c] - sum[c] / double(count[c])));
+					else
+						differ += (grid[c] == (bin == num::BinMin ? lo[c] : hi[c]) ? 0 : 1);
+				}
+			}
+		}
+		Check(wrong == 0, "random: wrong number of points inside", double(wrong));
+		Check(differ == 0, "random: cells differing from brute-force", double(differ));
+		Check(error <= 1e-12, "random: max error of the means", error);
+	}
+}
+
+int main() {
+	Empty();
+	Random();
+	return (Failed > 0 ? 1 : 0);
+}
@@ -0,0 +1,124 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Check of num::Sdf against brute-force distances
+*	- a unit cube, whose distances and signs are known in closed form, must be reproduced exactly
+*	- a convex hull of a sphere must match the minimum over all num::Plane::closestTriangle distances within a tenth
+*		of a cell (jump flooding may miss the nearest triangle far off the surface), with the sign of num::Hull::contains
+*	- the field must be bit-identical for every number of threads, and the float field must follow the double field
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	/* evenly distributed points on the unit sphere (fibonacci lattice) */
+	std::vector<num::Vec<double>> SpherePoints(size_t count) {
+		std::vector<num::Vec<double>> out;
+		const double golden = num::Const<double>::Pi * (3 - num::Sqrt(5.0));
+		for (size_t i = 0; i < count; ++i) {
+			const double z = 1 - 2 * (double(i) + 0.5) / double(count), r = num::Sqrt(1 - z * z);
+			out.push_back(num::Vec<double>{ r * std::cos(golden * double(i)), r * std::sin(golden * double(i)), z });
+		}
+		return out;
+	}
+
+	void Cube() {
+		std::vector<num::Vec<double>> corners;
+		for (size_t i = 0; i < 8; ++i)
+			corners.push_back(num::Vec<double>{ double(i & 1), double((i >> 1) & 1), double((i >> 2) & 1) });
+		num::Hull<double> hull;
+		hull.build(corners);
+
+		const num::Voxels<double> grid{ num::Vec<double>{ -0.5 }, 0.25, 9, 9, 9 };
+		std::vector<float> field(grid.size());
+		num::Sdf<double> sdf;
+		sdf.build(hull.faces(), grid, field, 2);
+
+		double error = 0;
+		for (size_t z = 0; z < grid.nz; ++z) {
+			for (size_t y = 0; y < grid.ny; ++y) {
+				for (size_t x = 0; x < grid.nx; ++x) {
+					const num::Vec<double> p = grid.point(x, y, z);
+					const double dx = std::max({ -p.x, p.x - 1, 0.0 }), dy = std::max({ -p.y, p.y - 1, 0.0 }), dz = std::max({ -p.z, p.z - 1, 0.0 });
+					const double outside = num::Sqrt(dx * dx + dy * dy + dz * dz);
+					const double inside = std::min({ p.x, 1 - p.x, p.y, 1 - p.y, p.z, 1 - p.z });
+					const double expected = (outside > 0 ? outside : -inside);
+					error = std::max(error, num::Abs(double(field[grid.index(x, y, z)]) - expected));
+				}
+			}
+		}
+		Check(error <= 1e-6, "cube: max error", error);
+	}
+
+	void Sphere() {
+		num::Hull<double> hull;
+		hull.build(SpherePoints(400));
+		const std::span<const num::Plane<double>> faces = hull.faces();
+
+		const num::Voxels<double> grid{ num::Vec<double>{ -1.5 }, 3.0 / 31, 32, 32, 32 };
+		std::vector<float> field(grid.size());
+		num::Sdf<double> sdf;
+		sdf.build(faces, grid, field, 4);
+
+		double error = 0;
+		size_t signs = 0;
+		for (size_t z = 0; z < grid.nz; ++z) {
+			for (size_t y = 0; y < grid.ny; ++y) {
+				for (size_t x = 0; x < grid.nx; ++x) {
+					const num::Vec<double> p = grid.point(x, y, z);
+					double best = std::numeric_limits<double>::infinity();
+					for (const num::Plane<double>& f : faces)
+						best = std::min(best, f.closestTriangle(p).len());
+					const float value = field[grid.index(x, y, z)];
+					error = std::max(error, num::Abs(num::Abs(double(value)) - best));
+					if (best > 1e-6 && (value < 0) != hull.contains(p, 1e-9))
+						++signs;
+				}
+			}
+		}
+		Check(error <= grid.cell / 10, "sphere: max error (cells)", error / grid.cell);
+		Check(signs == 0, "sphere: wrong signs", double(signs));
+
+		/* the field must not depend on the number of threads */
+		size_t differ = 0;
+		for (size_t threads : { 1, 2, 3, 8 }) {
+			std::vector<float> other(grid.size());
+			sdf.build(faces, grid, other, threads);
+			for (size_t i = 0; i < other.size(); ++i)
+				differ += (other[i] != field[i] ? 1 : 0);
+		}
+		Check(differ == 0, "sphere: samples differing across threads", double(differ));
+
+		/* the float field must follow the double field within the float precision of the coordinates */
+		std::vector<num::Plane<float>> facesf;
+		for (const num::Plane<double>& f : faces)
+			facesf.push_back(num::Convert<float>(f));
+		const num::Voxels<float> gridf{ num::Vec<float>{ -1.5f }, 3.0f / 31, 32, 32, 32 };
+		std::vector<float> fieldf(gridf.size());
+		num::Sdf<float> sdff;
+		sdff.build(facesf, gridf, fieldf, 2);
+		double drift = 0;
+		for (size_t i = 0; i < field.size(); ++i)
+			drift = std::max(drift, double(num::Abs(fieldf[i] - field[i])));
+		Check(drift <= grid.cell / 10, "sphere: float vs double (cells)", drift / grid.cell);
+	}
+}
+
+int main() {
+	Cube();
+	Sphere();
+	return (Failed > 0 ? 1 : 0);
+}
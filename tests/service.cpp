@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../vec.h"
+#include "../num-service.h"
+
+/*
+*	Benchmark of num::QueryService with a synthetic local load generator
+*	- every client thread keeps a window of outstanding queries (a mix of intersections, closest points, and triangle
+*		tests), and collects the oldest result before submitting the next query (closed loop)
+*	- every scenario reports the throughput and the latency percentiles of the service, next to the throughput of
+*		calling the operations directly on a single thread
+*	- every resolved result must be identical to the direct call, which fails the run otherwise (the timings are informative)
+*/
+
+namespace {
+	using Type = double;
+	constexpr size_t QueriesPerClient = 20000;
+
+	struct Scenario {
+		size_t clients = 0;
+		size_t window = 0;
+		size_t workers = 0;
+		size_t batch = 0;
+		std::chrono::microseconds deadline{ 0 };
+	};
+
+	/* query of the load generator, which is submitted as one of the three kinds */
+	struct Query {
+		num::Plane<Type> plane;
+		num::Line<Type> line;
+		num::Vec<Type> point;
+		size_t kind = 0;
+	};
+
+	Query Generate(std::mt19937_64& engine) {
+		const auto unit = [&]() { return Type(double(engine() >> 11) * 0x1.0p-53 * 10 - 5); };
+		const auto vec = [&]() { return num::Vec<Type>{ unit(), unit(), unit() }; };
+		Query q;
+		q.plane = num::Plane<Type>{ vec(), vec(), vec() };
+		q.line = num::Line<Type>{ vec(), vec() };
+		q.point = vec();
+		q.kind = size_t(engine() % 3);
+		return q;
+	}
+
+	/* outstanding query of a client with the future of its kind */
+	struct Outstanding {
+		Query query;
+		std::future<std::optional<num::Vec<Type>>> intersect;
+		std::future<num::Vec<Type>> closest;
+		std::future<bool> triangle;
+	};
+
+	/* resolve the outstanding query and check it against the direct call */
+	bool Resolve(Outstanding& o) {
+		const Query& q = o.query;
+		if (q.kind == 0) {
+			bool invalid = false;
+			const num::Vec<Type> expected = q.plane.intersect(q.line, &invalid);
+			const std::optional<num::Vec<Type>> result = o.intersect.get();
+			return (invalid ? !result.has_value() : (result.has_value() && *result == expected));
+		}
+		if (q.kind == 1)
+			return o.closest.get() == q.line.closest(q.point);
+		return o.triangle.get() == q.plane.inTriangle(q.point);
+	}
+
+	size_t Run(const Scenario& s) {
+		num::QueryService<Type> service{ s.workers, s.batch, s.deadline };
+		std::atomic<size_t> mismatches = 0;
+		std::vector<std::thread> clients;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t c = 0; c < s.clients; ++c) {
+			clients.emplace_back([&, c]() {
+				std::mt19937_64 engine{ 0x10ad + c };
+				std::deque<Outstanding> window;
+				size_t wrong = 0;
+				for (size_t i = 0; i < QueriesPerClient; ++i) {
+					Outstanding o;
+					o.query = Generate(engine);
+					if (o.query.kind == 0)
+						o.intersect = service.intersect(o.query.plane, o.query.line);
+					else if (o.query.kind == 1)
+						o.closest = service.closest(o.query.line, o.query.point);
+					else
+						o.triangle = service.inTriangle(o.query.plane, o.query.point);
+					window.push_back(std::move(o));
+
+					if (window.size() >= s.window) {
+						wrong += (Resolve(window.front()) ? 0 : 1);
+						window.pop_front();
+					}
+				}
+				for (Outstanding& o : window)
+					wrong += (Resolve(o) ? 0 : 1);
+				mismatches.fetch_add(wrong);
+			});
+		}
+		for (std::thread& client : clients)
+			client.join();
+		const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const num::QueryLatency l = service.latency();
+		std::printf("%7zu %6zu %7zu %5zu %8lld %10.0f %8llu %8.0f %8llu %8llu %8llu %8llu %8llu %s\n", s.clients, s.window, s.workers, s.batch,
+			(long long)s.deadline.count(), double(l.queries) / elapsed, (unsigned long long)l.batches, l.mean, (unsigned long long)l.p50,
+			(unsigned long long)l.p90, (unsigned long long)l.p99, (unsigned long long)l.p999, (unsigned long long)l.max, (mismatches == 0 ? "identical" : "differs"));
+		return mismatches.load();
+	}
+
+	/* throughput of calling the operations directly on a single thread (queries per second) */
+	volatile size_t Sink = 0;
+	double Direct() {
+		std::mt19937_64 engine{ 0x10ad };
+		std::vector<Query> queries;
+		for (size_t i = 0; i < QueriesPerClient; ++i)
+			queries.push_back(Generate(engine));
+
+		size_t sink = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (const Query& q : queries) {
+			bool invalid = false;
+			if (q.kind == 0)
+				sink += size_t(q.plane.intersect(q.line, &invalid).x > 0);
+			else if (q.kind == 1)
+				sink += size_t(q.line.closest(q.point).x > 0);
+			else
+				sink += size_t(q.plane.inTriangle(q.point));
+		}
+		const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		Sink = sink;
+		return double(queries.size()) / elapsed;
+	}
+}
+
+int main() {
+	std::printf("direct single-threaded: %.0f queries/s\n\n", Direct());
+	std::printf("%7s %6s %7s %5s %8s %10s %8s %8s %8s %8s %8s %8s %8s\n", "clients", "window", "workers", "batch", "deadline",
+		"queries/s", "batches", "mean-ns", "p50-ns", "p90-ns", "p99-ns", "p999-ns", "max-ns");
+
+	/* single synchronous client (deadline bound), few and many pipelining clients, and small against large batches */
+	const Scenario scenarios[] = {
+		{ 1, 1, 1, 256, std::chrono::microseconds{ 100 } },
+		{ 1, 1, 1, 1, std::chrono::microseconds{ 100 } },
+		{ 4, 64, 1, 256, std::chrono::microseconds{ 100 } },
+		{ 4, 64, 2, 64, std::chrono::microseconds{ 50 } },
+		{ 8, 256, 2, 256, std::chrono::microseconds{ 200 } },
+		{ 8, 256, 4, 1024, std::chrono::microseconds{ 500 } },
+	};
+	size_t mismatches = 0;
+	for (const Scenario& s : scenarios)
+		mismatches += Run(s);
+	return (mismatches > 0 ? 1 : 0);
+}
@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <random>
+
+#include "../vec.h"
+
+/*
+*	Check of num::Transform::inverse
+*	- uniformly small or large transformations must be invertible, as the singularity is detected relative to the
+*		lengths of the columns (e.g. scaling by 0.001, whose determinant is 1e-9)
+*	- rank-deficient transformations must be rejected and return the identity
+*	- random transformations composed with their inverses must yield the identity within the rounding
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	template <std::floating_point Type>
+	void Inverse(const char* name, Type tolerance) {
+		using Transform = num::Transform<Type>;
+		using Vec = num::Vec<Type>;
+		char what[64] = { 0 };
+
+		/* scales and mixed transformations of extreme magnitudes */
+		size_t rejected = 0;
+		double error = 0;
+		for (Type s : { Type(0.001), Type(1e-6), Type(1000), Type(1e6) }) {
+			const Transform transforms[] = { Transform::Scale(Vec{ s }), Transform::Scale(Vec{ s }) * Transform::RotateY(Type(30)) * Transform::Translate(Vec{ 1, 2, 3 }) };
+			for (const Transform& t : transforms) {
+				bool invalid = true;
+				const Transform inv = t.inverse(&invalid);
+				rejected += (invalid ? 1 : 0);
+				const Vec p = inv.point(t.point(Vec{ Type(0.5), Type(-2), Type(7) }));
+				error = std::max(error, double((p - Vec{ Type(0.5), Type(-2), Type(7) }).len()));
+			}
+		}
+		std::snprintf(what, sizeof(what), "%s: small or large scales rejected", name);
+		Check(rejected == 0, what, double(rejected));
+		std::snprintf(what, sizeof(what), "%s: max error of the scaled round-trips", name);
+		Check(error <= 8 * tolerance, what, error);
+
+		/* rank-deficient transformations */
+		const Transform singular[] = { Transform::Scale(Vec{ 1, 1, 0 }), Transform{ Vec{ 1, 2, 3 }, Vec{ -1, 0, 1 }, Vec{ 0, 2, 4 } },
+			Transform{ Vec{ Type(0.001), 0, 0 }, Vec{ 0, Type(0.001), 0 }, Vec{ Type(0.001), Type(0.001), 0 } } };
+		size_t accepted = 0;
+		for (const Transform& t : singular) {
+			bool invalid = false;
+			accepted += (t.inverse(&invalid) == Transform::Identity() && invalid ? 0 : 1);
+		}
+		std::snprintf(what, sizeof(what), "%s: singular transformations accepted", name);
+		Check(accepted == 0, what, double(accepted));
+
+		/* random transformations */
+		std::mt19937_64 engine{ 0x7f0 + sizeof(Type) };
+		const auto unit = [&]() { return Type(double(engine() >> 11) * 0x1.0p-53 * 2 - 1); };
+		error = 0;
+		size_t tested = 0;
+		for (size_t i = 0; i < 10000; ++i) {
+			const Transform t{ Vec{ unit(), unit(), unit() }, Vec{ unit(), unit(), unit() }, Vec{ unit(), unit(), unit() }, Vec{ unit(), unit(), unit() } };
+
+			/* skip ill-conditioned matrices, whose inverse amplifies the rounding */
+			if (num::Abs(t.determinant()) < Type(0.05) * t.x.len() * t.y.len() * t.z.len())
+				continue;
+			bool invalid = true;
+			const Transform id = t * t.inverse(&invalid);
+			error = std::max(error, double((id.x - Vec::AxisX()).len() + (id.y - Vec::AxisY()).len() + (id.z - Vec::AxisZ()).len() + id.t.len()));
+			tested += (invalid ? 0 : 1);
+		}
+		std::snprintf(what, sizeof(what), "%s: max error of random round-trips", name);
+		Check(tested > 5000 && error <= 200 * tolerance, what, error);
+	}
+}
+
+int main() {
+	Inverse<float>("float", std::numeric_limits<float>::epsilon());
+	Inverse<double>("double", std::numeric_limits<double>::epsilon());
+	return (Failed > 0 ? 1 : 0);
+}
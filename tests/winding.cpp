@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../vec.h"
+
+/*
+*	Check of num::Winding over the num::Hull of random points on a sphere
+*	- the exact winding number must be one inside and zero outside of the hull
+*	- the expansion must follow the exact winding number within a bound, which shrinks with [beta] (and vanishes
+*		if no node is far enough away to be expanded)
+*	- inside must match num::Hull::contains for points away from the surface
+*	- the bulk versions must be identical to the scalar versions for every number of threads
+*/
+
+namespace {
+	size_t Failed = 0;
+
+	void Check(bool ok, const char* what, double value) {
+		std::printf("%-44s %12.6g %s\n", what, value, (ok ? "ok" : "failed"));
+		Failed += (ok ? 0 : 1);
+	}
+
+	/* distance of the points to the surface of the hull, which is not considered (the winding number passes one half on it) */
+	constexpr double Margin = 0.01;
+}
+
+int main() {
+	std::mt19937_64 engine{ 0x3d1d };
+	const auto unit = [&]() { return double(engine() >> 11) * 0x1.0p-53 * 2 - 1; };
+
+	/* closed mesh with outward facing normals */
+	std::vector<num::Vec<double>> sphere;
+	while (sphere.size() < 2000) {
+		const num::Vec<double> v{ unit(), unit(), unit() };
+		const double len = v.len();
+		if (len > 0.1 && len < 1)
+			sphere.push_back(v / len);
+	}
+	num::Hull<double> hull;
+	hull.build(sphere);
+	num::Winding<double> winding;
+	winding.build(hull.faces());
+
+	/* query points around the hull with their signed distance to its surface */
+	std::vector<num::Vec<double>> points;
+	std::vector<double> distance;
+	while (points.size() < 4000) {
+		const num::Vec<double> p{ unit() * 2, unit() * 2, unit() * 2 };
+		double d = -std::numeric_limits<double>::infinity();
+		for (const num::Plane<double>& face : hull.faces())
+			d = std::max(d, (p - face.o).dot(face.normal().norm()));
+		if (num::Abs(d) < Margin)
+			continue;
+		points.push_back(p);
+		distance.push_back(d);
+	}
+
+	/* exact winding numbers and containment against the hull */
+	double exactError = 0;
+	size_t differ = 0;
+	for (size_t i = 0; i < points.size(); ++i) {
+		const bool contained = hull.contains(points[i]);
+		exactError = std::max(exactError, num::Abs(winding.exact(points[i]) - (distance[i] < 0 ? 1.0 : 0.0)));
+		differ += (winding.inside(points[i]) == contained && contained == (distance[i] < 0) ? 0 : 1);
+	}
+	Check(exactError <= 1e-9, "exact: max error against the hull", exactError);
+	Check(differ == 0, "inside: differing from Hull::contains", double(differ));
+
+	/* expansion against the exact sum for increasing [beta] */
+	const double bounds[] = { 5e-3, 1e-3, 2.5e-4, 0 };
+	const double betas[] = { 2, 3, 4, 1e9 };
+	for (size_t b = 0; b < 4; ++b) {
+		double error = 0;
+		for (const num::Vec<double>& p : points)
+			error = std::max(error, num::Abs(winding.number(p, betas[b]) - winding.exact(p)));
+		char what[64] = { 0 };
+		std::snprintf(what, sizeof(what), "number: max error for beta %g", betas[b]);
+		Check(error <= bounds[b] + 1e-12, what, error);
+	}
+
+	/* bulk against scalar */
+	size_t bulkDiffer = 0, counted = 0;
+	for (size_t threads : { 1, 4 }) {
+		std::vector<double> numbers(points.size());
+		std::vector<uint8_t> hits(points.size());
+		winding.numbers(points, numbers, threads);
+		counted += winding.inside(points, hits, threads);
+		for (size_t i = 0; i < points.size(); ++i)
+			bulkDiffer += (numbers[i] == winding.number(points[i]) && (hits[i] != 0) == winding.inside(points[i]) ? 0 : 1);
+	}
+	size_t expected = 0;
+	for (double d : distance)
+		expected += (d < 0 ? 2 : 0);
+	Check(bulkDiffer == 0 && counted == expected, "bulk: differing from scalar", double(bulkDiffer));
+	return (Failed > 0 ? 1 : 0);
+}
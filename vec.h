@@ -9,6 +9,32 @@
 #include "num-vec.h"
 #include "num-line.h"
 #include "num-plane.h"
+#include "num-box.h"
+#include "num-aligned.h"
+#include "num-interval.h"
+#include "num-fixed.h"
+#include "num-segment.h"
+#include "num-cached.h"
+#include "num-sphere.h"
+#include "num-capsule.h"
+#include "num-parallel.h"
+#include "num-dispatch.h"
+#include "num-arena.h"
+#include "num-reduce.h"
+#include "num-fit.h"
+#include "num-hull.h"
+#include "num-morton.h"
+#include "num-delaunay.h"
+#include "num-octree.h"
+#include "num-frustum.h"
+#include "num-transform.h"
+#include "num-icp.h"
+#include "num-projector.h"
+#include "num-stream.h"
+#include "num-sdf.h"
+#include "num-winding.h"
+#include "num-fast.h"
+#include "num-accuracy.h"
 
 namespace num {
 	using Constf = num::Const<float>;
@@ -25,6 +51,103 @@ namespace num {
 
 	using Planef = num::Plane<float>;
 	using Planed = num::Plane<double>;
+
+	using Boxf = num::Box<float>;
+	using Boxd = num::Box<double>;
+
+	using AlignedVecf = num::AlignedVec<float>;
+	using AlignedVecd = num::AlignedVec<double>;
+	using AlignedLinef = num::AlignedLine<float>;
+	using AlignedLined = num::AlignedLine<double>;
+	using AlignedPlanef = num::AlignedPlane<float>;
+	using AlignedPlaned = num::AlignedPlane<double>;
+
+	using Intervalf = num::Interval<float>;
+	using Intervald = num::Interval<double>;
+	using IntervalVecf = num::IntervalVec<float>;
+	using IntervalVecd = num::IntervalVec<double>;
+	using IntervalLinef = num::IntervalLine<float>;
+	using IntervalLined = num::IntervalLine<double>;
+	using IntervalPlanef = num::IntervalPlane<float>;
+	using IntervalPlaned = num::IntervalPlane<double>;
+
+	using FixedVec16 = num::FixedVec<num::Q16>;
+	using FixedVec32 = num::FixedVec<num::Q32>;
+	using FixedLine16 = num::FixedLine<num::Q16>;
+	using FixedLine32 = num::FixedLine<num::Q32>;
+	using FixedPlane16 = num::FixedPlane<num::Q16>;
+	using FixedPlane32 = num::FixedPlane<num::Q32>;
+
+	using Symmetricf = num::Symmetric<float>;
+	using Symmetricd = num::Symmetric<double>;
+	using Momentsf = num::Moments<float>;
+	using Momentsd = num::Moments<double>;
+
+	using BoxSetf = num::BoxSet<float>;
+	using BoxSetd = num::BoxSet<double>;
+	using SphereSetf = num::SphereSet<float>;
+	using SphereSetd = num::SphereSet<double>;
+	using Frustumf = num::Frustum<float>;
+	using Frustumd = num::Frustum<double>;
+
+	using Icpf = num::Icp<float>;
+	using Icpd = num::Icp<double>;
+	using IcpResultf = num::IcpResult<float>;
+	using IcpResultd = num::IcpResult<double>;
+
+	using Rayf = num::Ray<float>;
+	using Rayd = num::Ray<double>;
+
+	using Segmentf = num::Segment<float>;
+	using Segmentd = num::Segment<double>;
+
+	using Spheref = num::Sphere<float>;
+	using Sphered = num::Sphere<double>;
+
+	using Capsulef = num::Capsule<float>;
+	using Capsuled = num::Capsule<double>;
+
+	using CachedLinef = num::CachedLine<float>;
+	using CachedLined = num::CachedLine<double>;
+
+	using CachedPlanef = num::CachedPlane<float>;
+	using CachedPlaned = num::CachedPlane<double>;
+
+	using Hullf = num::Hull<float>;
+	using Hulld = num::Hull<double>;
+
+	using Delaunayf = num::Delaunay<float>;
+	using Delaunayd = num::Delaunay<double>;
+
+	using CurveKeyf = num::CurveKey<float>;
+	using CurveKeyd = num::CurveKey<double>;
+
+	using SpatialOrderf = num::SpatialOrder<float>;
+	using SpatialOrderd = num::SpatialOrder<double>;
+
+	using Octreef = num::Octree<float>;
+	using Octreed = num::Octree<double>;
+
+	using Transformf = num::Transform<float>;
+	using Transformd = num::Transform<double>;
+
+	using Projectorf = num::Projector<float>;
+	using Projectord = num::Projector<double>;
+
+	using Streamf = num::Stream<float>;
+	using Streamd = num::Stream<double>;
+
+	using Voxelsf = num::Voxels<float>;
+	using Voxelsd = num::Voxels<double>;
+
+	using Sdff = num::Sdf<float>;
+	using Sdfd = num::Sdf<double>;
+
+	using Windingf = num::Winding<float>;
+	using Windingd = num::Winding<double>;
+
+	using Driftf = num::Drift<float>;
+	using Driftd = num::Drift<double>;
 }
 
 template <std::floating_point Type>